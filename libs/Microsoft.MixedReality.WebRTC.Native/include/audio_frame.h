@@ -7,11 +7,33 @@
 
 namespace Microsoft::MixedReality::WebRTC {
 
+/// Encoding of the individual samples of an audio frame.
+enum class AudioSampleFormat : std::uint32_t {
+  /// Signed 16-bit integer samples, in [-32768:32767].
+  kInt16 = 0,
+
+  /// 32-bit floating-point samples, nominally in [-1:1].
+  kFloat32 = 1,
+};
+
+/// Arrangement in memory of the samples of the different channels of an audio
+/// frame.
+enum class AudioSampleLayout : std::uint32_t {
+  /// Samples of all channels are interleaved, one sample of each channel after
+  /// the other.
+  kInterleaved = 0,
+
+  /// Each channel is stored in its own contiguous plane of |sample_count_|
+  /// samples, and the planes are stored one after the other.
+  kPlanar = 1,
+};
+
 /// View over an existing buffer representing an audio frame, in the sense
 /// of a single group of contiguous audio data.
 struct AudioFrame {
-  /// Pointer to the raw contiguous memory block holding the audio data in
-  /// channel interleaved format. The length of the buffer is at least
+  /// Pointer to the raw contiguous memory block holding the audio data, in the
+  /// format and layout given by |sample_format_| and |sample_layout_|. The
+  /// length of the buffer is at least
   /// (|bits_per_sample_| / 8 * |channel_count_| * |sample_count_|) bytes.
   const void* data_;
 
@@ -27,6 +49,14 @@ struct AudioFrame {
   /// Number of consecutive samples. The frame duration is given by the ratio
   /// |sample_count_| / |sampling_rate_hz_|.
   std::uint32_t sample_count_;
+
+  /// Encoding of the samples. Frames produced by WebRTC are always 16-bit
+  /// integer, unless converted to another output format.
+  AudioSampleFormat sample_format_{AudioSampleFormat::kInt16};
+
+  /// Layout of the channels. Frames produced by WebRTC are always interleaved,
+  /// unless converted to another output format.
+  AudioSampleLayout sample_layout_{AudioSampleLayout::kInterleaved};
 };
 
 }  // namespace Microsoft::MixedReality::WebRTC
@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "interop_api.h"
+
+extern "C" {
+
+/// Configuration of an audio read buffer.
+struct mrsAudioReadBufferConfig {
+  /// Capacity of the buffer, in milliseconds of audio, in the range [10,10000].
+  int32_t capacity_ms = 200;
+
+  /// Fill with silence the part of a read request which cannot be satisfied
+  /// from the buffered samples.
+  mrsBool silence_fill = mrsBool::kTrue;
+
+  /// Expected number of channels, or zero if unknown. If set, frames with a
+  /// different channel count are discarded, and reads made before the first
+  /// frame is received are filled with silence like any other underrun.
+  uint32_t channel_count = 0;
+};
+
+/// Statistics of an audio read buffer. Sample counts are per channel.
+struct mrsAudioReadBufferStats {
+  /// Number of samples currently buffered and available for read.
+  uint64_t available_sample_count;
+
+  /// Number of samples written into, respectively read from, the buffer since
+  /// its creation.
+  uint64_t written_sample_count;
+  uint64_t read_sample_count;
+
+  /// Number of frames which did not entirely fit into the buffer because it
+  /// was not read fast enough, and number of samples dropped as a result.
+  uint64_t overrun_count;
+  uint64_t dropped_sample_count;
+
+  /// Number of reads which could not be entirely satisfied because not enough
+  /// samples were received, and number of samples missing as a result.
+  uint64_t underrun_count;
+  uint64_t missing_sample_count;
+
+  /// Number of frames discarded because their format did not match the format
+  /// of the buffer.
+  uint64_t format_mismatch_count;
+};
+
+/// Add a reference to the native object associated with the given handle.
+MRS_API void MRS_CALL
+mrsAudioReadBufferAddRef(AudioReadBufferHandle handle) noexcept;
+
+/// Remove a reference from the native object associated with the given handle.
+MRS_API void MRS_CALL
+mrsAudioReadBufferRemoveRef(AudioReadBufferHandle handle) noexcept;
+
+/// Create a buffer of 16-bit PCM audio samples, to be attached to an audio
+/// track with |mrsPeerConnectionSetRemoteAudioTrackReadBuffer()|. The track
+/// writes its frames into the buffer without ever waiting on the reader, and
+/// the caller reads them at its own cadence with |mrsAudioReadBufferRead()|,
+/// from a single thread. This returns a handle to a newly allocated object,
+/// which must be released once not used anymore with
+/// |mrsAudioReadBufferRemoveRef()|.
+MRS_API mrsResult MRS_CALL
+mrsAudioReadBufferCreate(const mrsAudioReadBufferConfig* config,
+                         AudioReadBufferHandle* handle_out) noexcept;
+
+/// Get the sampling rate and channel count of the samples of the buffer. This
+/// fails with |mrsResult::kInvalidOperation| until the first audio frame is
+/// received, which sets the format of the buffer.
+MRS_API mrsResult MRS_CALL
+mrsAudioReadBufferGetFormat(AudioReadBufferHandle handle,
+                            uint32_t* sampling_rate_hz,
+                            uint32_t* channel_count) noexcept;
+
+/// Read up to |sample_count| samples per channel into |data|, which must hold
+/// at least |sample_count| * channel count interleaved 16-bit samples. The
+/// number of samples per channel actually read is returned in
+/// |read_count_out|. If the buffer is configured to fill with silence, the
+/// rest of |data| is cleared. Before the first frame is received, the channel
+/// count is unknown, so |data| is only cleared if the expected channel count
+/// is configured. This must always be called from the same thread.
+MRS_API mrsResult MRS_CALL
+mrsAudioReadBufferRead(AudioReadBufferHandle handle,
+                       int16_t* data,
+                       uint32_t sample_count,
+                       uint32_t* read_count_out) noexcept;
+
+/// Get the number of samples per channel currently available for read.
+MRS_API mrsResult MRS_CALL
+mrsAudioReadBufferGetAvailableSampleCount(AudioReadBufferHandle handle,
+                                          uint32_t* sample_count) noexcept;
+
+/// Get the statistics of the buffer.
+MRS_API mrsResult MRS_CALL
+mrsAudioReadBufferGetStats(AudioReadBufferHandle handle,
+                           mrsAudioReadBufferStats* stats) noexcept;
+
+}  // extern "C"
@@ -0,0 +1,130 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "interop_api.h"
+
+extern "C" {
+
+//
+// Wrapper
+//
+
+/// Configuration of an external audio track source.
+struct mrsExternalAudioTrackSourceConfig {
+  /// Sampling rate of the audio produced by the source, in Hertz. This must be
+  /// a multiple of 100 Hz, in the range [8000:192000].
+  int32_t sampling_rate_hz = 48000;
+
+  /// Number of channels of the audio produced by the source, from 1 to 8.
+  int32_t channel_count = 1;
+
+  /// Amount of audio a push-mode source buffers before starting to play it
+  /// out, and again after running out of audio, in milliseconds. This absorbs
+  /// the jitter of the caller submitting audio on its own clock. This is
+  /// ignored by a source created from a callback.
+  int32_t jitter_buffer_ms = 40;
+
+  /// Maximum amount of audio a push-mode source buffers, in milliseconds. This
+  /// must be at least 10 ms more than |jitter_buffer_ms|. This is ignored by a
+  /// source created from a callback.
+  int32_t capacity_ms = 500;
+};
+
+/// Add a reference to the native object associated with the given handle.
+MRS_API void MRS_CALL mrsExternalAudioTrackSourceAddRef(
+    ExternalAudioTrackSourceHandle handle) noexcept;
+
+/// Remove a reference from the native object associated with the given handle.
+MRS_API void MRS_CALL mrsExternalAudioTrackSourceRemoveRef(
+    ExternalAudioTrackSourceHandle handle) noexcept;
+
+/// Create a custom audio track source external to the implementation. This
+/// allows feeding into WebRTC audio from any source, including synthesized
+/// audio, for example for testing. The audio is requested every 10 ms from a
+/// callback invoked on a capture scheduler thread, see
+/// |mrsSetExternalVideoTrackSourceThreadCount()|. This returns a handle to a
+/// newly allocated object, which must be released once not used anymore with
+/// |mrsExternalAudioTrackSourceRemoveRef()|.
+MRS_API mrsResult MRS_CALL mrsExternalAudioTrackSourceCreateFromCallback(
+    const mrsExternalAudioTrackSourceConfig* config,
+    mrsRequestExternalAudioFrameCallback callback,
+    void* user_data,
+    ExternalAudioTrackSourceHandle* source_handle_out) noexcept;
+
+/// Create a custom audio track source external to the implementation, in push
+/// mode. Instead of audio being requested from a callback, the caller submits
+/// audio with |mrsExternalAudioTrackSourceSubmitFrame()| whenever ready, in
+/// chunks of any size. The source buffers that audio in a jitter buffer, and
+/// plays it out in 10 ms frames on its own clock. This returns a handle to a
+/// newly allocated object, which must be released once not used anymore with
+/// |mrsExternalAudioTrackSourceRemoveRef()|.
+MRS_API mrsResult MRS_CALL mrsExternalAudioTrackSourceCreatePushMode(
+    const mrsExternalAudioTrackSourceConfig* config,
+    ExternalAudioTrackSourceHandle* source_handle_out) noexcept;
+
+/// Submit audio to a push-mode source. The frame must be made of 16-bit
+/// interleaved samples, at the sampling rate and with the channel count of the
+/// source, and can have any number of samples. If |timestamp_ms| is not
+/// negative, it is compared with the end of the previous frame submitted: a
+/// gap is filled with silence, and samples overlapping the previous frame are
+/// dropped. Pass a negative timestamp to append the frame as is.
+MRS_API mrsResult MRS_CALL mrsExternalAudioTrackSourceSubmitFrame(
+    ExternalAudioTrackSourceHandle handle,
+    const mrsAudioFrame* frame,
+    int64_t timestamp_ms) noexcept;
+
+/// Statistics of an external audio track source.
+struct mrsExternalAudioTrackSourceStats {
+  /// Number of 10 ms frames produced since the source started, and number of
+  /// frames skipped because the previous one was produced too late.
+  uint64_t frame_count;
+  uint64_t skipped_frame_count;
+
+  /// Average and maximum absolute difference between the time a frame was
+  /// produced and its scheduled deadline, in microseconds.
+  int64_t mean_jitter_us;
+  int64_t max_jitter_us;
+
+  /// Number of frames of silence produced because not enough audio was
+  /// buffered, or the callback did not provide any audio.
+  uint64_t silence_frame_count;
+
+  /// Number of times a push-mode source ran out of buffered audio while
+  /// playing, and started buffering again.
+  uint64_t underrun_count;
+
+  /// Number of samples per channel submitted and dropped because the buffer of
+  /// the source was full.
+  uint64_t overrun_sample_count;
+
+  /// Number of samples per channel currently buffered.
+  uint64_t buffered_sample_count;
+
+  /// Number of timestamp gaps between consecutive submitted frames, and number
+  /// of samples per channel of silence inserted to fill them.
+  uint64_t gap_count;
+  uint64_t inserted_sample_count;
+
+  /// Number of submitted frames overlapping the previous one, and number of
+  /// samples per channel dropped as a result.
+  uint64_t overlap_count;
+  uint64_t overlap_sample_count;
+
+  /// Number of samples per channel discarded because the caller submitted
+  /// audio faster than the source played it out.
+  uint64_t drift_sample_count;
+};
+
+/// Get the statistics of an external audio track source.
+MRS_API mrsResult MRS_CALL mrsExternalAudioTrackSourceGetStats(
+    ExternalAudioTrackSourceHandle handle,
+    mrsExternalAudioTrackSourceStats* stats) noexcept;
+
+/// Irreversibly stop the audio source frame production and shutdown the audio
+/// source.
+MRS_API void MRS_CALL mrsExternalAudioTrackSourceShutdown(
+    ExternalAudioTrackSourceHandle handle) noexcept;
+
+}  // extern "C"
@@ -41,6 +41,17 @@ MRS_API mrsResult MRS_CALL mrsExternalVideoTrackSourceCreateFromArgb32Callback(
     void* user_data,
     ExternalVideoTrackSourceHandle* source_handle_out) noexcept;
 
+/// Create a custom video track source external to the implementation, in push
+/// mode. Instead of frames being requested from a callback at a fixed interval,
+/// the caller submits frames with |mrsExternalVideoTrackSourceSubmitXxxFrame()|
+/// whenever they are ready, at its own frame rate. Frames are timestamped on
+/// submission and dispatched immediately, without going through any capture
+/// thread. This returns a handle to a newly allocated object, which must be
+/// released once not used anymore with
+/// |mrsExternalVideoTrackSourceRemoveRef()|.
+MRS_API mrsResult MRS_CALL mrsExternalVideoTrackSourceCreatePushMode(
+    ExternalVideoTrackSourceHandle* source_handle_out) noexcept;
+
 /// Complete a video frame request with a provided I420A video frame.
 MRS_API mrsResult MRS_CALL mrsExternalVideoTrackSourceCompleteI420AFrameRequest(
     ExternalVideoTrackSourceHandle handle,
@@ -56,6 +67,141 @@ mrsExternalVideoTrackSourceCompleteArgb32FrameRequest(
     int64_t timestamp_ms,
     const mrsArgb32VideoFrame* frame_view) noexcept;
 
+/// Complete a video frame request with a provided I420A video frame, without
+/// copying the frame. Instead, the memory of the frame planes is wrapped and
+/// read directly by the encoder and the local video callbacks, and must remain
+/// valid and unchanged until |release_callback| is invoked. The callback is
+/// always invoked exactly once, possibly from another thread and possibly
+/// before this function returns, including when the request fails, so the
+/// caller can unconditionally recycle the frame memory from that callback.
+MRS_API mrsResult MRS_CALL
+mrsExternalVideoTrackSourceCompleteI420AFrameRequestZeroCopy(
+    ExternalVideoTrackSourceHandle handle,
+    uint32_t request_id,
+    int64_t timestamp_ms,
+    const mrsI420AVideoFrame* frame_view,
+    mrsExternalVideoFrameReleasedCallback release_callback,
+    void* release_user_data) noexcept;
+
+/// Submit a new I420A video frame to a push-mode source.
+MRS_API mrsResult MRS_CALL mrsExternalVideoTrackSourceSubmitI420AFrame(
+    ExternalVideoTrackSourceHandle handle,
+    const mrsI420AVideoFrame* frame_view) noexcept;
+
+/// Submit a new I420A video frame to a push-mode source, without copying it.
+/// See |mrsExternalVideoTrackSourceCompleteI420AFrameRequestZeroCopy()| for
+/// the lifetime of the frame memory and the release callback.
+MRS_API mrsResult MRS_CALL mrsExternalVideoTrackSourceSubmitI420AFrameZeroCopy(
+    ExternalVideoTrackSourceHandle handle,
+    const mrsI420AVideoFrame* frame_view,
+    mrsExternalVideoFrameReleasedCallback release_callback,
+    void* release_user_data) noexcept;
+
+/// Submit a new ARGB32 video frame to a push-mode source.
+MRS_API mrsResult MRS_CALL mrsExternalVideoTrackSourceSubmitArgb32Frame(
+    ExternalVideoTrackSourceHandle handle,
+    const mrsArgb32VideoFrame* frame_view) noexcept;
+
+/// Conversion mode of ARGB32 frames with odd width or height, which cannot be
+/// exactly chroma-downsampled to I420.
+enum class mrsOddSizeMode : int32_t {
+  /// Drop the last column and/or row to get even dimensions.
+  kCrop = 0,
+
+  /// Keep the frame dimensions, and compute the chroma samples of the last
+  /// column and/or row from the edge pixels only.
+  kPad = 1,
+};
+
+/// Set how the ARGB32 frames provided to an external video track source are
+/// converted to I420 when their width or height is odd. The default is
+/// |mrsOddSizeMode::kCrop|.
+MRS_API mrsResult MRS_CALL mrsExternalVideoTrackSourceSetOddSizeMode(
+    ExternalVideoTrackSourceHandle handle,
+    mrsOddSizeMode mode) noexcept;
+
+/// Set the target frame rate at which frames are requested from a source
+/// created from a frame request callback, in frames per second. Fractional
+/// rates like 29.97 are supported. Requests are scheduled at fixed deadlines
+/// derived from the time the source started and the frame rate, so that late
+/// requests do not accumulate any drift; if a request is so late that the next
+/// deadline already passed, the corresponding requests are skipped. The
+/// default is 30 FPS.
+/// This fails with |mrsResult::kInvalidOperation| on a push-mode source.
+MRS_API mrsResult MRS_CALL mrsExternalVideoTrackSourceSetFramerate(
+    ExternalVideoTrackSourceHandle handle,
+    double framerate) noexcept;
+
+/// Statistics of an external video track source.
+struct mrsExternalVideoTrackSourceStats {
+  /// Target frame rate of the frame requests, in frames per second.
+  double framerate;
+
+  /// Number of frame requests issued since the source started.
+  uint64_t request_count;
+
+  /// Number of frame requests skipped because the previous request was issued
+  /// too late.
+  uint64_t skipped_request_count;
+
+  /// Average and maximum absolute difference between the time a frame request
+  /// was issued and its scheduled deadline, in microseconds.
+  int64_t mean_jitter_us;
+  int64_t max_jitter_us;
+
+  /// Signed difference between the time the most recent frame request was
+  /// issued and its scheduled deadline, in microseconds.
+  int64_t last_jitter_us;
+
+  /// Number of frame requests issued and not completed yet.
+  uint64_t outstanding_request_count;
+
+  /// Number of frame requests completed.
+  uint64_t completed_request_count;
+
+  /// Number of frame requests which were never completed, because a more
+  /// recent request was completed first, or too many were outstanding.
+  uint64_t expired_request_count;
+
+  /// Number of attempts to complete a request which was not outstanding
+  /// anymore, or never issued.
+  uint64_t rejected_request_count;
+
+  /// Width and height of the most recent frame produced by the source, in
+  /// pixels, or zero if none.
+  int32_t frame_width;
+  int32_t frame_height;
+
+  /// Number of frames stored into a frame buffer reused from a previous frame
+  /// of the same dimensions, without any allocation.
+  uint64_t buffer_reuse_count;
+
+  /// Number of frame buffers allocated, because none could be reused.
+  uint64_t buffer_allocation_count;
+
+  /// Number of times the frame dimensions changed, which discards the frame
+  /// buffers kept for reuse.
+  uint64_t reconfiguration_count;
+};
+
+/// Get the statistics of an external video track source.
+MRS_API mrsResult MRS_CALL mrsExternalVideoTrackSourceGetStats(
+    ExternalVideoTrackSourceHandle handle,
+    mrsExternalVideoTrackSourceStats* stats) noexcept;
+
+/// Set the number of threads executing the frame requests of all the external
+/// video track sources created from a frame request callback. The sources share
+/// those threads instead of each running its own, and a source is never
+/// executed on several threads at once. A source slow to produce frames only
+/// delays the other sources if all threads are busy. The default is 2 threads.
+/// This must not be called from a frame request callback.
+MRS_API mrsResult MRS_CALL
+mrsSetExternalVideoTrackSourceThreadCount(int32_t thread_count) noexcept;
+
+/// Get the number of threads executing the frame requests of the external video
+/// track sources.
+MRS_API int32_t MRS_CALL mrsGetExternalVideoTrackSourceThreadCount() noexcept;
+
 /// Irreversibly stop the video source frame production and shutdown the video
 /// source.
 MRS_API void MRS_CALL mrsExternalVideoTrackSourceShutdown(
@@ -108,9 +108,18 @@ using LocalVideoTrackHandle = void*;
 /// Opaque handle to a native DataChannel C++ object.
 using DataChannelHandle = void*;
 
+/// Opaque handle to a native DataSendBuffer C++ object.
+using DataSendBufferHandle = void*;
+
 /// Opaque handle to a native ExternalVideoTrackSource C++ object.
 using ExternalVideoTrackSourceHandle = void*;
 
+/// Opaque handle to a native AudioReadBuffer C++ object.
+using AudioReadBufferHandle = void*;
+
+/// Opaque handle to a native ExternalAudioTrackSource C++ object.
+using ExternalAudioTrackSourceHandle = void*;
+
 /// Callback fired when the peer connection is connected, that is it finished
 /// the JSEP offer/answer exchange successfully.
 using PeerConnectionConnectedCallback = void(MRS_CALL*)(void* user_data);
@@ -204,13 +213,66 @@ using mrsArgb32VideoFrame = Microsoft::MixedReality::WebRTC::Argb32VideoFrame;
 using PeerConnectionArgb32VideoFrameCallback =
     void(MRS_CALL*)(void* user_data, const mrsArgb32VideoFrame& frame);
 
+using mrsNv12VideoFrame = Microsoft::MixedReality::WebRTC::Nv12VideoFrame;
+
+/// Callback fired when a local or remote (depending on use) video frame is
+/// available to be consumed by the caller, usually for GPU upload or hardware
+/// encoding. The video frame is encoded in NV12 biplanar format.
+using PeerConnectionNv12VideoFrameCallback =
+    void(MRS_CALL*)(void* user_data, const mrsNv12VideoFrame& frame);
+
+using mrsRgba32VideoFrame = Microsoft::MixedReality::WebRTC::Rgba32VideoFrame;
+
+/// Callback fired when a local or remote (depending on use) video frame is
+/// available to be consumed by the caller, usually for display.
+/// The video frame is encoded in RGBA 32-bit per pixel.
+using PeerConnectionRgba32VideoFrameCallback =
+    void(MRS_CALL*)(void* user_data, const mrsRgba32VideoFrame& frame);
+
+using mrsBgra32VideoFrame = Microsoft::MixedReality::WebRTC::Bgra32VideoFrame;
+
+/// Callback fired when a local or remote (depending on use) video frame is
+/// available to be consumed by the caller, usually for display.
+/// The video frame is encoded in BGRA 32-bit per pixel.
+using PeerConnectionBgra32VideoFrameCallback =
+    void(MRS_CALL*)(void* user_data, const mrsBgra32VideoFrame& frame);
+
+/// Opaque handle to a native VideoFrameHandle C++ object, giving access to a
+/// video frame in several encodings converted on demand.
+using mrsVideoFrameHandle = Microsoft::MixedReality::WebRTC::VideoFrameHandle*;
+
+/// Callback fired when a local or remote (depending on use) video frame is
+/// available to be consumed by the caller. The frame handle is only valid
+/// during the callback, unless a reference is added to it with
+/// |mrsVideoFrameHandleAddRef()|. All the consumers of a same frame share the
+/// same handle, so each encoding is converted at most once per frame.
+using PeerConnectionVideoFrameHandleCallback =
+    void(MRS_CALL*)(void* user_data, mrsVideoFrameHandle frame);
+
+/// Callback fired when a video frame of a given remote video track is received,
+/// with the ID of that track. The frame handle follows the same rules as for
+/// |PeerConnectionVideoFrameHandleCallback|.
+using PeerConnectionRemoteVideoTrackFrameCallback =
+    void(MRS_CALL*)(void* user_data,
+                    const char* track_id,
+                    mrsVideoFrameHandle frame);
+
 using mrsAudioFrame = Microsoft::MixedReality::WebRTC::AudioFrame;
+using mrsAudioSampleFormat = Microsoft::MixedReality::WebRTC::AudioSampleFormat;
+using mrsAudioSampleLayout = Microsoft::MixedReality::WebRTC::AudioSampleLayout;
 
 /// Callback fired when a local or remote (depending on use) audio frame is
 /// available to be consumed by the caller, usually for local output.
 using PeerConnectionAudioFrameCallback =
     void(MRS_CALL*)(void* user_data, const mrsAudioFrame& frame);
 
+/// Callback fired when an audio frame of a given remote audio track is
+/// received, with the ID of that track.
+using PeerConnectionRemoteAudioTrackFrameCallback =
+    void(MRS_CALL*)(void* user_data,
+                    const char* track_id,
+                    const mrsAudioFrame& frame);
+
 /// Callback fired when a message is received on a data channel.
 using mrsDataChannelMessageCallback = void(MRS_CALL*)(void* user_data,
                                                       const void* data,
@@ -231,6 +293,21 @@ using mrsDataChannelStateCallback = void(MRS_CALL*)(void* user_data,
                                                     int32_t state,
                                                     int32_t id);
 
+/// Callback fired when the send queue of a data channel signals backpressure,
+/// with |backpressure| set to |mrsBool::kTrue|, or releases it, with
+/// |backpressure| set to |mrsBool::kFalse|.
+using mrsDataChannelBackpressureCallback =
+    void(MRS_CALL*)(void* user_data, mrsBool backpressure);
+
+/// Callback fired with a batch of |count| messages received on a data channel,
+/// whose addresses and sizes are in the |data| and |sizes| arrays. The messages
+/// are only valid during the call.
+using mrsDataChannelMessageBatchCallback =
+    void(MRS_CALL*)(void* user_data,
+                    const void* const* data,
+                    const uint64_t* sizes,
+                    uint32_t count);
+
 /// ICE transport type. See webrtc::PeerConnectionInterface::IceTransportsType.
 /// Currently values are aligned, but kept as a separate structure to allow
 /// backward compatilibity in case of changes in WebRTC.
@@ -374,6 +451,129 @@ MRS_API void MRS_CALL mrsPeerConnectionRegisterArgb32RemoteVideoFrameCallback(
     PeerConnectionArgb32VideoFrameCallback callback,
     void* user_data) noexcept;
 
+/// Register a callback fired when a video frame from a video track was received
+/// from the remote peer, converted to NV12.
+MRS_API void MRS_CALL mrsPeerConnectionRegisterNv12RemoteVideoFrameCallback(
+    PeerConnectionHandle peerHandle,
+    PeerConnectionNv12VideoFrameCallback callback,
+    void* user_data) noexcept;
+
+/// Register a callback fired when a video frame from a video track was received
+/// from the remote peer, converted to RGBA32. If |premultiplied_alpha| is
+/// |mrsBool::kTrue|, the color components are premultiplied by alpha.
+MRS_API void MRS_CALL mrsPeerConnectionRegisterRgba32RemoteVideoFrameCallback(
+    PeerConnectionHandle peerHandle,
+    mrsBool premultiplied_alpha,
+    PeerConnectionRgba32VideoFrameCallback callback,
+    void* user_data) noexcept;
+
+/// Register a callback fired when a video frame from a video track was received
+/// from the remote peer, converted to BGRA32. If |premultiplied_alpha| is
+/// |mrsBool::kTrue|, the color components are premultiplied by alpha. With
+/// straight alpha, this shares the conversion done for the ARGB32 callback.
+MRS_API void MRS_CALL mrsPeerConnectionRegisterBgra32RemoteVideoFrameCallback(
+    PeerConnectionHandle peerHandle,
+    mrsBool premultiplied_alpha,
+    PeerConnectionBgra32VideoFrameCallback callback,
+    void* user_data) noexcept;
+
+/// Register a callback fired when a video frame from a video track was received
+/// from the remote peer, with a handle to access the frame in any encoding.
+MRS_API void MRS_CALL mrsPeerConnectionRegisterRemoteVideoFrameHandleCallback(
+    PeerConnectionHandle peerHandle,
+    PeerConnectionVideoFrameHandleCallback callback,
+    void* user_data) noexcept;
+
+/// Policy applied when a remote video frame is received while the asynchronous
+/// delivery queue is full.
+enum class mrsVideoFrameDropPolicy : int32_t {
+  /// Discard the oldest queued frame to make room for the new one.
+  kDropOldest = 0,
+
+  /// Discard the new frame, and keep all the frames already queued.
+  kDropNewest = 1,
+
+  /// Keep only the latest frame, discarding any frame not delivered yet.
+  kKeepLatest = 2,
+};
+
+/// Configuration of the delivery of remote video frames to the callbacks.
+struct mrsVideoFrameDeliveryConfig {
+  /// Deliver frames asynchronously on a dedicated thread, through a bounded
+  /// queue, instead of synchronously on the decoder thread.
+  mrsBool async = mrsBool::kFalse;
+
+  /// Maximum number of frames in the asynchronous delivery queue.
+  int32_t queue_capacity = 4;
+
+  /// Policy applied when a frame is received while the queue is full.
+  mrsVideoFrameDropPolicy drop_policy = mrsVideoFrameDropPolicy::kDropOldest;
+};
+
+/// Statistics about the delivery of remote video frames to the callbacks.
+struct mrsVideoFrameDeliveryStats {
+  /// Number of frames delivered to the callbacks.
+  uint64_t delivered_count;
+
+  /// Number of frames discarded by the drop policy of the delivery queue.
+  uint64_t dropped_count;
+
+  /// Number of frames currently waiting in the delivery queue.
+  int32_t queue_size;
+
+  /// Percentiles of the time spent by the most recent frames in the delivery
+  /// queue, in microseconds.
+  int64_t latency_p50_us;
+  int64_t latency_p90_us;
+  int64_t latency_p99_us;
+};
+
+/// Configure the delivery of remote video frames to the callbacks registered
+/// with |mrsPeerConnectionRegisterI420ARemoteVideoFrameCallback()| and
+/// |mrsPeerConnectionRegisterArgb32RemoteVideoFrameCallback()|.
+/// Disabling the asynchronous delivery discards all the queued frames, and
+/// must not be done from inside a frame callback.
+MRS_API mrsResult MRS_CALL mrsPeerConnectionSetRemoteVideoFrameDeliveryConfig(
+    PeerConnectionHandle peerHandle,
+    const mrsVideoFrameDeliveryConfig* config) noexcept;
+
+/// Get the statistics about the delivery of remote video frames.
+MRS_API mrsResult MRS_CALL mrsPeerConnectionGetRemoteVideoFrameDeliveryStats(
+    PeerConnectionHandle peerHandle,
+    mrsVideoFrameDeliveryStats* stats) noexcept;
+
+/// Register a callback fired when a video frame of a single remote video track
+/// was received from the remote peer. The track is designated by |track_name|,
+/// either its track ID or the MID of its transceiver (Unified Plan only), and
+/// can be registered before the track is added. Unlike the callbacks above,
+/// which receive the frames of all remote video tracks, each remote track has
+/// its own delivery configuration and queue, so that the frames of different
+/// tracks are processed independently. Pass a null |callback| to unregister.
+MRS_API mrsResult MRS_CALL
+mrsPeerConnectionRegisterRemoteVideoTrackFrameCallback(
+    PeerConnectionHandle peerHandle,
+    const char* track_name,
+    PeerConnectionRemoteVideoTrackFrameCallback callback,
+    void* user_data) noexcept;
+
+/// Configure the delivery of the frames of a single remote video track to the
+/// callback registered with
+/// |mrsPeerConnectionRegisterRemoteVideoTrackFrameCallback()|.
+MRS_API mrsResult MRS_CALL
+mrsPeerConnectionSetRemoteVideoTrackFrameDeliveryConfig(
+    PeerConnectionHandle peerHandle,
+    const char* track_name,
+    const mrsVideoFrameDeliveryConfig* config) noexcept;
+
+/// Get the statistics about the delivery of the frames of a single remote
+/// video track. This fails with |mrsResult::kInvalidParameter| if no track with
+/// that name is currently added.
+MRS_API mrsResult MRS_CALL
+mrsPeerConnectionGetRemoteVideoTrackFrameDeliveryStats(
+    PeerConnectionHandle peerHandle,
+    const char* track_name,
+    mrsVideoFrameDeliveryStats* stats) noexcept;
+
 /// Kind of video profile. Equivalent to org::webRtc::VideoProfileKind.
 enum class VideoProfileKind : int32_t {
   kUnspecified,
@@ -391,11 +591,15 @@ enum class VideoProfileKind : int32_t {
 
 /// Register a callback fired when an audio frame is available from a local
 /// audio track, usually from a local audio capture device (local microphone).
+/// The callback is fired while the peer connection has a local audio track,
+/// with the captured audio after audio processing (echo cancellation, noise
+/// suppression, gain control). Frames are views over the internal buffer of
+/// the audio processing pipeline, in 16-bit planar samples if the capture has
+/// multiple channels, and are only valid during the callback.
 ///
 /// -- WARNING --
-/// Currently this callback is never fired, because the internal audio capture
-/// device implementation ignores any registration and only delivers its audio
-/// data to the internal WebRTC engine for sending to the remote peer.
+/// On UWP the callback is never fired, because the audio processing pipeline
+/// is created by the UWP SDK and cannot be tapped.
 MRS_API void MRS_CALL mrsPeerConnectionRegisterLocalAudioFrameCallback(
     PeerConnectionHandle peerHandle,
     PeerConnectionAudioFrameCallback callback,
@@ -408,6 +612,69 @@ MRS_API void MRS_CALL mrsPeerConnectionRegisterRemoteAudioFrameCallback(
     PeerConnectionAudioFrameCallback callback,
     void* user_data) noexcept;
 
+/// Register a callback fired when an audio frame of a single remote audio track
+/// was received from the remote peer. The track is designated by |track_name|,
+/// either its track ID or the MID of its transceiver (Unified Plan only), and
+/// can be registered before the track is added. Each remote track has its own
+/// observer, so the callback of a track is never blocked by the callbacks of
+/// the other tracks. Pass a null |callback| to unregister.
+MRS_API mrsResult MRS_CALL
+mrsPeerConnectionRegisterRemoteAudioTrackFrameCallback(
+    PeerConnectionHandle peerHandle,
+    const char* track_name,
+    PeerConnectionRemoteAudioTrackFrameCallback callback,
+    void* user_data) noexcept;
+
+/// Output format of the audio frames delivered to the callbacks. Frames are
+/// converted once natively, whatever the number of callbacks.
+struct mrsAudioOutputFormat {
+  /// Encoding of the samples.
+  mrsAudioSampleFormat sample_format = mrsAudioSampleFormat::kInt16;
+
+  /// Layout of the channels.
+  mrsAudioSampleLayout sample_layout = mrsAudioSampleLayout::kInterleaved;
+
+  /// Sampling rate in Hertz, multiple of 100 Hz in the range [8000,192000], or
+  /// zero to keep the rate of the received audio.
+  int32_t sampling_rate_hz = 0;
+
+  /// Number of channels, up to 8, or zero to keep the channel count of the
+  /// received audio. Multiple channels are averaged when converting to mono,
+  /// and mono is duplicated when converting to multiple channels.
+  int32_t channel_count = 0;
+};
+
+/// Convert the audio frames delivered to the callback registered with
+/// |mrsPeerConnectionRegisterRemoteAudioFrameCallback()| into the given format.
+/// Pass a null |format| to deliver the frames as received, in 16-bit
+/// interleaved samples.
+MRS_API mrsResult MRS_CALL mrsPeerConnectionSetRemoteAudioOutputFormat(
+    PeerConnectionHandle peerHandle,
+    const mrsAudioOutputFormat* format) noexcept;
+
+/// Convert the audio frames of a single remote audio track into the given
+/// format, before delivering them to the callback and read buffer of that
+/// track. The track is designated like for
+/// |mrsPeerConnectionRegisterRemoteAudioTrackFrameCallback()|. Pass a null
+/// |format| to deliver the frames as received.
+MRS_API mrsResult MRS_CALL mrsPeerConnectionSetRemoteAudioTrackOutputFormat(
+    PeerConnectionHandle peerHandle,
+    const char* track_name,
+    const mrsAudioOutputFormat* format) noexcept;
+
+/// Write the audio frames of a single remote audio track into the given read
+/// buffer, created with |mrsAudioReadBufferCreate()|, for the caller to read
+/// them at its own cadence instead of receiving them from a callback on the
+/// WebRTC audio thread. The track is designated like for
+/// |mrsPeerConnectionRegisterRemoteAudioTrackFrameCallback()|. This replaces
+/// the previous buffer of the track, if any; pass a null |buffer_handle| to
+/// detach it. The peer connection keeps a reference to the buffer while
+/// attached.
+MRS_API mrsResult MRS_CALL mrsPeerConnectionSetRemoteAudioTrackReadBuffer(
+    PeerConnectionHandle peerHandle,
+    const char* track_name,
+    AudioReadBufferHandle buffer_handle) noexcept;
+
 /// Configuration for opening a local video capture device.
 struct VideoDeviceConfiguration {
   /// Unique identifier of the video capture device to select, as returned by
@@ -481,6 +748,11 @@ using mrsRequestExternalArgb32VideoFrameCallback =
                          uint32_t request_id,
                          int64_t timestamp_ms);
 
+/// Callback invoked when a video frame submitted without copy to an external
+/// video track source is not used anymore, so that the caller can reuse or
+/// release the memory holding it.
+using mrsExternalVideoFrameReleasedCallback = void(MRS_CALL*)(void* user_data);
+
 /// Add a local video track from a custom video source external to the
 /// implementation. This allows feeding into WebRTC frames from any source,
 /// including generated or synthetic frames, for example for testing.
@@ -513,6 +785,37 @@ MRS_API mrsResult MRS_CALL mrsPeerConnectionRemoveLocalVideoTracksFromSource(
 MRS_API mrsResult MRS_CALL
 mrsPeerConnectionAddLocalAudioTrack(PeerConnectionHandle peerHandle) noexcept;
 
+/// Callback invoked every 10 ms by an external audio track source created from
+/// a callback, to request the next 10 ms of audio. The callback writes up to
+/// |sample_count| samples per channel into |data|, 16-bit interleaved, in the
+/// format of the source, and returns the number of samples per channel
+/// written. The rest of the buffer is filled with silence.
+using mrsRequestExternalAudioFrameCallback =
+    uint32_t(MRS_CALL*)(void* user_data,
+                        ExternalAudioTrackSourceHandle source_handle,
+                        int64_t timestamp_ms,
+                        int16_t* data,
+                        uint32_t sample_count);
+
+/// Add a local audio track from a custom audio source external to the
+/// implementation, instead of a local audio capture device. This allows
+/// feeding into WebRTC audio from any source, including synthesized audio or
+/// audio decoded from a file, even on a device without any audio hardware.
+/// The audio recorded from the audio capture device would otherwise be sent
+/// along with the audio of the source, so the recording is paused as long as
+/// an external audio track is added to any peer connection. The audio device
+/// is shared by all the peer connections of the process, so this also silences
+/// the local audio tracks of the other peer connections which use the capture
+/// device; the recording resumes once the last external audio track of the
+/// process is removed. The local audio frame callback receives the audio of
+/// the source. The track is removed with
+/// |mrsPeerConnectionRemoveLocalAudioTrack()|.
+MRS_API mrsResult MRS_CALL
+mrsPeerConnectionAddLocalAudioTrackFromExternalSource(
+    PeerConnectionHandle peer_handle,
+    const char* track_name,
+    ExternalAudioTrackSourceHandle source_handle) noexcept;
+
 enum class mrsDataChannelConfigFlags : uint32_t {
   kOrdered = 0x1,
   kReliable = 0x2,
@@ -578,11 +881,216 @@ mrsPeerConnectionSetLocalAudioTrackEnabled(PeerConnectionHandle peerHandle,
 MRS_API mrsBool MRS_CALL mrsPeerConnectionIsLocalAudioTrackEnabled(
     PeerConnectionHandle peerHandle) noexcept;
 
+/// Send a message through a data channel. The message is copied, so the
+/// caller can reuse |data| as soon as this returns.
 MRS_API mrsResult MRS_CALL
 mrsDataChannelSendMessage(DataChannelHandle dataChannelHandle,
                           const void* data,
                           uint64_t size) noexcept;
 
+/// Send a batch of |count| messages through a data channel, in order. The
+/// message |i| is made of |sizes[i]| bytes at |messages[i]|, and is copied.
+/// This crosses the interop boundary and dispatches to the WebRTC signaling
+/// thread only once for the entire batch, which makes it much cheaper than
+/// sending many small messages one by one. Messages are accepted in order until
+/// one is rejected, because the data channel is not open or its buffer is
+/// full, in which case that message and all subsequent ones are not sent. The
+/// number of messages accepted is returned in |sent_count_out|, and the
+/// function fails if it is less than |count|.
+MRS_API mrsResult MRS_CALL
+mrsDataChannelSendMessageBatch(DataChannelHandle dataChannelHandle,
+                               const void* const* messages,
+                               const uint64_t* sizes,
+                               uint32_t count,
+                               uint32_t* sent_count_out) noexcept;
+
+/// Configuration of the send queue of a data channel. The watermarks apply to
+/// the amount of data pending, that is buffered by WebRTC plus held in the
+/// send queue.
+struct mrsDataChannelSendQueueConfig {
+  /// Maximum amount of data held in the send queue, in bytes, in addition to
+  /// the data buffered by WebRTC.
+  uint64_t capacity_bytes = 64 * 1024 * 1024;
+
+  /// Amount of pending data, in bytes, at or above which backpressure is
+  /// signaled.
+  uint64_t high_watermark_bytes = 8 * 1024 * 1024;
+
+  /// Amount of pending data, in bytes, at or below which backpressure is
+  /// released. This must be less than |high_watermark_bytes|.
+  uint64_t low_watermark_bytes = 1024 * 1024;
+};
+
+/// Enable the send queue of a data channel, or change its configuration if
+/// already enabled. By default, sending a message fails if the WebRTC buffer
+/// of the data channel is full. Once the send queue is enabled, messages which
+/// do not fit in that buffer, or which are sent before the channel opens, are
+/// instead held in the send queue, and sent automatically in order as the
+/// buffer drains. Sending only fails once the send queue is full. The optional
+/// |callback| is invoked on the WebRTC signaling thread when the amount of data
+/// pending crosses the watermarks, to pause and resume the producer without
+/// polling. The callback can send messages.
+MRS_API mrsResult MRS_CALL
+mrsDataChannelEnableSendQueue(DataChannelHandle dataChannelHandle,
+                              const mrsDataChannelSendQueueConfig* config,
+                              mrsDataChannelBackpressureCallback callback,
+                              void* user_data) noexcept;
+
+/// Statistics of the send queue of a data channel.
+struct mrsDataChannelSendQueueStats {
+  /// Number of messages and bytes currently held in the send queue.
+  uint64_t queued_message_count;
+  uint64_t queued_bytes;
+
+  /// Number of messages rejected because the queue was full, the message was
+  /// too large to ever be sent, or the channel was closed.
+  uint64_t rejected_message_count;
+
+  /// Number of queued messages discarded because the channel closed before
+  /// they could be sent.
+  uint64_t discarded_message_count;
+
+  /// Backpressure is currently signaled.
+  mrsBool backpressure;
+};
+
+/// Get the statistics of the send queue of a data channel.
+MRS_API mrsResult MRS_CALL
+mrsDataChannelGetSendQueueStats(DataChannelHandle dataChannelHandle,
+                                mrsDataChannelSendQueueStats* stats) noexcept;
+
+/// Configuration of the framing mode of a data channel.
+struct mrsDataChannelFramingConfig {
+  /// Size in bytes of the chunks messages are split into, including the chunk
+  /// header, from 64 bytes to 64 KB.
+  uint32_t chunk_size = 16 * 1024;
+
+  /// Maximum size in bytes of a received message. Larger messages are dropped,
+  /// to bound the memory used for reassembly.
+  uint32_t max_message_size = 256 * 1024 * 1024;
+
+  /// Maximum total size in bytes of the messages being reassembled at once,
+  /// no less than |max_message_size|. Messages starting while the ones being
+  /// reassembled already use this much memory are dropped.
+  uint32_t max_reassembly_size = 512 * 1024 * 1024;
+};
+
+/// Enable the framing mode of an ordered and reliable data channel. This must
+/// be enabled on both ends of the channel before any message is sent. Messages
+/// are split into chunks, which lifts the size limit of the messages, and the
+/// chunks of the messages pending in the send queue are sent in turn, such
+/// that a small message is not delayed until a large message sent before it is
+/// fully sent. On receive, chunks are reassembled into a buffer of the message
+/// size before invoking the message callback, so messages are delivered in the
+/// order in which they complete, which is not necessarily the order in which
+/// they were sent. This enables the send queue with a default configuration,
+/// if not already enabled; see |mrsDataChannelEnableSendQueue()|.
+MRS_API mrsResult MRS_CALL
+mrsDataChannelEnableFraming(DataChannelHandle dataChannelHandle,
+                            const mrsDataChannelFramingConfig* config) noexcept;
+
+/// Mode of delivery of the messages received on a data channel.
+enum class mrsDataChannelReceiveMode : int32_t {
+  /// Invoke the message callback directly on the WebRTC thread receiving the
+  /// message. This is the default.
+  kDirect = 0,
+
+  /// Queue the messages, and invoke the message callback on a thread dedicated
+  /// to the data channel.
+  kDedicatedThread = 1,
+
+  /// Queue the messages, and invoke the message callback on the thread calling
+  /// |mrsDataChannelDispatchMessages()|.
+  kManual = 2,
+};
+
+/// Configuration of the delivery of the messages received on a data channel.
+struct mrsDataChannelReceiveConfig {
+  mrsDataChannelReceiveMode mode = mrsDataChannelReceiveMode::kDedicatedThread;
+
+  /// Maximum number of messages queued and not yet delivered, rounded up to
+  /// the next power of two, up to 1048576. Messages received while the queue
+  /// is full are dropped.
+  uint32_t queue_capacity = 1024;
+
+  /// Maximum number of messages delivered together to the batch callback, up
+  /// to 4096.
+  uint32_t max_batch_size = 64;
+};
+
+/// Queue the messages received on a data channel, instead of invoking the
+/// message callback on the WebRTC thread receiving them, so that a slow
+/// callback does not delay the WebRTC transport. This can be done only once,
+/// generally right after creating the data channel. The messages are delivered
+/// on a dedicated thread or on the thread calling
+/// |mrsDataChannelDispatchMessages()|, depending on |config->mode|. If
+/// |batch_callback| is not null, messages available together are delivered in
+/// batches through it, instead of one by one through the message callback.
+MRS_API mrsResult MRS_CALL mrsDataChannelSetReceiveConfig(
+    DataChannelHandle dataChannelHandle,
+    const mrsDataChannelReceiveConfig* config,
+    mrsDataChannelMessageBatchCallback batch_callback,
+    void* user_data) noexcept;
+
+/// Deliver up to |max_count| of the messages currently queued on a data channel
+/// in |mrsDataChannelReceiveMode::kManual| mode, on the calling thread, and
+/// return in |dispatched_count_out| the number of messages delivered. This must
+/// not be called from a message callback.
+MRS_API mrsResult MRS_CALL
+mrsDataChannelDispatchMessages(DataChannelHandle dataChannelHandle,
+                               uint32_t max_count,
+                               uint32_t* dispatched_count_out) noexcept;
+
+/// Statistics of the delivery of the messages received on a data channel.
+struct mrsDataChannelReceiveStats {
+  /// Number of messages delivered to the callbacks.
+  uint64_t delivered_message_count;
+
+  /// Number of messages dropped because the queue was full.
+  uint64_t dropped_message_count;
+
+  /// Number of messages currently queued, and maximum number of messages
+  /// queued at any time.
+  uint64_t queue_depth;
+  uint64_t max_queue_depth;
+
+  /// Percentiles of the time messages spent in the queue before being
+  /// delivered, in microseconds, over the most recent messages.
+  int64_t latency_p50_us;
+  int64_t latency_p90_us;
+  int64_t latency_p99_us;
+};
+
+/// Get the statistics of the delivery of the messages received on a data
+/// channel.
+MRS_API mrsResult MRS_CALL
+mrsDataChannelGetReceiveStats(DataChannelHandle dataChannelHandle,
+                              mrsDataChannelReceiveStats* stats) noexcept;
+
+/// Acquire a native buffer for a message of |size| bytes, and return in
+/// |data_out| the address of the message storage. The caller writes the message
+/// directly into that storage, then sends it with
+/// |mrsDataChannelSendBuffer()|, which avoids copying the message. Buffers of
+/// small messages are recycled, so that acquiring them does not allocate any
+/// memory in steady state. The buffer must be either sent or released with
+/// |mrsDataSendBufferRelease()|.
+MRS_API mrsResult MRS_CALL
+mrsDataSendBufferAcquire(uint64_t size,
+                         DataSendBufferHandle* buffer_handle_out,
+                         void** data_out) noexcept;
+
+/// Release a buffer acquired with |mrsDataSendBufferAcquire()| without sending
+/// it.
+MRS_API void MRS_CALL
+mrsDataSendBufferRelease(DataSendBufferHandle buffer_handle) noexcept;
+
+/// Send through a data channel the message written into a buffer acquired with
+/// |mrsDataSendBufferAcquire()|, without copying it. The buffer is released,
+/// whether or not the message was sent, and must not be used anymore.
+MRS_API mrsResult MRS_CALL
+mrsDataChannelSendBuffer(DataChannelHandle dataChannelHandle,
+                         DataSendBufferHandle buffer_handle) noexcept;
+
 /// Add a new ICE candidate received from a signaling service.
 MRS_API mrsResult MRS_CALL
 mrsPeerConnectionAddIceCandidate(PeerConnectionHandle peerHandle,
@@ -710,6 +1218,65 @@ MRS_API void MRS_CALL mrsMemCpyStride(void* dst,
                                       int32_t src_stride,
                                       int32_t elem_size,
                                       int32_t elem_count) noexcept;
+
+/// Set the minimum size of video frames, in pixels, from which color
+/// conversions are split into bands of rows converted in parallel on a small
+/// pool of worker threads. Smaller frames are converted on a single thread.
+/// The default is 1280 x 720 pixels. Use INT64_MAX to disable parallel
+/// conversion.
+MRS_API void MRS_CALL
+mrsSetParallelVideoConversionMinPixelCount(int64_t pixel_count) noexcept;
+
+/// Convert an I420 video frame, with optional alpha plane, to an ARGB32 buffer
+/// of at least (|argb32_stride| * |frame->height_|) bytes. This uses the same
+/// conversion engine as the ARGB32 video frame callbacks.
+MRS_API mrsResult MRS_CALL
+mrsConvertI420AVideoFrameToArgb32(const mrsI420AVideoFrame* frame,
+                                  void* argb32_data,
+                                  int32_t argb32_stride) noexcept;
+
+/// Convert an ARGB32 video frame to an I420 buffer, whose chroma planes have
+/// ((|frame->width_| + 1) / 2) columns and ((|frame->height_| + 1) / 2) rows.
+/// This uses the same conversion engine as the external video track sources.
+MRS_API mrsResult MRS_CALL
+mrsConvertArgb32VideoFrameToI420(const mrsArgb32VideoFrame* frame,
+                                 void* ydata,
+                                 int32_t ystride,
+                                 void* udata,
+                                 int32_t ustride,
+                                 void* vdata,
+                                 int32_t vstride) noexcept;
+
+/// Statistics of the global video frame buffer pool, used to recycle the
+/// memory of the video frames produced and converted by the library.
+struct mrsFrameBufferPoolStats {
+  /// Number of buffer requests served from recycled memory.
+  uint64_t hit_count;
+
+  /// Number of buffer requests which needed a new memory allocation.
+  uint64_t miss_count;
+
+  /// Number of buffers released and kept for reuse.
+  uint64_t recycle_count;
+
+  /// Number of buffers released and deallocated, because the pool was full.
+  uint64_t discard_count;
+
+  /// Number of buffers currently in use.
+  uint64_t outstanding_count;
+
+  /// Total size in bytes of the memory currently kept for reuse.
+  uint64_t cached_bytes;
+};
+
+/// Get a snapshot of the statistics of the global video frame buffer pool.
+MRS_API mrsResult MRS_CALL
+mrsFrameBufferPoolGetStats(mrsFrameBufferPoolStats* stats) noexcept;
+
+/// Deallocate all the memory kept for reuse by the global video frame buffer
+/// pool. Buffers currently in use are not affected.
+MRS_API void MRS_CALL mrsFrameBufferPoolTrim() noexcept;
+
 ///
 /// Stats extraction.
 ///
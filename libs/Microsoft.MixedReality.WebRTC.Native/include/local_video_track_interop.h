@@ -35,6 +35,40 @@ MRS_API void MRS_CALL mrsLocalVideoTrackRegisterArgb32FrameCallback(
     PeerConnectionArgb32VideoFrameCallback callback,
     void* user_data) noexcept;
 
+/// Register a custom callback to be called when the local video track captured
+/// a frame. The captured frames is passed to the registered callback in NV12
+/// encoding.
+MRS_API void MRS_CALL mrsLocalVideoTrackRegisterNv12FrameCallback(
+    LocalVideoTrackHandle trackHandle,
+    PeerConnectionNv12VideoFrameCallback callback,
+    void* user_data) noexcept;
+
+/// Register a custom callback to be called when the local video track captured
+/// a frame. The captured frames is passed to the registered callback in RGBA32
+/// encoding, with color components optionally premultiplied by alpha.
+MRS_API void MRS_CALL mrsLocalVideoTrackRegisterRgba32FrameCallback(
+    LocalVideoTrackHandle trackHandle,
+    mrsBool premultiplied_alpha,
+    PeerConnectionRgba32VideoFrameCallback callback,
+    void* user_data) noexcept;
+
+/// Register a custom callback to be called when the local video track captured
+/// a frame. The captured frames is passed to the registered callback in BGRA32
+/// encoding, with color components optionally premultiplied by alpha.
+MRS_API void MRS_CALL mrsLocalVideoTrackRegisterBgra32FrameCallback(
+    LocalVideoTrackHandle trackHandle,
+    mrsBool premultiplied_alpha,
+    PeerConnectionBgra32VideoFrameCallback callback,
+    void* user_data) noexcept;
+
+/// Register a custom callback to be called when the local video track captured
+/// a frame. The captured frame is passed to the registered callback as a handle
+/// converting the frame on demand into any supported encoding.
+MRS_API void MRS_CALL mrsLocalVideoTrackRegisterFrameHandleCallback(
+    LocalVideoTrackHandle trackHandle,
+    PeerConnectionVideoFrameHandleCallback callback,
+    void* user_data) noexcept;
+
 /// Enable or disable a local video track. Enabled tracks output their media
 /// content as usual. Disabled track output some void media content (black video
 /// frames, silent audio frames). Enabling/disabling a track is a lightweight
@@ -72,4 +72,75 @@ struct Argb32VideoFrame {
   std::int32_t stride_;
 };
 
+/// View over an existing buffer representing a video frame encoded in NV12
+/// format, that is a full-resolution Y plane followed by an interleaved UV
+/// plane subsampled by 2 in both directions.
+struct Nv12VideoFrame {
+  /// Width of the video frame, in pixels.
+  std::uint32_t width_;
+
+  /// Height of the video frame, in pixels.
+  std::uint32_t height_;
+
+  /// Pointer to the raw contiguous memory block holding the Y plane data.
+  /// The size of the buffer is at least (|ystride_| * |height_|) bytes.
+  const void* ydata_;
+
+  /// Pointer to the raw contiguous memory block holding the interleaved UV
+  /// plane data. The size of the buffer is at least
+  /// (|uvstride_| * (|height_| + 1) / 2) bytes.
+  const void* uvdata_;
+
+  /// Stride in bytes between two consecutive rows in the Y plane buffer.
+  /// This is always greater than or equal to |width_|.
+  std::int32_t ystride_;
+
+  /// Stride in bytes between two consecutive rows in the UV plane buffer.
+  /// This is always greater than or equal to (2 * ((|width_| + 1) / 2)).
+  std::int32_t uvstride_;
+};
+
+/// View over an existing buffer representing a video frame encoded in RGBA
+/// 32-bit-per-pixel format, in memory order (R first, A last). This matches
+/// for example DXGI_FORMAT_R8G8B8A8_UNORM and GL_RGBA textures.
+struct Rgba32VideoFrame {
+  /// Width of the video frame, in pixels.
+  std::uint32_t width_;
+
+  /// Height of the video frame, in pixels.
+  std::uint32_t height_;
+
+  /// Pointer to the raw contiguous memory block holding the video frame data.
+  /// The size of the buffer is at least (|stride_| * |height_|) bytes.
+  const void* rgba32_data_;
+
+  /// Stride in bytes between two consecutive rows in the RGBA buffer.
+  /// This is always greater than or equal to (4 * |width_|).
+  std::int32_t stride_;
+};
+
+/// View over an existing buffer representing a video frame encoded in BGRA
+/// 32-bit-per-pixel format, in memory order (B first, A last). This is the
+/// same memory layout as |Argb32VideoFrame|, and matches for example
+/// DXGI_FORMAT_B8G8R8A8_UNORM textures.
+struct Bgra32VideoFrame {
+  /// Width of the video frame, in pixels.
+  std::uint32_t width_;
+
+  /// Height of the video frame, in pixels.
+  std::uint32_t height_;
+
+  /// Pointer to the raw contiguous memory block holding the video frame data.
+  /// The size of the buffer is at least (|stride_| * |height_|) bytes.
+  const void* bgra32_data_;
+
+  /// Stride in bytes between two consecutive rows in the BGRA buffer.
+  /// This is always greater than or equal to (4 * |width_|).
+  std::int32_t stride_;
+};
+
+/// Reference-counted handle to a video frame, giving access to the frame
+/// content in several encodings converted on demand. See |VideoFrameHandle|.
+class VideoFrameHandle;
+
 }  // namespace Microsoft::MixedReality::WebRTC
@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "interop_api.h"
+
+extern "C" {
+
+/// Add a reference to the native video frame associated with the given handle,
+/// to keep it alive after the callback it was delivered to returns.
+MRS_API void MRS_CALL
+mrsVideoFrameHandleAddRef(mrsVideoFrameHandle handle) noexcept;
+
+/// Remove a reference from the native video frame associated with the given
+/// handle.
+MRS_API void MRS_CALL
+mrsVideoFrameHandleRemoveRef(mrsVideoFrameHandle handle) noexcept;
+
+/// Get a view of the video frame encoded in I420, with an alpha plane if the
+/// source frame has one. The view remains valid as long as the handle is.
+MRS_API mrsResult MRS_CALL
+mrsVideoFrameHandleGetI420A(mrsVideoFrameHandle handle,
+                            mrsI420AVideoFrame* frame) noexcept;
+
+/// Get a view of the video frame encoded in ARGB32, converting the frame on
+/// first access only. The view remains valid as long as the handle is.
+MRS_API mrsResult MRS_CALL
+mrsVideoFrameHandleGetArgb32(mrsVideoFrameHandle handle,
+                             mrsArgb32VideoFrame* frame) noexcept;
+
+/// Get a view of the video frame encoded in RGBA32, with color components
+/// premultiplied by alpha if |premultiplied_alpha| is |mrsBool::kTrue|. The
+/// frame is converted on first access only. The view remains valid as long as
+/// the handle is.
+MRS_API mrsResult MRS_CALL
+mrsVideoFrameHandleGetRgba32(mrsVideoFrameHandle handle,
+                             mrsBool premultiplied_alpha,
+                             mrsRgba32VideoFrame* frame) noexcept;
+
+/// Get a view of the video frame encoded in BGRA32, with color components
+/// premultiplied by alpha if |premultiplied_alpha| is |mrsBool::kTrue|. The
+/// frame is converted on first access only. The view remains valid as long as
+/// the handle is.
+MRS_API mrsResult MRS_CALL
+mrsVideoFrameHandleGetBgra32(mrsVideoFrameHandle handle,
+                             mrsBool premultiplied_alpha,
+                             mrsBgra32VideoFrame* frame) noexcept;
+
+/// Get a view of the video frame encoded in NV12, converting the frame on
+/// first access only. The view remains valid as long as the handle is.
+MRS_API mrsResult MRS_CALL
+mrsVideoFrameHandleGetNv12(mrsVideoFrameHandle handle,
+                           mrsNv12VideoFrame* frame) noexcept;
+
+}  // extern "C"
@@ -0,0 +1,234 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include <algorithm>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define MRS_AUDIO_SSE2
+#elif defined(_M_ARM) || defined(_M_ARM64) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define MRS_AUDIO_NEON
+#endif
+
+#include "audio_frame_converter.h"
+
+namespace {
+
+using namespace Microsoft::MixedReality::WebRTC;
+
+/// Scale from 16-bit integer samples to floating-point samples in [-1:1].
+constexpr float kInt16ToFloatScale = 1.0f / 32768.0f;
+
+/// Convert |count| 16-bit integer samples to floating-point samples.
+void ConvertInt16ToFloat(const int16_t* src, size_t count, float* dst) {
+  size_t i = 0;
+#if defined(MRS_AUDIO_SSE2)
+  const __m128 scale = _mm_set1_ps(kInt16ToFloatScale);
+  for (; i + 8 <= count; i += 8) {
+    const __m128i s16 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    // Sign-extend to 32 bits by placing each sample in the high half of a
+    // 32-bit lane, then shifting it back arithmetically.
+    const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(s16, s16), 16);
+    const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(s16, s16), 16);
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+    _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+  }
+#elif defined(MRS_AUDIO_NEON)
+  for (; i + 8 <= count; i += 8) {
+    const int16x8_t s16 = vld1q_s16(src + i);
+    const int32x4_t lo = vmovl_s16(vget_low_s16(s16));
+    const int32x4_t hi = vmovl_s16(vget_high_s16(s16));
+    vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(lo), kInt16ToFloatScale));
+    vst1q_f32(dst + i + 4,
+              vmulq_n_f32(vcvtq_f32_s32(hi), kInt16ToFloatScale));
+  }
+#endif
+  for (; i < count; ++i) {
+    dst[i] = src[i] * kInt16ToFloatScale;
+  }
+}
+
+/// Split |sample_count| interleaved samples of |channel_count| channels into
+/// consecutive planes.
+template <typename T>
+void Deinterleave(const T* src,
+                  size_t sample_count,
+                  size_t channel_count,
+                  T* dst) {
+  if (channel_count == 1) {
+    std::copy(src, src + sample_count, dst);
+    return;
+  }
+  for (size_t c = 0; c < channel_count; ++c) {
+    T* const plane = dst + c * sample_count;
+    const T* s = src + c;
+    for (size_t i = 0; i < sample_count; ++i, s += channel_count) {
+      plane[i] = *s;
+    }
+  }
+}
+
+/// Merge |channel_count| consecutive planes of |sample_count| samples into
+/// interleaved samples.
+void Interleave(const int16_t* src,
+                size_t sample_count,
+                size_t channel_count,
+                int16_t* dst) {
+  for (size_t c = 0; c < channel_count; ++c) {
+    const int16_t* const plane = src + c * sample_count;
+    int16_t* d = dst + c;
+    for (size_t i = 0; i < sample_count; ++i, d += channel_count) {
+      *d = plane[i];
+    }
+  }
+}
+
+/// Remix |sample_count| interleaved samples from |src_channel_count| to
+/// |dst_channel_count| channels; see |AudioOutputFormat::channel_count_|.
+void Remix(const int16_t* src,
+           size_t sample_count,
+           size_t src_channel_count,
+           size_t dst_channel_count,
+           int16_t* dst) {
+  if (dst_channel_count == 1) {
+    for (size_t i = 0; i < sample_count; ++i, src += src_channel_count) {
+      int32_t sum = 0;
+      for (size_t c = 0; c < src_channel_count; ++c) {
+        sum += src[c];
+      }
+      dst[i] = static_cast<int16_t>(sum /
+                                    static_cast<int32_t>(src_channel_count));
+    }
+  } else if (src_channel_count == 1) {
+    for (size_t i = 0; i < sample_count; ++i, dst += dst_channel_count) {
+      std::fill_n(dst, dst_channel_count, src[i]);
+    }
+  } else {
+    const size_t copy_count = std::min(src_channel_count, dst_channel_count);
+    for (size_t i = 0; i < sample_count; ++i) {
+      std::copy_n(src, copy_count, dst);
+      std::fill(dst + copy_count, dst + dst_channel_count, int16_t{0});
+      src += src_channel_count;
+      dst += dst_channel_count;
+    }
+  }
+}
+
+}  // namespace
+
+namespace Microsoft::MixedReality::WebRTC {
+
+Result AudioFrameConverter::ValidateFormat(
+    const AudioOutputFormat& format) noexcept {
+  if ((format.sample_format_ != AudioSampleFormat::kInt16) &&
+      (format.sample_format_ != AudioSampleFormat::kFloat32)) {
+    return Result::kInvalidParameter;
+  }
+  if ((format.sample_layout_ != AudioSampleLayout::kInterleaved) &&
+      (format.sample_layout_ != AudioSampleLayout::kPlanar)) {
+    return Result::kInvalidParameter;
+  }
+  if ((format.sampling_rate_hz_ != 0) &&
+      ((format.sampling_rate_hz_ < kMinSamplingRateHz) ||
+       (format.sampling_rate_hz_ > kMaxSamplingRateHz) ||
+       (format.sampling_rate_hz_ % 100 != 0))) {
+    return Result::kInvalidParameter;
+  }
+  if ((format.channel_count_ < 0) ||
+      (format.channel_count_ > kMaxChannelCount)) {
+    return Result::kInvalidParameter;
+  }
+  return Result::kSuccess;
+}
+
+bool AudioFrameConverter::Convert(const AudioFrame& frame,
+                                  AudioFrame& frame_out) noexcept {
+  if ((frame.bits_per_sample_ != 16) ||
+      (frame.sample_format_ != AudioSampleFormat::kInt16) ||
+      (frame.channel_count_ == 0) || (frame.sampling_rate_hz_ == 0)) {
+    return false;
+  }
+  const int16_t* data = static_cast<const int16_t*>(frame.data_);
+  size_t sample_count = frame.sample_count_;
+
+  // All steps operate on interleaved samples
+  if ((frame.sample_layout_ == AudioSampleLayout::kPlanar) &&
+      (frame.channel_count_ > 1)) {
+    interleaved_.resize(sample_count * frame.channel_count_);
+    Interleave(data, sample_count, frame.channel_count_, interleaved_.data());
+    data = interleaved_.data();
+  }
+  const size_t channel_count = (format_.channel_count_ > 0
+                                    ? format_.channel_count_
+                                    : frame.channel_count_);
+  const int sampling_rate_hz = (format_.sampling_rate_hz_ > 0
+                                    ? format_.sampling_rate_hz_
+                                    : frame.sampling_rate_hz_);
+
+  // Remix first, so that the resampler processes the fewest channels when
+  // downmixing. Upmixing after resampling would save some work, but would
+  // require one more intermediate buffer.
+  if (channel_count != frame.channel_count_) {
+    remixed_.resize(sample_count * channel_count);
+    Remix(data, sample_count, frame.channel_count_, channel_count,
+          remixed_.data());
+    data = remixed_.data();
+  }
+
+  // Resample; the resampler only supports 10 ms frames
+  if (sampling_rate_hz != static_cast<int>(frame.sampling_rate_hz_)) {
+    if (resampler_.InitializeIfNeeded(frame.sampling_rate_hz_,
+                                      sampling_rate_hz, channel_count) != 0) {
+      return false;
+    }
+    const size_t out_sample_count = sampling_rate_hz / 100;
+    resampled_.resize(out_sample_count * channel_count);
+    const int length =
+        resampler_.Resample(data, sample_count * channel_count,
+                            resampled_.data(), resampled_.size());
+    if (length != static_cast<int>(resampled_.size())) {
+      return false;
+    }
+    data = resampled_.data();
+    sample_count = out_sample_count;
+  }
+
+  // Convert the samples and their layout
+  const size_t total_count = sample_count * channel_count;
+  const void* out_data = data;
+  uint32_t bits_per_sample = 16;
+  if (format_.sample_format_ == AudioSampleFormat::kFloat32) {
+    bits_per_sample = 32;
+    float_out_.resize(total_count);
+    if ((format_.sample_layout_ == AudioSampleLayout::kPlanar) &&
+        (channel_count > 1)) {
+      float_interleaved_.resize(total_count);
+      ConvertInt16ToFloat(data, total_count, float_interleaved_.data());
+      Deinterleave(float_interleaved_.data(), sample_count, channel_count,
+                   float_out_.data());
+    } else {
+      ConvertInt16ToFloat(data, total_count, float_out_.data());
+    }
+    out_data = float_out_.data();
+  } else if ((format_.sample_layout_ == AudioSampleLayout::kPlanar) &&
+             (channel_count > 1)) {
+    int16_out_.resize(total_count);
+    Deinterleave(data, sample_count, channel_count, int16_out_.data());
+    out_data = int16_out_.data();
+  }
+
+  frame_out.data_ = out_data;
+  frame_out.bits_per_sample_ = bits_per_sample;
+  frame_out.sampling_rate_hz_ = static_cast<uint32_t>(sampling_rate_hz);
+  frame_out.channel_count_ = static_cast<uint32_t>(channel_count);
+  frame_out.sample_count_ = static_cast<uint32_t>(sample_count);
+  frame_out.sample_format_ = format_.sample_format_;
+  frame_out.sample_layout_ = format_.sample_layout_;
+  return true;
+}
+
+}  // namespace Microsoft::MixedReality::WebRTC
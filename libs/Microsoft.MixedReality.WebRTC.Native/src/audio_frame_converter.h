@@ -0,0 +1,83 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common_audio/resampler/include/push_resampler.h"
+
+#include "audio_frame.h"
+#include "mrs_errors.h"
+
+namespace Microsoft::MixedReality::WebRTC {
+
+/// Output format of the audio frames delivered by an |AudioFrameObserver|.
+struct AudioOutputFormat {
+  /// Encoding of the samples.
+  AudioSampleFormat sample_format_{AudioSampleFormat::kInt16};
+
+  /// Layout of the channels.
+  AudioSampleLayout sample_layout_{AudioSampleLayout::kInterleaved};
+
+  /// Sampling rate in Hertz, or zero to keep the rate of the source. This must
+  /// be a multiple of 100 Hz, since frames are 10 ms long.
+  int sampling_rate_hz_{0};
+
+  /// Number of channels, or zero to keep the channel count of the source.
+  /// Multiple channels are averaged when converting to mono, and mono is
+  /// duplicated when converting to multiple channels. Otherwise channels are
+  /// mapped one to one, dropping extra source channels and clearing extra
+  /// output channels.
+  int channel_count_{0};
+};
+
+/// Converter of the 16-bit audio frames produced by WebRTC into a given output
+/// format.
+///
+/// Planar frames are first interleaved. Frames are then converted in three
+/// steps, each skipped if not needed: channel remixing, resampling with the
+/// WebRTC sinc resampler, then sample format and layout conversion with SIMD
+/// code. The intermediate and output buffers are kept across frames, so that
+/// no allocation occurs once the first frame was converted.
+///
+/// This class is not thread-safe; a given instance converts the frames of a
+/// single audio thread.
+class AudioFrameConverter {
+ public:
+  static constexpr int kMinSamplingRateHz = 8000;
+  static constexpr int kMaxSamplingRateHz = 192000;
+  static constexpr int kMaxChannelCount = 8;
+
+  /// Check that an output format is supported.
+  static Result ValidateFormat(const AudioOutputFormat& format) noexcept;
+
+  explicit AudioFrameConverter(const AudioOutputFormat& format) noexcept
+      : format_(format) {}
+
+  const AudioOutputFormat& format() const noexcept { return format_; }
+
+  /// Convert |frame| into the output format. On success, |frame_out| points to
+  /// an internal buffer valid until the next conversion. Return |false| if the
+  /// frame cannot be converted, because it is not a 10 ms frame of 16-bit
+  /// samples.
+  bool Convert(const AudioFrame& frame, AudioFrame& frame_out) noexcept;
+
+ private:
+  const AudioOutputFormat format_;
+
+  /// Resampler, reinitialized when the source format changes.
+  webrtc::PushResampler<int16_t> resampler_;
+
+  /// Intermediate buffers for the interleaved, remixed and resampled frames,
+  /// and output buffers for the 16-bit and float samples.
+  std::vector<int16_t> interleaved_;
+  std::vector<int16_t> remixed_;
+  std::vector<int16_t> resampled_;
+  std::vector<int16_t> int16_out_;
+  std::vector<float> float_out_;
+  std::vector<float> float_interleaved_;
+};
+
+}  // namespace Microsoft::MixedReality::WebRTC
@@ -10,8 +10,32 @@ namespace Microsoft::MixedReality::WebRTC {
 
 void AudioFrameObserver::SetCallback(
     AudioFrameReadyCallback callback) noexcept {
-  auto lock = std::scoped_lock{mutex_};
-  callback_ = std::move(callback);
+  callback_.Set(std::move(callback));
+}
+
+void AudioFrameObserver::SetCallback(
+    TrackAudioFrameReadyCallback callback) noexcept {
+  track_callback_.Set(std::move(callback));
+}
+
+void AudioFrameObserver::SetReadBuffer(
+    RefPtr<AudioReadBuffer> buffer) noexcept {
+  read_buffer_.Set(ReadBufferWriter{std::move(buffer)});
+}
+
+Result AudioFrameObserver::SetOutputFormat(
+    const AudioOutputFormat& format) noexcept {
+  const Result result = AudioFrameConverter::ValidateFormat(format);
+  if (result != Result::kSuccess) {
+    return result;
+  }
+  converter_.Set(
+      ConverterInvoker{std::make_unique<AudioFrameConverter>(format)});
+  return Result::kSuccess;
+}
+
+void AudioFrameObserver::ClearOutputFormat() noexcept {
+  converter_.Set(ConverterInvoker{});
 }
 
 void AudioFrameObserver::OnData(const void* audio_data,
@@ -19,17 +43,36 @@ void AudioFrameObserver::OnData(const void* audio_data,
                                 int sample_rate,
                                 size_t number_of_channels,
                                 size_t number_of_frames) noexcept {
-  auto lock = std::scoped_lock{mutex_};
-  if (!callback_) {
-    return;
-  }
   AudioFrame frame;
   frame.data_ = audio_data;
   frame.bits_per_sample_ = static_cast<uint32_t>(bits_per_sample);
   frame.sampling_rate_hz_ = static_cast<uint32_t>(sample_rate);
   frame.channel_count_ = static_cast<uint32_t>(number_of_channels);
   frame.sample_count_ = static_cast<uint32_t>(number_of_frames);
+  OnFrame(frame);
+}
+
+void AudioFrameObserver::OnFrame(const AudioFrame& frame) noexcept {
+  if (!callback_.IsSet() && !track_callback_.IsSet() &&
+      !read_buffer_.IsSet()) {
+    return;
+  }
+
+  // Convert the frame once for all consumers. If no converter is set, the
+  // output frame is left empty and the frame is delivered as is.
+  AudioFrame converted_frame{};
+  bool dropped = false;
+  converter_(frame, converted_frame, dropped);
+  if (dropped) {
+    return;
+  }
+  Deliver(converted_frame.data_ ? converted_frame : frame);
+}
+
+void AudioFrameObserver::Deliver(const AudioFrame& frame) noexcept {
   callback_(frame);
+  track_callback_(source_id_.c_str(), frame);
+  read_buffer_(frame);
 }
 
 }  // namespace Microsoft::MixedReality::WebRTC
@@ -3,23 +3,68 @@
 
 #pragma once
 
-#include <mutex>
+#include <memory>
+#include <string>
 
 #include "api/mediastreaminterface.h"
 
-#include "callback.h"
 #include "audio_frame.h"
+#include "audio_frame_converter.h"
+#include "audio_read_buffer.h"
+#include "callback.h"
+#include "callback_slot.h"
 
 namespace Microsoft::MixedReality::WebRTC {
 
 /// Callback fired on newly available audio frame.
 using AudioFrameReadyCallback = Callback<const AudioFrame&>;
 
+/// Callback fired on newly available audio frame of a given remote audio track,
+/// with the ID of that track.
+using TrackAudioFrameReadyCallback = Callback<const char*, const AudioFrame&>;
+
 /// Audio frame observer to get notified of newly available audio frames.
+///
+/// Callbacks are invoked without taking any lock, so observers attached to
+/// different tracks never contend with each other. Changing a callback waits
+/// for the invocations of the previous one currently in progress.
 class AudioFrameObserver : public webrtc::AudioTrackSinkInterface {
  public:
+  AudioFrameObserver() noexcept = default;
+
+  /// Create an observer for the frames of a single source, like a remote audio
+  /// track, whose ID is passed to the |TrackAudioFrameReadyCallback|.
+  explicit AudioFrameObserver(std::string source_id) noexcept
+      : source_id_(std::move(source_id)) {}
+
+  /// ID of the source this observer is attached to, if any.
+  const std::string& source_id() const noexcept { return source_id_; }
+
   void SetCallback(AudioFrameReadyCallback callback) noexcept;
 
+  /// Register a callback receiving the ID of the source of this observer along
+  /// each frame.
+  void SetCallback(TrackAudioFrameReadyCallback callback) noexcept;
+
+  /// Write the frames into the given buffer, for the user to read them at its
+  /// own cadence, in addition to invoking the callbacks. This replaces the
+  /// previous buffer, if any; pass null to stop writing into any buffer.
+  void SetReadBuffer(RefPtr<AudioReadBuffer> buffer) noexcept;
+
+  /// Convert the frames into the given format before delivering them to the
+  /// callbacks and the read buffer. Frames which cannot be converted are
+  /// dropped. By default frames are delivered in the format produced by
+  /// WebRTC, 16-bit interleaved samples.
+  Result SetOutputFormat(const AudioOutputFormat& format) noexcept;
+
+  /// Deliver the frames in the format produced by WebRTC, without conversion.
+  void ClearOutputFormat() noexcept;
+
+  /// Deliver a frame produced by a source other than an audio track, like the
+  /// local audio capture tap. The frame is converted to the output format, if
+  /// any, like frames received through |OnData()|.
+  void OnFrame(const AudioFrame& frame) noexcept;
+
  protected:
   // AudioTrackSinkInterface interface
   void OnData(const void* audio_data,
@@ -29,8 +74,46 @@ class AudioFrameObserver : public webrtc::AudioTrackSinkInterface {
               size_t number_of_frames) noexcept override;
 
  private:
-  AudioFrameReadyCallback callback_ RTC_GUARDED_BY(mutex_);
-  std::mutex mutex_;
+  /// Adapter invoking |AudioReadBuffer::Write()| from a |CallbackSlot|.
+  struct ReadBufferWriter {
+    RefPtr<AudioReadBuffer> buffer_;
+    explicit operator bool() const noexcept {
+      return static_cast<bool>(buffer_);
+    }
+    void operator()(const AudioFrame& frame) const noexcept {
+      buffer_->Write(frame);
+    }
+  };
+
+  /// Adapter invoking |AudioFrameConverter::Convert()| from a |CallbackSlot|.
+  /// The converter is only used by the audio thread, one frame at a time.
+  struct ConverterInvoker {
+    std::unique_ptr<AudioFrameConverter> converter_;
+    explicit operator bool() const noexcept {
+      return static_cast<bool>(converter_);
+    }
+    void operator()(const AudioFrame& frame,
+                    AudioFrame& frame_out,
+                    bool& dropped) const noexcept {
+      dropped = !converter_->Convert(frame, frame_out);
+    }
+  };
+
+  /// Deliver a frame to the callbacks and the read buffer, without conversion.
+  void Deliver(const AudioFrame& frame) noexcept;
+
+  CallbackSlot<AudioFrameReadyCallback> callback_;
+  CallbackSlot<TrackAudioFrameReadyCallback> track_callback_;
+
+  /// Buffer written by the audio thread and read by the user. The slot ensures
+  /// there is a single producer, even while the buffer is being replaced.
+  CallbackSlot<ReadBufferWriter> read_buffer_;
+
+  /// Converter to the output format, if any.
+  CallbackSlot<ConverterInvoker> converter_;
+
+  /// ID of the source of the frames, if any.
+  const std::string source_id_;
 };
 
 }  // namespace Microsoft::MixedReality::WebRTC
@@ -0,0 +1,156 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "audio_read_buffer.h"
+
+namespace Microsoft::MixedReality::WebRTC {
+
+RefPtr<AudioReadBuffer> AudioReadBuffer::Create(
+    const AudioReadBufferConfig& config) noexcept {
+  if ((config.capacity_ms_ < kMinCapacityMs) ||
+      (config.capacity_ms_ > kMaxCapacityMs)) {
+    return {};
+  }
+  return new AudioReadBuffer(config);
+}
+
+AudioReadBuffer::AudioReadBuffer(const AudioReadBufferConfig& config) noexcept
+    : config_(config) {}
+
+void AudioReadBuffer::Write(const AudioFrame& frame) noexcept {
+  if ((frame.bits_per_sample_ != 16) ||
+      (frame.sample_format_ != AudioSampleFormat::kInt16) ||
+      (frame.sample_layout_ != AudioSampleLayout::kInterleaved) ||
+      (frame.channel_count_ == 0) || (frame.sampling_rate_hz_ == 0) ||
+      ((config_.channel_count_ != 0) &&
+       (frame.channel_count_ != config_.channel_count_))) {
+    format_mismatch_count_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  if (!ready_.load(std::memory_order_relaxed)) {
+    // First frame; only the producer writes the format, so no synchronization
+    // is needed until it is published.
+    sampling_rate_hz_ = frame.sampling_rate_hz_;
+    channel_count_ = frame.channel_count_;
+    capacity_ = std::max<uint32_t>(
+        static_cast<uint32_t>(static_cast<uint64_t>(sampling_rate_hz_) *
+                              config_.capacity_ms_ / 1000),
+        frame.sample_count_);
+    data_.reset(new int16_t[capacity_ * channel_count_]);
+    ready_.store(true, std::memory_order_release);
+  } else if ((frame.sampling_rate_hz_ != sampling_rate_hz_) ||
+             (frame.channel_count_ != channel_count_)) {
+    format_mismatch_count_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  // Keep the oldest samples on overrun, since the consumer cannot be forced to
+  // skip them without a lock.
+  const uint64_t write_pos = write_pos_.load(std::memory_order_relaxed);
+  const uint64_t read_pos = read_pos_.load(std::memory_order_acquire);
+  const uint32_t free_count =
+      capacity_ - static_cast<uint32_t>(write_pos - read_pos);
+  const uint32_t count = std::min(frame.sample_count_, free_count);
+  if (count < frame.sample_count_) {
+    overrun_count_.fetch_add(1, std::memory_order_relaxed);
+    dropped_sample_count_.fetch_add(frame.sample_count_ - count,
+                                    std::memory_order_relaxed);
+  }
+
+  // Copy in at most two parts, if wrapping around the end of the storage
+  const auto* const src = static_cast<const int16_t*>(frame.data_);
+  const uint32_t offset = static_cast<uint32_t>(write_pos % capacity_);
+  const uint32_t head_count = std::min(count, capacity_ - offset);
+  memcpy(data_.get() + offset * channel_count_, src,
+         head_count * channel_count_ * sizeof(int16_t));
+  memcpy(data_.get(), src + head_count * channel_count_,
+         (count - head_count) * channel_count_ * sizeof(int16_t));
+  write_pos_.store(write_pos + count, std::memory_order_release);
+}
+
+uint32_t AudioReadBuffer::Read(int16_t* data, uint32_t sample_count) noexcept {
+  if (!ready_.load(std::memory_order_acquire)) {
+    // Nothing received yet; this is an underrun of the entire request.
+    if (sample_count > 0) {
+      underrun_count_.fetch_add(1, std::memory_order_relaxed);
+      missing_sample_count_.fetch_add(sample_count, std::memory_order_relaxed);
+      if (config_.silence_fill_ && (config_.channel_count_ != 0)) {
+        memset(data, 0,
+               sample_count * config_.channel_count_ * sizeof(int16_t));
+      }
+    }
+    return 0;
+  }
+  const uint64_t read_pos = read_pos_.load(std::memory_order_relaxed);
+  const uint64_t write_pos = write_pos_.load(std::memory_order_acquire);
+  const uint32_t count =
+      std::min(sample_count, static_cast<uint32_t>(write_pos - read_pos));
+
+  const uint32_t offset = static_cast<uint32_t>(read_pos % capacity_);
+  const uint32_t head_count = std::min(count, capacity_ - offset);
+  memcpy(data, data_.get() + offset * channel_count_,
+         head_count * channel_count_ * sizeof(int16_t));
+  memcpy(data + head_count * channel_count_, data_.get(),
+         (count - head_count) * channel_count_ * sizeof(int16_t));
+  read_pos_.store(read_pos + count, std::memory_order_release);
+
+  if (count < sample_count) {
+    underrun_count_.fetch_add(1, std::memory_order_relaxed);
+    missing_sample_count_.fetch_add(sample_count - count,
+                                    std::memory_order_relaxed);
+    if (config_.silence_fill_) {
+      memset(data + count * channel_count_, 0,
+             (sample_count - count) * channel_count_ * sizeof(int16_t));
+    }
+  }
+  return count;
+}
+
+uint32_t AudioReadBuffer::Skip(uint32_t sample_count) noexcept {
+  const uint64_t read_pos = read_pos_.load(std::memory_order_relaxed);
+  const uint64_t write_pos = write_pos_.load(std::memory_order_acquire);
+  const uint32_t count =
+      std::min(sample_count, static_cast<uint32_t>(write_pos - read_pos));
+  read_pos_.store(read_pos + count, std::memory_order_release);
+  return count;
+}
+
+bool AudioReadBuffer::GetFormat(uint32_t& sampling_rate_hz,
+                                uint32_t& channel_count) const noexcept {
+  if (!ready_.load(std::memory_order_acquire)) {
+    return false;
+  }
+  sampling_rate_hz = sampling_rate_hz_;
+  channel_count = channel_count_;
+  return true;
+}
+
+uint32_t AudioReadBuffer::GetAvailableSampleCount() const noexcept {
+  const uint64_t read_pos = read_pos_.load(std::memory_order_acquire);
+  const uint64_t write_pos = write_pos_.load(std::memory_order_acquire);
+  return static_cast<uint32_t>(write_pos - read_pos);
+}
+
+AudioReadBufferStats AudioReadBuffer::GetStats() const noexcept {
+  AudioReadBufferStats stats;
+  stats.read_sample_count_ = read_pos_.load(std::memory_order_acquire);
+  stats.written_sample_count_ = write_pos_.load(std::memory_order_acquire);
+  stats.available_sample_count_ =
+      stats.written_sample_count_ - stats.read_sample_count_;
+  stats.overrun_count_ = overrun_count_.load(std::memory_order_relaxed);
+  stats.dropped_sample_count_ =
+      dropped_sample_count_.load(std::memory_order_relaxed);
+  stats.underrun_count_ = underrun_count_.load(std::memory_order_relaxed);
+  stats.missing_sample_count_ =
+      missing_sample_count_.load(std::memory_order_relaxed);
+  stats.format_mismatch_count_ =
+      format_mismatch_count_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+}  // namespace Microsoft::MixedReality::WebRTC
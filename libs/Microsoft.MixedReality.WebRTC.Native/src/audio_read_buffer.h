@@ -0,0 +1,145 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "audio_frame.h"
+#include "ref_counted_base.h"
+#include "refptr.h"
+
+namespace Microsoft::MixedReality::WebRTC {
+
+/// Configuration of an |AudioReadBuffer|.
+struct AudioReadBufferConfig {
+  /// Capacity of the buffer, in milliseconds of audio. This is the maximum
+  /// amount of jitter between the producer and the consumer the buffer can
+  /// absorb before dropping samples.
+  int capacity_ms_{200};
+
+  /// Fill with silence the part of a read request which cannot be satisfied
+  /// from the buffered samples, instead of leaving it untouched.
+  bool silence_fill_{true};
+
+  /// Expected number of channels, or zero if unknown. If set, frames with a
+  /// different channel count are discarded, and read requests made before the
+  /// first frame sets the format are filled with silence like any other
+  /// underrun, since the size of the request is known.
+  uint32_t channel_count_{0};
+};
+
+/// Statistics of an |AudioReadBuffer|.
+struct AudioReadBufferStats {
+  /// Number of samples per channel currently buffered and available for read.
+  uint64_t available_sample_count_{0};
+
+  /// Number of samples per channel written into, respectively read from, the
+  /// buffer since its creation.
+  uint64_t written_sample_count_{0};
+  uint64_t read_sample_count_{0};
+
+  /// Number of frames which did not entirely fit into the buffer because the
+  /// consumer did not read fast enough, and number of samples per channel
+  /// dropped as a result.
+  uint64_t overrun_count_{0};
+  uint64_t dropped_sample_count_{0};
+
+  /// Number of read requests which could not be entirely satisfied because
+  /// the producer did not write fast enough, and number of samples per channel
+  /// missing as a result.
+  uint64_t underrun_count_{0};
+  uint64_t missing_sample_count_{0};
+
+  /// Number of frames discarded because their format did not match the format
+  /// of the buffer.
+  uint64_t format_mismatch_count_{0};
+};
+
+/// Ring buffer of 16-bit PCM audio samples, written by an audio track and read
+/// by the user at its own cadence, like the audio thread of a game engine.
+///
+/// The buffer has a single producer, the WebRTC audio thread writing the audio
+/// frames of a track, and a single consumer, the user thread reading them. Both
+/// sides are lock-free and wait-free, so that the WebRTC audio thread never
+/// waits on the consumer. When the buffer is full, the newest samples which do
+/// not fit are dropped (overrun); when it is empty, read requests are partially
+/// satisfied and optionally completed with silence (underrun).
+///
+/// The buffer format is set by the first frame written; the storage is only
+/// allocated at that time, for the capacity of the configuration at the
+/// sampling rate of that frame. Frames in a different format are discarded,
+/// as well as frames not made of 16-bit interleaved samples. Setting an output
+/// format on the observer writing into the buffer guarantees a stable format.
+class AudioReadBuffer : public RefCountedBase {
+ public:
+  /// Minimum and maximum capacity of a buffer, in milliseconds.
+  static constexpr int kMinCapacityMs = 10;
+  static constexpr int kMaxCapacityMs = 10000;
+
+  /// Create a new buffer, or return null if the configuration is invalid.
+  static RefPtr<AudioReadBuffer> Create(
+      const AudioReadBufferConfig& config) noexcept;
+
+  /// Write an audio frame into the buffer. This must only be called by the
+  /// producer.
+  void Write(const AudioFrame& frame) noexcept;
+
+  /// Read up to |sample_count| samples per channel into |data|, which must be
+  /// large enough for |sample_count| samples of all channels, interleaved, as
+  /// given by |GetFormat()|. Return the number of samples per channel read from
+  /// the buffer. If the buffer is configured to fill with silence, the rest of
+  /// |data| is cleared. Nothing is read before the format is known, and |data|
+  /// is only cleared then if the expected channel count is configured. This
+  /// must only be called by the consumer.
+  uint32_t Read(int16_t* data, uint32_t sample_count) noexcept;
+
+  /// Discard up to |sample_count| samples per channel without reading them,
+  /// and return the number of samples per channel discarded. This must only be
+  /// called by the consumer.
+  uint32_t Skip(uint32_t sample_count) noexcept;
+
+  /// Get the format of the buffer, or return |false| if no frame was written
+  /// yet and the format is still unknown.
+  bool GetFormat(uint32_t& sampling_rate_hz,
+                 uint32_t& channel_count) const noexcept;
+
+  /// Get the number of samples per channel available for read. More samples
+  /// might become available by the time this returns.
+  uint32_t GetAvailableSampleCount() const noexcept;
+
+  /// Get a snapshot of the buffer statistics.
+  AudioReadBufferStats GetStats() const noexcept;
+
+ protected:
+  explicit AudioReadBuffer(const AudioReadBufferConfig& config) noexcept;
+
+ private:
+  const AudioReadBufferConfig config_;
+
+  /// Format and storage of the buffer, set by the producer on first write then
+  /// published to the consumer through |ready_|.
+  uint32_t sampling_rate_hz_{0};
+  uint32_t channel_count_{0};
+  uint32_t capacity_{0};
+  std::unique_ptr<int16_t[]> data_;
+  std::atomic_bool ready_{false};
+
+  /// Total number of samples per channel written, respectively read. Those
+  /// only increase, and their difference is the number of samples available.
+  /// Each is written by a single side, and kept on its own cache line to avoid
+  /// false sharing between the producer and the consumer.
+  alignas(64) std::atomic_uint64_t write_pos_{0};
+  alignas(64) std::atomic_uint64_t read_pos_{0};
+
+  /// Statistics, updated by the side detecting the event.
+  alignas(64) std::atomic_uint64_t overrun_count_{0};
+  std::atomic_uint64_t dropped_sample_count_{0};
+  std::atomic_uint64_t format_mismatch_count_{0};
+  alignas(64) std::atomic_uint64_t underrun_count_{0};
+  std::atomic_uint64_t missing_sample_count_{0};
+};
+
+}  // namespace Microsoft::MixedReality::WebRTC
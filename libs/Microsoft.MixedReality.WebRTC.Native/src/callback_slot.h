@@ -0,0 +1,136 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <utility>
+
+namespace Microsoft::MixedReality::WebRTC {
+
+/// Slot holding a callback registered by the user, which can be invoked from
+/// any thread without taking a lock, unless the callback is being replaced.
+///
+/// The callback is stored in an immutable heap object published through an
+/// atomic pointer. Invoking the callback pins the current generation of the
+/// slot by incrementing the counter of in-flight invocations of that
+/// generation. Replacing the callback swaps the pointer and starts a new
+/// generation, then blocks until the in-flight invocations of the previous
+/// generation returned before destroying the previous object. Invocations
+/// starting after the swap are counted in the new generation, so they never
+/// delay the replacement. This guarantees that once |Set()| returns, the
+/// previous callback is not invoked anymore, so its user data can be safely
+/// released.
+///
+/// Since |Set()| waits for in-flight invocations, it must not be called from
+/// inside the callback itself.
+///
+/// Usage:
+///   CallbackSlot<Callback<int>> slot;
+///   slot.Set({func_ptr, user_data});
+///   slot(42); // -> func_ptr(user_data, 42)
+template <typename T>
+class CallbackSlot {
+ public:
+  CallbackSlot() noexcept : current_(new T{}) {}
+  ~CallbackSlot() noexcept { delete current_.load(); }
+
+  CallbackSlot(const CallbackSlot&) = delete;
+  CallbackSlot& operator=(const CallbackSlot&) = delete;
+
+  /// Replace the current callback with a new one. This blocks until all the
+  /// invocations of the previous callback currently in progress on other
+  /// threads returned.
+  void Set(T callback) noexcept {
+    auto lock = std::scoped_lock{writer_mutex_};
+    T* const previous = current_.exchange(new T{std::move(callback)});
+    // Any invocation pinning the next generation uses the new callback. Wait
+    // for the ones which pinned the retired generation, and might use the
+    // previous callback.
+    const uint32_t generation = generation_.fetch_add(1);
+    const std::atomic_int& in_flight = in_flight_[generation & 1];
+    {
+      std::unique_lock<std::mutex> wait_lock(wait_mutex_);
+      released_cv_.wait(wait_lock,
+                        [&in_flight]() { return (in_flight.load() == 0); });
+    }
+    delete previous;
+  }
+
+  /// Check if a valid callback is currently registered. This is only a hint,
+  /// since the callback can be changed concurrently right after this returns.
+  bool IsSet() const noexcept {
+    Pin pin(*this);
+    return static_cast<bool>(*current_.load());
+  }
+
+  /// Invoke the current callback, if any, with the given arguments.
+  template <typename... Args>
+  void operator()(Args&&... args) const noexcept {
+    Pin pin(*this);
+    const T& callback = *current_.load();
+    if (callback) {
+      callback(std::forward<Args>(args)...);
+    }
+  }
+
+ private:
+  /// RAII helper pinning the current generation of the slot, and therefore the
+  /// callback published during that generation.
+  class Pin {
+   public:
+    explicit Pin(const CallbackSlot& slot) noexcept : slot_(slot) {
+      // Retry if a writer retired the generation before it was pinned, so
+      // that the writer does not wait for this invocation.
+      for (;;) {
+        generation_ = slot_.generation_.load();
+        slot_.in_flight_[generation_ & 1].fetch_add(1);
+        if (slot_.generation_.load() == generation_) {
+          break;
+        }
+        Release();
+      }
+    }
+    ~Pin() noexcept { Release(); }
+
+   private:
+    void Release() noexcept {
+      if ((slot_.in_flight_[generation_ & 1].fetch_sub(1) == 1) &&
+          (slot_.generation_.load() != generation_)) {
+        // Last invocation of a retired generation; wake up the writer.
+        auto lock = std::scoped_lock{slot_.wait_mutex_};
+        slot_.released_cv_.notify_all();
+      }
+    }
+
+    const CallbackSlot& slot_;
+    uint32_t generation_{0};
+  };
+
+  /// Currently published callback. Never null.
+  std::atomic<T*> current_;
+
+  /// Current generation, incremented each time the callback is replaced.
+  mutable std::atomic_uint32_t generation_{0};
+
+  /// Number of invocations currently in progress, for the current and the
+  /// previous generations, indexed by the generation parity. A counter is only
+  /// reused two generations later, once the writer which retired it observed
+  /// it reach zero. This uses sequentially consistent operations, so that a
+  /// writer swapping |current_| then starting a new generation observes any
+  /// reader which could have loaded the previous value of |current_|.
+  mutable std::atomic_int in_flight_[2]{};
+
+  /// Mutex and condition variable used by a writer to wait for the in-flight
+  /// invocations of a retired generation. Readers only acquire the mutex when
+  /// a writer might be waiting.
+  mutable std::mutex wait_mutex_;
+  mutable std::condition_variable released_cv_;
+
+  /// Mutex serializing writers.
+  std::mutex writer_mutex_;
+};
+
+}  // namespace Microsoft::MixedReality::WebRTC
@@ -4,9 +4,16 @@
 
 #include "pch.h"
 
+#include <algorithm>
+
 #include "data_channel.h"
+#include "data_send_buffer.h"
+#include "interop/global_factory.h"
 #include "peer_connection.h"
 
+#include "rtc_base/byteorder.h"
+#include "rtc_base/timeutils.h"
+
 namespace {
 
 using RtcDataState = webrtc::DataChannelInterface::DataState;
@@ -23,6 +30,38 @@ inline ApiDataState apiStateFromRtcState(RtcDataState rtcState) {
   return (ApiDataState)rtcState;
 }
 
+// Size of the header of a chunk in framing mode, made of the message
+// identifier, the message size, and the offset of the chunk in the message,
+// all 32-bit big-endian.
+constexpr size_t kChunkHeaderSize = 12;
+
+// Range of valid chunk sizes in framing mode, header included.
+constexpr uint32_t kMinChunkSize = 64;
+constexpr uint32_t kMaxChunkSize = 64 * 1024;
+
+// Maximum queue capacity and batch size in queued receive mode, in messages.
+constexpr uint32_t kMaxReceiveQueueCapacity = 1024 * 1024;
+constexpr uint32_t kMaxReceiveBatchSize = 4096;
+
+// Maximum amount of data buffered by WebRTC in framing mode, in bytes. Chunks
+// are kept in the send queue beyond that, such that the chunks of a message
+// sent later can be interleaved with the ones already queued.
+constexpr uint64_t kMaxFramingBufferedBytes = 256 * 1024;
+
+/// Run |functor| on the WebRTC signaling thread, synchronously, and return its
+/// result. This runs it directly if already on that thread.
+template <typename FunctorT>
+auto InvokeOnSignalingThread(const FunctorT& functor) -> decltype(functor()) {
+  rtc::Thread* const signaling_thread =
+      Microsoft::MixedReality::WebRTC::GlobalFactory::Instance()
+          ->GetSignalingThread();
+  if (!signaling_thread || signaling_thread->IsCurrent()) {
+    return functor();
+  }
+  return signaling_thread->Invoke<decltype(functor())>(RTC_FROM_HERE,
+                                                       functor);
+}
+
 }  // namespace
 
 namespace Microsoft::MixedReality::WebRTC {
@@ -40,6 +79,13 @@ DataChannel::DataChannel(
 
 DataChannel::~DataChannel() {
   data_channel_->UnregisterObserver();
+  // No message can be queued anymore; stop the receive thread, dropping the
+  // messages not delivered yet.
+  if (receive_thread_.joinable()) {
+    stop_receive_thread_.store(true, std::memory_order_release);
+    receive_event_.Set();
+    receive_thread_.join();
+  }
   if (owner_) {
     owner_->RemoveDataChannel(*this);
   }
@@ -51,8 +97,7 @@ str DataChannel::label() const {
 }
 
 void DataChannel::SetMessageCallback(MessageCallback callback) noexcept {
-  auto lock = std::scoped_lock{mutex_};
-  message_callback_ = callback;
+  message_callback_.Set(callback);
 }
 
 void DataChannel::SetBufferingCallback(BufferingCallback callback) noexcept {
@@ -73,6 +118,9 @@ size_t DataChannel::GetMaxBufferingSize() const noexcept {
 }
 
 bool DataChannel::Send(const void* data, size_t size) noexcept {
+  if (send_queue_enabled_.load(std::memory_order_acquire)) {
+    return Send(rtc::CopyOnWriteBuffer((const char*)data, size));
+  }
   if (data_channel_->buffered_amount() + size > GetMaxBufferingSize()) {
     return false;
   }
@@ -81,6 +129,499 @@ bool DataChannel::Send(const void* data, size_t size) noexcept {
   return data_channel_->Send(buffer);
 }
 
+bool DataChannel::Send(rtc::CopyOnWriteBuffer buffer) noexcept {
+  if (send_queue_enabled_.load(std::memory_order_acquire)) {
+    return InvokeOnSignalingThread(
+        [this, &buffer]() { return SendOrEnqueue(std::move(buffer)); });
+  }
+  if (data_channel_->buffered_amount() + buffer.size() >
+      GetMaxBufferingSize()) {
+    return false;
+  }
+  // This only adds a reference to the buffer storage.
+  webrtc::DataBuffer data_buffer(std::move(buffer), /* binary = */ true);
+  return data_channel_->Send(data_buffer);
+}
+
+size_t DataChannel::SendBatch(const void* const* messages,
+                              const uint64_t* sizes,
+                              size_t count) noexcept {
+  if (count == 0) {
+    return 0;
+  }
+  // The data channel is a proxy, which marshals each call to the signaling
+  // thread unless already on it, so run the entire batch there.
+  auto send_batch = [&]() -> size_t {
+    if (send_queue_enabled_.load(std::memory_order_acquire)) {
+      for (size_t i = 0; i < count; ++i) {
+        rtc::CopyOnWriteBuffer storage(static_cast<const char*>(messages[i]),
+                                       static_cast<size_t>(sizes[i]));
+        if (!SendOrEnqueue(std::move(storage))) {
+          return i;
+        }
+      }
+      return count;
+    }
+    const uint64_t max_buffering = GetMaxBufferingSize();
+    uint64_t buffered = data_channel_->buffered_amount();
+    for (size_t i = 0; i < count; ++i) {
+      // Messages sent synchronously do not add to the buffered amount, so this
+      // is conservative and can reject a message which would have fit.
+      buffered += sizes[i];
+      if (buffered > max_buffering) {
+        return i;
+      }
+      rtc::CopyOnWriteBuffer storage(static_cast<const char*>(messages[i]),
+                                     static_cast<size_t>(sizes[i]));
+      webrtc::DataBuffer buffer(storage, /* binary = */ true);
+      if (!data_channel_->Send(buffer)) {
+        return i;
+      }
+    }
+    return count;
+  };
+  return InvokeOnSignalingThread(send_batch);
+}
+
+Result DataChannel::EnableSendQueue(const DataChannelSendQueueConfig& config,
+                                    BackpressureCallback callback) noexcept {
+  if ((config.capacity_bytes_ == 0) ||
+      (config.low_watermark_bytes_ >= config.high_watermark_bytes_)) {
+    return Result::kInvalidParameter;
+  }
+  {
+    auto lock = std::scoped_lock{mutex_};
+    backpressure_callback_ = callback;
+  }
+  InvokeOnSignalingThread([this, &config]() {
+    send_queue_config_ = config;
+    send_queue_enabled_.store(true, std::memory_order_release);
+    UpdateBackpressure();
+  });
+  return Result::kSuccess;
+}
+
+DataChannelSendQueueStats DataChannel::GetSendQueueStats() const noexcept {
+  DataChannelSendQueueStats stats;
+  stats.queued_message_count =
+      queued_message_count_.load(std::memory_order_relaxed);
+  stats.queued_bytes = queued_bytes_.load(std::memory_order_relaxed);
+  stats.rejected_message_count =
+      rejected_message_count_.load(std::memory_order_relaxed);
+  stats.discarded_message_count =
+      discarded_message_count_.load(std::memory_order_relaxed);
+  stats.backpressure = backpressure_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+bool DataChannel::SendOrEnqueue(rtc::CopyOnWriteBuffer buffer) noexcept {
+  RTC_DCHECK(send_queue_config_);
+  const size_t size = buffer.size();
+  const webrtc::DataChannelInterface::DataState state = data_channel_->state();
+  // A message larger than the WebRTC buffer can never be sent, and would block
+  // the queue forever, unless split into chunks.
+  const size_t max_size =
+      (framing_config_ ? UINT32_MAX : GetMaxBufferingSize());
+  bool accepted = false;
+  if ((size <= max_size) &&
+      ((state == webrtc::DataChannelInterface::DataState::kConnecting) ||
+       (state == webrtc::DataChannelInterface::DataState::kOpen))) {
+    if (!framing_config_ && send_queue_.empty() &&
+        (state == webrtc::DataChannelInterface::DataState::kOpen) &&
+        (data_channel_->buffered_amount() + size <= GetMaxBufferingSize())) {
+      webrtc::DataBuffer data_buffer(buffer, /* binary = */ true);
+      accepted = data_channel_->Send(data_buffer);
+    } else if (queued_bytes_.load(std::memory_order_relaxed) + size <=
+               send_queue_config_->capacity_bytes_) {
+      QueuedMessage message;
+      message.data_ = std::move(buffer);
+      message.id_ = next_message_id_++;
+      send_queue_.push_back(std::move(message));
+      queued_message_count_.fetch_add(1, std::memory_order_relaxed);
+      queued_bytes_.fetch_add(size, std::memory_order_relaxed);
+      accepted = true;
+    }
+  }
+  if (!accepted) {
+    rejected_message_count_.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (accepted && framing_config_) {
+    // Messages are always queued in framing mode
+    DrainSendQueue();
+  } else {
+    UpdateBackpressure();
+  }
+  return accepted;
+}
+
+void DataChannel::DrainSendQueue() noexcept {
+  if (draining_) {
+    return;
+  }
+  draining_ = true;
+  const webrtc::DataChannelInterface::DataState state = data_channel_->state();
+  if (framing_config_ &&
+      (state == webrtc::DataChannelInterface::DataState::kOpen)) {
+    while (!send_queue_.empty() &&
+           (data_channel_->buffered_amount() < kMaxFramingBufferedBytes)) {
+      if (!SendNextChunk()) {
+        break;
+      }
+    }
+  } else if (state == webrtc::DataChannelInterface::DataState::kOpen) {
+    while (!send_queue_.empty()) {
+      const size_t size = send_queue_.front().data_.size();
+      if (data_channel_->buffered_amount() + size > GetMaxBufferingSize()) {
+        break;
+      }
+      webrtc::DataBuffer data_buffer(send_queue_.front().data_,
+                                     /* binary = */ true);
+      if (!data_channel_->Send(data_buffer)) {
+        break;
+      }
+      send_queue_.pop_front();
+      queued_message_count_.fetch_sub(1, std::memory_order_relaxed);
+      queued_bytes_.fetch_sub(size, std::memory_order_relaxed);
+    }
+  }
+  draining_ = false;
+  UpdateBackpressure();
+}
+
+Result DataChannel::EnableFraming(
+    const DataChannelFramingConfig& config) noexcept {
+  if ((config.chunk_size_ < kMinChunkSize) ||
+      (config.chunk_size_ > kMaxChunkSize) || (config.max_message_size_ == 0) ||
+      (config.max_reassembly_size_ < config.max_message_size_)) {
+    return Result::kInvalidParameter;
+  }
+  // Reassembly relies on the chunks of a message being all received, in order
+  if (!data_channel_->ordered() || !data_channel_->reliable()) {
+    return Result::kInvalidOperation;
+  }
+  return InvokeOnSignalingThread([this, &config]() {
+    // Messages already queued are not split into chunks
+    if (!framing_config_ && !send_queue_.empty()) {
+      return Result::kInvalidOperation;
+    }
+    framing_config_ = config;
+    if (!send_queue_config_) {
+      send_queue_config_ = DataChannelSendQueueConfig{};
+      send_queue_enabled_.store(true, std::memory_order_release);
+    }
+    return Result::kSuccess;
+  });
+}
+
+Result DataChannel::SetReceiveConfig(
+    const DataChannelReceiveConfig& config,
+    MessageBatchCallback batch_callback) noexcept {
+  if (((config.mode_ != DataChannelReceiveMode::kDedicatedThread) &&
+       (config.mode_ != DataChannelReceiveMode::kManual)) ||
+      (config.queue_capacity_ == 0) ||
+      (config.queue_capacity_ > kMaxReceiveQueueCapacity) ||
+      (config.max_batch_size_ == 0) ||
+      (config.max_batch_size_ > kMaxReceiveBatchSize)) {
+    return Result::kInvalidParameter;
+  }
+  // Messages are queued on the signaling thread, so change the mode there to
+  // not race with a message being received.
+  return InvokeOnSignalingThread([&]() {
+    if (receive_mode_.load(std::memory_order_relaxed) !=
+        DataChannelReceiveMode::kDirect) {
+      return Result::kInvalidOperation;
+    }
+    receive_config_ = config;
+    receive_queue_ = std::make_unique<DataReceiveQueue>(config.queue_capacity_);
+    {
+      auto lock = std::scoped_lock{dispatch_mutex_};
+      dispatch_batch_.resize(config.max_batch_size_);
+      dispatch_data_.resize(config.max_batch_size_);
+      dispatch_sizes_.resize(config.max_batch_size_);
+    }
+    batch_callback_.Set(batch_callback);
+    if (config.mode_ == DataChannelReceiveMode::kDedicatedThread) {
+      receive_thread_ = std::thread([this]() { RunReceiveThread(); });
+    }
+    receive_mode_.store(config.mode_, std::memory_order_release);
+    return Result::kSuccess;
+  });
+}
+
+uint32_t DataChannel::DispatchMessages(uint32_t max_count) noexcept {
+  if (receive_mode_.load(std::memory_order_acquire) ==
+      DataChannelReceiveMode::kDirect) {
+    return 0;
+  }
+  // The queue supports a single consumer
+  auto lock = std::scoped_lock{dispatch_mutex_};
+  const bool batched = batch_callback_.IsSet();
+  uint32_t dispatched = 0;
+  while (dispatched < max_count) {
+    const uint32_t batch_size =
+        std::min(max_count - dispatched, receive_config_.max_batch_size_);
+    uint32_t count = 0;
+    while ((count < batch_size) &&
+           receive_queue_->Pop(dispatch_batch_[count])) {
+      ++count;
+    }
+    if (count == 0) {
+      break;
+    }
+
+    const int64_t now_us = rtc::TimeMicros();
+    {
+      auto latency_lock = std::scoped_lock{latency_mutex_};
+      for (uint32_t i = 0; i < count; ++i) {
+        latency_samples_[latency_sample_count_ % kLatencySampleCount] =
+            now_us - dispatch_batch_[i].enqueue_time_us_;
+        ++latency_sample_count_;
+      }
+    }
+
+    if (batched) {
+      for (uint32_t i = 0; i < count; ++i) {
+        dispatch_data_[i] = dispatch_batch_[i].data();
+        dispatch_sizes_[i] = dispatch_batch_[i].size();
+      }
+      batch_callback_(dispatch_data_.data(), dispatch_sizes_.data(), count);
+    } else {
+      for (uint32_t i = 0; i < count; ++i) {
+        message_callback_(dispatch_batch_[i].data(),
+                          dispatch_batch_[i].size());
+      }
+    }
+
+    // Release the message buffers right away
+    for (uint32_t i = 0; i < count; ++i) {
+      dispatch_batch_[i].buffer_ = rtc::CopyOnWriteBuffer();
+    }
+    delivered_message_count_.fetch_add(count, std::memory_order_relaxed);
+    dispatched += count;
+  }
+  return dispatched;
+}
+
+DataChannelReceiveStats DataChannel::GetReceiveStats() const noexcept {
+  DataChannelReceiveStats stats;
+  stats.delivered_message_count =
+      delivered_message_count_.load(std::memory_order_relaxed);
+  stats.dropped_message_count =
+      dropped_message_count_.load(std::memory_order_relaxed);
+  stats.max_queue_depth = max_queue_depth_.load(std::memory_order_relaxed);
+  if (receive_mode_.load(std::memory_order_acquire) !=
+      DataChannelReceiveMode::kDirect) {
+    stats.queue_depth = receive_queue_->size();
+  }
+  std::array<int64_t, kLatencySampleCount> samples;
+  size_t sample_count;
+  {
+    auto lock = std::scoped_lock{latency_mutex_};
+    sample_count = std::min(latency_sample_count_, kLatencySampleCount);
+    std::copy_n(latency_samples_.begin(), sample_count, samples.begin());
+  }
+  if (sample_count > 0) {
+    std::sort(samples.begin(), samples.begin() + sample_count);
+    auto percentile = [&](size_t p) {
+      return samples[std::min((sample_count * p) / 100, sample_count - 1)];
+    };
+    stats.latency_p50_us = percentile(50);
+    stats.latency_p90_us = percentile(90);
+    stats.latency_p99_us = percentile(99);
+  }
+  return stats;
+}
+
+void DataChannel::RunReceiveThread() noexcept {
+  const uint32_t max_count = static_cast<uint32_t>(receive_queue_->capacity());
+  while (!stop_receive_thread_.load(std::memory_order_acquire)) {
+    // The event is set by the first message queued after the queue was
+    // observed empty, so no message can be left waiting.
+    if (DispatchMessages(max_count) == 0) {
+      receive_event_.Wait(rtc::Event::kForever);
+    }
+  }
+}
+
+bool DataChannel::SendNextChunk() noexcept {
+  QueuedMessage& message = send_queue_.front();
+  const size_t message_size = message.data_.size();
+  const size_t payload_size =
+      std::min<size_t>(message_size - message.offset_,
+                       framing_config_->chunk_size_ - kChunkHeaderSize);
+
+  // Build the chunk into a pooled buffer, which is recycled as soon as the
+  // chunk is sent if WebRTC does not buffer it.
+  DataSendBufferPool& pool = DataSendBufferPool::Instance();
+  DataSendBuffer* const chunk = pool.Acquire(kChunkHeaderSize + payload_size);
+  uint8_t* const data = chunk->data();
+  rtc::SetBE32(data, message.id_);
+  rtc::SetBE32(data + 4, static_cast<uint32_t>(message_size));
+  rtc::SetBE32(data + 8, static_cast<uint32_t>(message.offset_));
+  memcpy(data + kChunkHeaderSize, message.data_.cdata() + message.offset_,
+         payload_size);
+  webrtc::DataBuffer data_buffer(chunk->buffer(), /* binary = */ true);
+  const bool sent = data_channel_->Send(data_buffer);
+  pool.Release(chunk);
+  if (!sent) {
+    return false;
+  }
+
+  message.offset_ += payload_size;
+  queued_bytes_.fetch_sub(payload_size, std::memory_order_relaxed);
+  if (message.offset_ == message_size) {
+    send_queue_.pop_front();
+    queued_message_count_.fetch_sub(1, std::memory_order_relaxed);
+  } else if (send_queue_.size() > 1) {
+    // Round-robin between the messages in the queue
+    send_queue_.push_back(std::move(message));
+    send_queue_.pop_front();
+  }
+  return true;
+}
+
+void DataChannel::OnChunkReceived(
+    const rtc::CopyOnWriteBuffer& chunk) noexcept {
+  if (chunk.size() < kChunkHeaderSize) {
+    RTC_LOG(LS_ERROR) << "Dropping invalid chunk of " << chunk.size()
+                      << " bytes received on data channel " << id() << ".";
+    return;
+  }
+  const uint8_t* const header = chunk.cdata();
+  const uint32_t message_id = rtc::GetBE32(header);
+  const uint32_t message_size = rtc::GetBE32(header + 4);
+  const uint32_t offset = rtc::GetBE32(header + 8);
+  const uint8_t* const payload = header + kChunkHeaderSize;
+  const size_t payload_size = chunk.size() - kChunkHeaderSize;
+  if ((offset > message_size) || (payload_size > message_size - offset)) {
+    RTC_LOG(LS_ERROR) << "Dropping message #" << message_id
+                      << " with invalid chunk received on data channel "
+                      << id() << ".";
+    DropIncomingMessage(message_id);
+    return;
+  }
+  if (message_size > framing_config_->max_message_size_) {
+    // Log once per message, not for each of its chunks
+    if (offset == 0) {
+      RTC_LOG(LS_ERROR) << "Dropping message #" << message_id << " of "
+                        << message_size << " bytes received on data channel "
+                        << id() << ", larger than the maximum message size.";
+    }
+    DropIncomingMessage(message_id);
+    return;
+  }
+
+  // Deliver messages made of a single chunk without copy
+  if ((offset == 0) && (payload_size == message_size)) {
+    DeliverMessage(chunk, kChunkHeaderSize);
+    return;
+  }
+
+  auto it = incoming_messages_.find(message_id);
+  if (offset == 0) {
+    // Identifiers wrap around, so drop any stale message with the same one
+    DropIncomingMessage(message_id);
+    if (incoming_bytes_ + message_size >
+        framing_config_->max_reassembly_size_) {
+      RTC_LOG(LS_ERROR) << "Dropping message #" << message_id << " of "
+                        << message_size << " bytes received on data channel "
+                        << id() << ", exceeding the maximum reassembly size.";
+      return;
+    }
+    it = incoming_messages_.emplace(message_id, IncomingMessage{}).first;
+    it->second.data_ = rtc::CopyOnWriteBuffer(message_size);
+    it->second.size_ = message_size;
+    incoming_bytes_ += message_size;
+  } else if ((it == incoming_messages_.end()) ||
+             (it->second.size_ != message_size) ||
+             (it->second.received_ != offset)) {
+    // Chunks of a message arrive in order on an ordered reliable channel, so
+    // this is a chunk of a message already dropped.
+    DropIncomingMessage(message_id);
+    return;
+  }
+  IncomingMessage& message = it->second;
+  memcpy(message.data_.data() + offset, payload, payload_size);
+  message.received_ += static_cast<uint32_t>(payload_size);
+  if (message.received_ == message_size) {
+    const rtc::CopyOnWriteBuffer data = std::move(message.data_);
+    incoming_messages_.erase(it);
+    incoming_bytes_ -= message_size;
+    DeliverMessage(data);
+  }
+}
+
+void DataChannel::DropIncomingMessage(uint32_t message_id) noexcept {
+  auto it = incoming_messages_.find(message_id);
+  if (it != incoming_messages_.end()) {
+    incoming_bytes_ -= it->second.size_;
+    incoming_messages_.erase(it);
+  }
+}
+
+void DataChannel::DeliverMessage(const rtc::CopyOnWriteBuffer& buffer,
+                                 size_t offset) noexcept {
+  // The receive mode only changes on the signaling thread, which is this one
+  if (receive_mode_.load(std::memory_order_relaxed) ==
+      DataChannelReceiveMode::kDirect) {
+    message_callback_(buffer.cdata() + offset, buffer.size() - offset);
+    return;
+  }
+  EnqueueMessage(buffer, offset);
+}
+
+void DataChannel::EnqueueMessage(const rtc::CopyOnWriteBuffer& buffer,
+                                 size_t offset) noexcept {
+  // Share the buffer instead of copying the message. WebRTC does not write to
+  // it once received, and writing to a shared buffer would copy it.
+  ReceivedDataMessage message;
+  message.buffer_ = buffer;
+  message.offset_ = offset;
+  message.enqueue_time_us_ = rtc::TimeMicros();
+  bool was_empty = false;
+  if (!receive_queue_->Push(std::move(message), was_empty)) {
+    // Do not block the WebRTC transport on a slow consumer
+    dropped_message_count_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  // This is the only thread writing the maximum depth
+  const uint64_t depth = receive_queue_->size();
+  if (depth > max_queue_depth_.load(std::memory_order_relaxed)) {
+    max_queue_depth_.store(depth, std::memory_order_relaxed);
+  }
+  if (was_empty &&
+      (receive_config_.mode_ == DataChannelReceiveMode::kDedicatedThread)) {
+    receive_event_.Set();
+  }
+}
+
+void DataChannel::UpdateBackpressure() noexcept {
+  if (!send_queue_config_) {
+    return;
+  }
+  const uint64_t pending = data_channel_->buffered_amount() +
+                           queued_bytes_.load(std::memory_order_relaxed);
+  const bool backpressure = backpressure_.load(std::memory_order_relaxed);
+  if (!backpressure && (pending >= send_queue_config_->high_watermark_bytes_)) {
+    backpressure_.store(true, std::memory_order_relaxed);
+  } else if (backpressure &&
+             (pending <= send_queue_config_->low_watermark_bytes_)) {
+    backpressure_.store(false, std::memory_order_relaxed);
+  } else {
+    return;
+  }
+  // Invoke the callback without holding the lock, so that it can send more
+  // messages, which can signal backpressure again.
+  BackpressureCallback callback;
+  {
+    auto lock = std::scoped_lock{mutex_};
+    callback = backpressure_callback_;
+  }
+  if (callback) {
+    callback(backpressure ? mrsBool::kFalse : mrsBool::kTrue);
+  }
+}
+
 void DataChannel::OnStateChange() noexcept {
   const webrtc::DataChannelInterface::DataState state = data_channel_->state();
   switch (state) {
@@ -91,6 +632,25 @@ void DataChannel::OnStateChange() noexcept {
       if (data_channel_->negotiated()) {
         owner_->OnDataChannelAdded(*this);
       }
+      // Send the messages queued while connecting
+      if (send_queue_config_) {
+        DrainSendQueue();
+      }
+      break;
+    case webrtc::DataChannelInterface::DataState::kClosing:
+    case webrtc::DataChannelInterface::DataState::kClosed:
+      // Messages still queued will never be sent, and messages partially
+      // received will never complete.
+      incoming_messages_.clear();
+      incoming_bytes_ = 0;
+      if (!send_queue_.empty()) {
+        discarded_message_count_.fetch_add(send_queue_.size(),
+                                           std::memory_order_relaxed);
+        send_queue_.clear();
+        queued_message_count_.store(0, std::memory_order_relaxed);
+        queued_bytes_.store(0, std::memory_order_relaxed);
+        UpdateBackpressure();
+      }
       break;
   }
 
@@ -105,19 +665,27 @@ void DataChannel::OnStateChange() noexcept {
 }
 
 void DataChannel::OnMessage(const webrtc::DataBuffer& buffer) noexcept {
-  auto lock = std::scoped_lock{mutex_};
-  if (message_callback_) {
-    message_callback_(buffer.data.data(), buffer.data.size());
+  if (framing_config_) {
+    OnChunkReceived(buffer.data);
+    return;
   }
+  DeliverMessage(buffer.data);
 }
 
 void DataChannel::OnBufferedAmountChange(uint64_t previous_amount) noexcept {
-  auto lock = std::scoped_lock{mutex_};
-  if (buffering_callback_) {
-    uint64_t current_amount = data_channel_->buffered_amount();
-    constexpr uint64_t max_capacity =
-        0x1000000;  // 16MB, see DataChannelInterface
-    buffering_callback_(previous_amount, current_amount, max_capacity);
+  {
+    auto lock = std::scoped_lock{mutex_};
+    if (buffering_callback_) {
+      uint64_t current_amount = data_channel_->buffered_amount();
+      constexpr uint64_t max_capacity =
+          0x1000000;  // 16MB, see DataChannelInterface
+      buffering_callback_(previous_amount, current_amount, max_capacity);
+    }
+  }
+
+  // Move queued messages to the WebRTC buffer as it drains
+  if (send_queue_config_) {
+    DrainSendQueue();
   }
 }
 
@@ -4,12 +4,24 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <deque>
+#include <memory>
 #include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 #include "api/datachannelinterface.h"
+#include "rtc_base/event.h"
+#include "rtc_base/thread_annotations.h"
 
 #include "callback.h"
+#include "callback_slot.h"
 #include "data_channel.h"
+#include "data_receive_queue.h"
 #include "str.h"
 
 // Internal
@@ -19,6 +31,109 @@ namespace Microsoft::MixedReality::WebRTC {
 
 class PeerConnection;
 
+/// Configuration of the optional send queue of a data channel. The watermarks
+/// apply to the amount of data pending, that is buffered by WebRTC plus held in
+/// the send queue.
+struct DataChannelSendQueueConfig {
+  /// Maximum amount of data held in the send queue, in bytes, in addition to
+  /// the data buffered by WebRTC. Messages sent while the queue is full are
+  /// rejected.
+  uint64_t capacity_bytes_{64 * 1024 * 1024};
+
+  /// Amount of pending data, in bytes, at or above which backpressure is
+  /// signaled, for the producer to pause.
+  uint64_t high_watermark_bytes_{8 * 1024 * 1024};
+
+  /// Amount of pending data, in bytes, at or below which backpressure is
+  /// released, for the producer to resume. This must be less than the high
+  /// watermark.
+  uint64_t low_watermark_bytes_{1024 * 1024};
+};
+
+/// Snapshot of the statistics of the send queue of a data channel.
+struct DataChannelSendQueueStats {
+  /// Number of messages and bytes currently held in the send queue.
+  uint64_t queued_message_count{0};
+  uint64_t queued_bytes{0};
+
+  /// Number of messages rejected because the queue was full, the message was
+  /// too large to ever be sent, or the channel was closed.
+  uint64_t rejected_message_count{0};
+
+  /// Number of queued messages discarded because the channel closed before
+  /// they could be sent.
+  uint64_t discarded_message_count{0};
+
+  /// Backpressure is currently signaled.
+  bool backpressure{false};
+};
+
+/// Mode of delivery of the messages received on a data channel.
+enum class DataChannelReceiveMode : int32_t {
+  /// Invoke the message callback directly on the WebRTC thread receiving the
+  /// message. A slow callback delays the WebRTC transport.
+  kDirect = 0,
+
+  /// Queue the messages, and invoke the message callback on a thread dedicated
+  /// to the data channel.
+  kDedicatedThread = 1,
+
+  /// Queue the messages, and invoke the message callback on the thread calling
+  /// |DataChannel::DispatchMessages()|, for example a game loop thread.
+  kManual = 2,
+};
+
+/// Configuration of the delivery of the messages received on a data channel.
+struct DataChannelReceiveConfig {
+  DataChannelReceiveMode mode_{DataChannelReceiveMode::kDirect};
+
+  /// Maximum number of messages queued and not yet delivered, rounded up to
+  /// the next power of two. Messages received while the queue is full are
+  /// dropped.
+  uint32_t queue_capacity_{1024};
+
+  /// Maximum number of messages delivered together to the batch callback, if
+  /// registered.
+  uint32_t max_batch_size_{64};
+};
+
+/// Snapshot of the statistics of the delivery of the messages received on a
+/// data channel, when queued.
+struct DataChannelReceiveStats {
+  /// Number of messages delivered to the callbacks.
+  uint64_t delivered_message_count{0};
+
+  /// Number of messages dropped because the queue was full.
+  uint64_t dropped_message_count{0};
+
+  /// Number of messages currently queued, and maximum number of messages
+  /// queued at any time.
+  uint64_t queue_depth{0};
+  uint64_t max_queue_depth{0};
+
+  /// Percentiles of the time messages spent in the queue before being
+  /// delivered, in microseconds, over the most recent messages.
+  int64_t latency_p50_us{0};
+  int64_t latency_p90_us{0};
+  int64_t latency_p99_us{0};
+};
+
+/// Configuration of the framing mode of a data channel.
+struct DataChannelFramingConfig {
+  /// Size in bytes of the chunks messages are split into, including the chunk
+  /// header, from 64 bytes to 64 KB.
+  uint32_t chunk_size_{16 * 1024};
+
+  /// Maximum size in bytes of a received message. Larger messages are dropped,
+  /// to bound the memory used for reassembly.
+  uint32_t max_message_size_{256 * 1024 * 1024};
+
+  /// Maximum total size in bytes of the messages being reassembled at once,
+  /// no less than |max_message_size_|. Messages starting while the ones being
+  /// reassembled already use this much memory are dropped.
+  uint32_t max_reassembly_size_{512 * 1024 * 1024};
+};
+
 /// A data channel is a bidirectional pipe established between the local and
 /// remote peer to carry random blobs of data.
 /// The data channel API does not specify the content of the data; instead the
@@ -51,6 +166,12 @@ class DataChannel : public webrtc::DataChannelObserver {
   /// Callback fired on newly available data channel data.
   using MessageCallback = Callback<const void*, const uint64_t>;
 
+  /// Callback fired with a batch of messages received on the data channel, in
+  /// queued receive mode. The parameters are the arrays of the addresses and
+  /// sizes of the messages, and the number of messages.
+  using MessageBatchCallback =
+      Callback<const void* const*, const uint64_t*, uint32_t>;
+
   /// Callback fired when data buffering changed.
   /// The first parameter indicates the old buffering amount in bytes, the
   /// second one the new value, and the last one indicates the limit in bytes
@@ -64,6 +185,9 @@ class DataChannel : public webrtc::DataChannelObserver {
   /// Callback fired when the data channel state changed.
   using StateCallback = Callback</*DataChannelState*/ int, int>;
 
+  /// Callback fired when the send queue signals or releases backpressure.
+  using BackpressureCallback = Callback<mrsBool>;
+
   DataChannel(PeerConnection* owner,
               rtc::scoped_refptr<webrtc::DataChannelInterface> data_channel,
               mrsDataChannelInteropHandle interop_handle = nullptr) noexcept;
@@ -85,9 +209,74 @@ class DataChannel : public webrtc::DataChannelObserver {
   /// data.
   [[nodiscard]] size_t GetMaxBufferingSize() const noexcept;
 
-  /// Send a blob of data through the data channel.
+  /// Send a blob of data through the data channel. The data is copied, so the
+  /// caller can reuse its buffer as soon as this returns.
   bool Send(const void* data, size_t size) noexcept;
 
+  /// Send a message through the data channel, taking ownership of its buffer.
+  /// The buffer storage is shared with the data channel, without copy, until
+  /// the message is sent. This allows sending a message written directly into
+  /// a buffer from a |DataSendBufferPool|.
+  bool Send(rtc::CopyOnWriteBuffer buffer) noexcept;
+
+  /// Send a batch of |count| messages through the data channel, in order. The
+  /// message |i| is made of |sizes[i]| bytes at |messages[i]|, and is copied.
+  /// The whole batch is sent with a single dispatch to the signaling thread
+  /// and a single query of the buffered amount, which is much cheaper than
+  /// calling |Send()| for each small message. Return the number of messages
+  /// accepted: messages are accepted in order until one is rejected, because
+  /// the data channel is not open or its buffer is full, in which case that
+  /// message and all subsequent ones are not sent, to preserve ordering.
+  size_t SendBatch(const void* const* messages,
+                   const uint64_t* sizes,
+                   size_t count) noexcept;
+
+  /// Enable the send queue, or change its configuration if already enabled.
+  /// Once enabled, messages which do not fit in the WebRTC buffer, or which
+  /// are sent before the channel opens, are held in the send queue instead of
+  /// being rejected, and are sent automatically as the WebRTC buffer drains.
+  /// The |callback| is invoked on the WebRTC signaling thread when the amount
+  /// of pending data crosses the watermarks of |config|, and can send more
+  /// messages.
+  Result EnableSendQueue(const DataChannelSendQueueConfig& config,
+                         BackpressureCallback callback) noexcept;
+
+  /// Get a snapshot of the statistics of the send queue.
+  DataChannelSendQueueStats GetSendQueueStats() const noexcept;
+
+  /// Enable the framing mode, which must be enabled on both ends of an ordered
+  /// and reliable data channel before any message is sent. In framing mode,
+  /// messages are split into chunks of at most |config.chunk_size_| bytes,
+  /// and the chunks of the messages pending in the send queue are sent in
+  /// turn, such that a small message is not delayed until a large message sent
+  /// before it is fully sent. Chunks are reassembled on receive into a buffer
+  /// of the message size before invoking the message callback, so messages
+  /// are delivered in the order in which their last chunk is received, which
+  /// is not necessarily the order in which they were sent. This enables the
+  /// send queue with a default configuration, if not already enabled.
+  Result EnableFraming(const DataChannelFramingConfig& config) noexcept;
+
+  /// Change the delivery mode of the received messages from the default direct
+  /// mode to a queued mode. This can be done only once, generally right after
+  /// creating the data channel. In queued mode, the buffers WebRTC receives the
+  /// messages into are appended without copy to a lock-free queue by the
+  /// WebRTC thread, and the messages are delivered on another thread without
+  /// blocking the WebRTC transport. If
+  /// |batch_callback| is valid, messages available together are delivered in
+  /// batches of up to |config.max_batch_size_| messages through it, instead of
+  /// one by one through the message callback.
+  Result SetReceiveConfig(const DataChannelReceiveConfig& config,
+                          MessageBatchCallback batch_callback) noexcept;
+
+  /// Deliver up to |max_count| of the messages currently queued, on the
+  /// calling thread. This is used in the |DataChannelReceiveMode::kManual|
+  /// mode, and must not be called from a message callback. Return the number
+  /// of messages delivered.
+  uint32_t DispatchMessages(uint32_t max_count) noexcept;
+
+  /// Get a snapshot of the statistics of the delivery of received messages.
+  DataChannelReceiveStats GetReceiveStats() const noexcept;
+
   //
   // Advanced use
   //
@@ -115,6 +304,45 @@ class DataChannel : public webrtc::DataChannelObserver {
   void OnBufferedAmountChange(uint64_t previous_amount) noexcept override;
 
  private:
+  /// Send a message if the send queue is empty and the WebRTC buffer has room
+  /// for it, or append it to the send queue otherwise. This must be called on
+  /// the signaling thread, with the send queue enabled.
+  bool SendOrEnqueue(rtc::CopyOnWriteBuffer buffer) noexcept;
+
+  /// Move messages from the send queue to the WebRTC buffer while it has room
+  /// for them. This must be called on the signaling thread.
+  void DrainSendQueue() noexcept;
+
+  /// Send the next chunk of the message at the front of the send queue in
+  /// framing mode, then move that message to the back of the queue if not yet
+  /// fully sent. Return |false| if the chunk could not be sent.
+  bool SendNextChunk() noexcept;
+
+  /// Handle a chunk received in framing mode, and invoke the message callback
+  /// once it completes a message.
+  void OnChunkReceived(const rtc::CopyOnWriteBuffer& chunk) noexcept;
+
+  /// Drop the message being reassembled with the given identifier, if any.
+  void DropIncomingMessage(uint32_t message_id) noexcept;
+
+  /// Invoke the message callback for a received message, made of the bytes of
+  /// |buffer| starting at |offset|, or queue the message in queued receive
+  /// mode.
+  void DeliverMessage(const rtc::CopyOnWriteBuffer& buffer,
+                      size_t offset = 0) noexcept;
+
+  /// Append a received message to the receive queue, sharing its buffer, and
+  /// wake up the dedicated receive thread if needed.
+  void EnqueueMessage(const rtc::CopyOnWriteBuffer& buffer,
+                      size_t offset) noexcept;
+
+  /// Entry point of the dedicated receive thread.
+  void RunReceiveThread() noexcept;
+
+  /// Signal or release backpressure depending on the amount of pending data.
+  /// This must be called on the signaling thread.
+  void UpdateBackpressure() noexcept;
+
   /// PeerConnection object owning this data channel. This is only valid from
   /// creation until the data channel is removed from the peer connection with
   /// RemoveDataChannel(), at which point the data channel is removed from its
@@ -124,11 +352,102 @@ class DataChannel : public webrtc::DataChannelObserver {
   /// Underlying core implementation.
   rtc::scoped_refptr<webrtc::DataChannelInterface> data_channel_;
 
-  MessageCallback message_callback_ RTC_GUARDED_BY(mutex_);
+  /// Message callbacks, invoked without holding |mutex_| so that a slow
+  /// callback does not delay the other callbacks.
+  CallbackSlot<MessageCallback> message_callback_;
+  CallbackSlot<MessageBatchCallback> batch_callback_;
+
   BufferingCallback buffering_callback_ RTC_GUARDED_BY(mutex_);
   StateCallback state_callback_ RTC_GUARDED_BY(mutex_);
+  BackpressureCallback backpressure_callback_ RTC_GUARDED_BY(mutex_);
   std::mutex mutex_;
 
+  /// Configuration of the send queue, if enabled. The send queue is only
+  /// accessed on the signaling thread, where WebRTC invokes the observer
+  /// methods, so that queued messages are sent in order.
+  std::optional<DataChannelSendQueueConfig> send_queue_config_;
+
+  /// Message held in the send queue.
+  struct QueuedMessage {
+    rtc::CopyOnWriteBuffer data_;
+
+    /// In framing mode, identifier of the message, and number of bytes already
+    /// sent in chunks.
+    uint32_t id_{0};
+    size_t offset_{0};
+  };
+  std::deque<QueuedMessage> send_queue_;
+  std::atomic_bool send_queue_enabled_{false};
+
+  /// |DrainSendQueue()| is running. Sending a message can synchronously invoke
+  /// |OnBufferedAmountChange()| if WebRTC buffers it, which must not drain the
+  /// send queue again.
+  bool draining_{false};
+
+  /// Send queue statistics, written on the signaling thread.
+  std::atomic_uint64_t queued_message_count_{0};
+  std::atomic_uint64_t queued_bytes_{0};
+  std::atomic_uint64_t rejected_message_count_{0};
+  std::atomic_uint64_t discarded_message_count_{0};
+  std::atomic_bool backpressure_{false};
+
+  /// Configuration of the framing mode, if enabled. Like the send queue, this
+  /// and the framing state are only accessed on the signaling thread.
+  std::optional<DataChannelFramingConfig> framing_config_;
+
+  /// Identifier of the next message sent in framing mode.
+  uint32_t next_message_id_{0};
+
+  /// Message being reassembled from its chunks in framing mode.
+  struct IncomingMessage {
+    rtc::CopyOnWriteBuffer data_;
+    uint32_t size_{0};
+    uint32_t received_{0};
+  };
+  std::unordered_map<uint32_t, IncomingMessage> incoming_messages_;
+
+  /// Total size in bytes of the messages in |incoming_messages_|.
+  uint64_t incoming_bytes_{0};
+
+  /// Delivery mode of the received messages. The receive configuration and
+  /// queue are set once, before this is changed from the direct mode.
+  std::atomic<DataChannelReceiveMode> receive_mode_{
+      DataChannelReceiveMode::kDirect};
+  DataChannelReceiveConfig receive_config_;
+  std::unique_ptr<DataReceiveQueue> receive_queue_;
+
+  /// Dedicated receive thread, and event waking it up when a message is queued
+  /// or when it needs to stop.
+  std::thread receive_thread_;
+  rtc::Event receive_event_{/* manual_reset = */ false,
+                            /* initially_signaled = */ false};
+  std::atomic_bool stop_receive_thread_{false};
+
+  /// Mutex serializing the consumers of the receive queue, and protecting the
+  /// batch being delivered.
+  std::mutex dispatch_mutex_;
+  std::vector<ReceivedDataMessage> dispatch_batch_
+      RTC_GUARDED_BY(dispatch_mutex_);
+  std::vector<const void*> dispatch_data_ RTC_GUARDED_BY(dispatch_mutex_);
+  std::vector<uint64_t> dispatch_sizes_ RTC_GUARDED_BY(dispatch_mutex_);
+
+  /// Number of queue latency samples used to compute percentiles.
+  static constexpr size_t kLatencySampleCount = 256;
+
+  /// Ring buffer of the most recent queue latency samples, in microseconds,
+  /// and total number of samples recorded.
+  std::array<int64_t, kLatencySampleCount> latency_samples_
+      RTC_GUARDED_BY(latency_mutex_){};
+  size_t latency_sample_count_ RTC_GUARDED_BY(latency_mutex_){0};
+
+  /// Mutex protecting the latency samples, locked once per batch delivered.
+  mutable std::mutex latency_mutex_;
+
+  /// Receive statistics.
+  std::atomic_uint64_t delivered_message_count_{0};
+  std::atomic_uint64_t dropped_message_count_{0};
+  std::atomic_uint64_t max_queue_depth_{0};
+
   /// Optional interop handle, if associated with an interop wrapper.
   mrsDataChannelInteropHandle interop_handle_{};
 };
@@ -0,0 +1,55 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include "data_receive_queue.h"
+
+namespace {
+
+uint64_t RoundUpToPowerOfTwo(uint32_t value) {
+  uint64_t result = 1;
+  while (result < value) {
+    result *= 2;
+  }
+  return result;
+}
+
+}  // namespace
+
+namespace Microsoft::MixedReality::WebRTC {
+
+DataReceiveQueue::DataReceiveQueue(uint32_t capacity) noexcept
+    : slots_(static_cast<size_t>(RoundUpToPowerOfTwo(capacity))),
+      mask_(slots_.size() - 1) {}
+
+bool DataReceiveQueue::Push(ReceivedDataMessage&& message,
+                            bool& was_empty) noexcept {
+  const uint64_t write_pos = write_pos_.load(std::memory_order_relaxed);
+  if (write_pos - read_pos_.load() >= slots_.size()) {
+    return false;
+  }
+  slots_[write_pos & mask_] = std::move(message);
+  write_pos_.store(write_pos + 1);
+  was_empty = (read_pos_.load() == write_pos);
+  return true;
+}
+
+bool DataReceiveQueue::Pop(ReceivedDataMessage& message) noexcept {
+  const uint64_t read_pos = read_pos_.load(std::memory_order_relaxed);
+  if (read_pos == write_pos_.load()) {
+    return false;
+  }
+  message = std::move(slots_[read_pos & mask_]);
+  read_pos_.store(read_pos + 1);
+  return true;
+}
+
+size_t DataReceiveQueue::size() const noexcept {
+  const uint64_t read_pos = read_pos_.load(std::memory_order_relaxed);
+  const uint64_t write_pos = write_pos_.load(std::memory_order_relaxed);
+  return static_cast<size_t>(write_pos >= read_pos ? write_pos - read_pos
+                                                   : 0);
+}
+
+}  // namespace Microsoft::MixedReality::WebRTC
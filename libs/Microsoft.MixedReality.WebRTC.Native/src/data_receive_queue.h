@@ -0,0 +1,69 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "rtc_base/copyonwritebuffer.h"
+
+namespace Microsoft::MixedReality::WebRTC {
+
+/// Message received on a data channel and queued for delivery.
+struct ReceivedDataMessage {
+  /// Buffer holding the message, shared without copy with the buffer WebRTC
+  /// received the message into.
+  rtc::CopyOnWriteBuffer buffer_;
+
+  /// Offset of the message in |buffer_|, in bytes. In framing mode, a message
+  /// made of a single chunk starts after the chunk header.
+  size_t offset_{0};
+
+  /// Time when the message was queued, in microseconds.
+  int64_t enqueue_time_us_{0};
+
+  const uint8_t* data() const noexcept { return buffer_.cdata() + offset_; }
+  uint64_t size() const noexcept { return buffer_.size() - offset_; }
+};
+
+/// Bounded lock-free queue of messages received on a data channel, written by
+/// the WebRTC thread receiving the messages and read by the thread delivering
+/// them. This supports a single producer thread and a single consumer thread.
+class DataReceiveQueue {
+ public:
+  /// Create a queue holding up to |capacity| messages, rounded up to the next
+  /// power of two.
+  explicit DataReceiveQueue(uint32_t capacity) noexcept;
+
+  /// Append a message to the queue, from the producer thread. Return |false|
+  /// if the queue is full, in which case |message| is left untouched. On
+  /// success, |was_empty| indicates whether the consumer had read all previous
+  /// messages, and therefore might be waiting for this one.
+  bool Push(ReceivedDataMessage&& message, bool& was_empty) noexcept;
+
+  /// Remove the oldest message from the queue, from the consumer thread.
+  /// Return |false| if the queue is empty.
+  bool Pop(ReceivedDataMessage& message) noexcept;
+
+  /// Get the number of messages currently queued. This is only a snapshot,
+  /// since the queue can be modified concurrently.
+  size_t size() const noexcept;
+
+  /// Get the maximum number of messages the queue can hold.
+  size_t capacity() const noexcept { return slots_.size(); }
+
+ private:
+  std::vector<ReceivedDataMessage> slots_;
+  const uint64_t mask_;
+
+  /// Total number of messages pushed and popped. The positions are in
+  /// separate cache lines to avoid false sharing between the producer and the
+  /// consumer. Sequentially consistent operations ensure that either the
+  /// consumer observes a message pushed, or the producer observes that the
+  /// consumer emptied the queue and needs to be woken up.
+  alignas(64) std::atomic_uint64_t write_pos_{0};
+  alignas(64) std::atomic_uint64_t read_pos_{0};
+};
+
+}  // namespace Microsoft::MixedReality::WebRTC
@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include "data_send_buffer.h"
+
+namespace {
+
+// Maximum number of free buffers cached. This needs to be large enough to
+// cover a burst of small messages sent back-to-back by several data channels.
+constexpr size_t kMaxFreeBuffers = 64;
+
+}  // namespace
+
+namespace Microsoft::MixedReality::WebRTC {
+
+DataSendBufferPool& DataSendBufferPool::Instance() noexcept {
+  // Intentionally leaked; see declaration.
+  static DataSendBufferPool* const instance = new DataSendBufferPool();
+  return *instance;
+}
+
+DataSendBufferPool::~DataSendBufferPool() noexcept {
+  Trim();
+}
+
+DataSendBuffer* DataSendBufferPool::Acquire(size_t size) noexcept {
+  outstanding_count_.fetch_add(1, std::memory_order_relaxed);
+  if (size > kMaxPooledSize) {
+    miss_count_.fetch_add(1, std::memory_order_relaxed);
+    return new DataSendBuffer(size, size, /* pooled = */ false);
+  }
+  DataSendBuffer* buffer = nullptr;
+  {
+    auto lock = std::scoped_lock{mutex_};
+    if (!free_buffers_.empty()) {
+      buffer = free_buffers_.back();
+      free_buffers_.pop_back();
+    }
+  }
+  if (!buffer) {
+    miss_count_.fetch_add(1, std::memory_order_relaxed);
+    return new DataSendBuffer(size, kMaxPooledSize, /* pooled = */ true);
+  }
+  hit_count_.fetch_add(1, std::memory_order_relaxed);
+  // This clones the storage, with the same capacity, if a previous message is
+  // still queued by a data channel.
+  buffer->buffer_.SetSize(size);
+  return buffer;
+}
+
+void DataSendBufferPool::Release(DataSendBuffer* buffer) noexcept {
+  if (!buffer) {
+    return;
+  }
+  outstanding_count_.fetch_sub(1, std::memory_order_relaxed);
+  if (buffer->is_pooled()) {
+    auto lock = std::scoped_lock{mutex_};
+    if (free_buffers_.size() < kMaxFreeBuffers) {
+      if (free_buffers_.capacity() == 0) {
+        free_buffers_.reserve(kMaxFreeBuffers);
+      }
+      free_buffers_.push_back(buffer);
+      recycle_count_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+  }
+  discard_count_.fetch_add(1, std::memory_order_relaxed);
+  delete buffer;
+}
+
+void DataSendBufferPool::Trim() noexcept {
+  std::vector<DataSendBuffer*> free_buffers;
+  {
+    auto lock = std::scoped_lock{mutex_};
+    free_buffers.swap(free_buffers_);
+  }
+  for (DataSendBuffer* buffer : free_buffers) {
+    delete buffer;
+  }
+}
+
+DataSendBufferPoolStats DataSendBufferPool::GetStats() const noexcept {
+  DataSendBufferPoolStats stats;
+  stats.hit_count = hit_count_.load(std::memory_order_relaxed);
+  stats.miss_count = miss_count_.load(std::memory_order_relaxed);
+  stats.recycle_count = recycle_count_.load(std::memory_order_relaxed);
+  stats.discard_count = discard_count_.load(std::memory_order_relaxed);
+  stats.outstanding_count = outstanding_count_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+}  // namespace Microsoft::MixedReality::WebRTC
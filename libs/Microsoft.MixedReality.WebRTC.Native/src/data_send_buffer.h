@@ -0,0 +1,120 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "rtc_base/copyonwritebuffer.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace Microsoft::MixedReality::WebRTC {
+
+class DataSendBufferPool;
+
+/// Buffer holding a data channel message, acquired from a |DataSendBufferPool|
+/// and written in place by the caller, then sent with
+/// |DataChannel::Send(rtc::CopyOnWriteBuffer)| without copying the message.
+/// The storage of the buffer is ref-counted, and shared with the data channel
+/// while the message is queued for sending, so the buffer can be released as
+/// soon as the message is sent.
+class DataSendBuffer {
+ public:
+  /// Get a pointer to the message storage, to write the message into.
+  uint8_t* data() noexcept { return buffer_.data(); }
+
+  /// Get the size of the message, in bytes.
+  size_t size() const noexcept { return buffer_.size(); }
+
+  /// Get the message, sharing the buffer storage.
+  const rtc::CopyOnWriteBuffer& buffer() const noexcept { return buffer_; }
+
+  /// Check if the buffer is recycled by its pool once released, or deallocated.
+  bool is_pooled() const noexcept { return pooled_; }
+
+ protected:
+  friend class DataSendBufferPool;
+  DataSendBuffer(size_t size, size_t capacity, bool pooled) noexcept
+      : buffer_(size, capacity), pooled_(pooled) {}
+
+ private:
+  rtc::CopyOnWriteBuffer buffer_;
+  const bool pooled_;
+};
+
+/// Snapshot of the statistics of a |DataSendBufferPool|.
+struct DataSendBufferPoolStats {
+  /// Number of acquire requests served from a cached buffer.
+  uint64_t hit_count{0};
+
+  /// Number of acquire requests which needed a new allocation, either because
+  /// no buffer was cached, or because the message was too large to be pooled.
+  uint64_t miss_count{0};
+
+  /// Number of buffers returned to the pool and cached for reuse.
+  uint64_t recycle_count{0};
+
+  /// Number of buffers returned to the pool but deallocated, because they were
+  /// too large or the pool was full.
+  uint64_t discard_count{0};
+
+  /// Number of buffers currently acquired and not yet returned.
+  uint64_t outstanding_count{0};
+};
+
+/// Thread-safe pool of data channel message buffers.
+///
+/// Buffers for messages up to |kMaxPooledSize| bytes all have the same
+/// capacity, and are recycled once released, such that sending small messages
+/// does not allocate any memory once the pool is warm. Larger buffers are
+/// allocated on demand and deallocated on release; they still avoid copying
+/// the message from a caller buffer.
+///
+/// A recycled buffer whose storage is still shared with a message queued by
+/// the data channel is cloned on next acquire, so reusing a buffer never
+/// overwrites a message not yet sent.
+class DataSendBufferPool {
+ public:
+  /// Maximum size in bytes of a message whose buffer is pooled.
+  static constexpr size_t kMaxPooledSize = 16 * 1024;
+
+  /// Get the global pool instance shared by all data channels.
+  /// The global pool is never destroyed, so that buffers can be released at any
+  /// time, including during static destruction. Call |Trim()| to release the
+  /// cached memory once the library shuts down.
+  static DataSendBufferPool& Instance() noexcept;
+
+  DataSendBufferPool() noexcept = default;
+  ~DataSendBufferPool() noexcept;
+
+  /// Acquire a buffer for a message of |size| bytes. The buffer must be
+  /// returned with |Release()|.
+  DataSendBuffer* Acquire(size_t size) noexcept;
+
+  /// Return to the pool a buffer previously acquired with |Acquire()|.
+  void Release(DataSendBuffer* buffer) noexcept;
+
+  /// Deallocate all cached buffers. Buffers currently acquired are not
+  /// affected, and will be cached again when returned.
+  void Trim() noexcept;
+
+  /// Get a snapshot of the pool statistics.
+  DataSendBufferPoolStats GetStats() const noexcept;
+
+ private:
+  /// Free pooled buffers.
+  std::vector<DataSendBuffer*> free_buffers_ RTC_GUARDED_BY(mutex_);
+
+  /// Mutex protecting the collection of free buffers.
+  mutable std::mutex mutex_;
+
+  std::atomic_uint64_t hit_count_{0};
+  std::atomic_uint64_t miss_count_{0};
+  std::atomic_uint64_t recycle_count_{0};
+  std::atomic_uint64_t discard_count_{0};
+  std::atomic_uint64_t outstanding_count_{0};
+};
+
+}  // namespace Microsoft::MixedReality::WebRTC
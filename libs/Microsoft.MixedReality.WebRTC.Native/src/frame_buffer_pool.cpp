@@ -0,0 +1,168 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include "frame_buffer_pool.h"
+
+#include "rtc_base/memory/aligned_malloc.h"
+
+namespace {
+
+// Aligning pointer to 64 bytes for improved performance, e.g. use SIMD.
+constexpr size_t kBufferAlignment = 64;
+
+// Capacity of the smallest bucket. All requests below that size are served
+// from that bucket.
+constexpr size_t kMinBucketCapacity = 4096;
+
+// Number of buckets per power-of-two size range. Larger values reduce the
+// memory wasted per block, but reduce the chances of reusing a block for
+// frames of slightly different resolutions.
+constexpr size_t kBucketsPerPowerOfTwo = 8;
+
+// Maximum number of free blocks cached per bucket. This needs to be large
+// enough to cover the number of frames in flight for a single stream (decoder
+// output, observer queues, encoder input).
+constexpr size_t kMaxFreeBlocksPerBucket = 16;
+
+// Maximum total size of the free blocks cached across all buckets.
+constexpr size_t kMaxCachedBytes = 256 * 1024 * 1024;
+
+}  // namespace
+
+namespace Microsoft::MixedReality::WebRTC {
+
+void PooledMemoryDeleter::operator()(uint8_t* ptr) const noexcept {
+  if (pool_) {
+    pool_->Release(ptr, capacity_);
+  } else {
+    webrtc::AlignedFree(ptr);
+  }
+}
+
+size_t PooledI420Buffer::ByteSize(int width, int height) noexcept {
+  const size_t stride_y = width;
+  const size_t stride_uv = (width + 1) / 2;
+  const size_t chroma_height = (height + 1) / 2;
+  return stride_y * height + 2 * stride_uv * chroma_height;
+}
+
+PooledI420Buffer::PooledI420Buffer(int width,
+                                   int height,
+                                   PooledMemory data) noexcept
+    : width_(width),
+      height_(height),
+      stride_y_(width),
+      stride_uv_((width + 1) / 2),
+      data_(std::move(data)) {
+  RTC_DCHECK_GT(width, 0);
+  RTC_DCHECK_GT(height, 0);
+  RTC_DCHECK(data_);
+}
+
+FrameBufferPool& FrameBufferPool::Instance() noexcept {
+  // Intentionally leaked; see declaration.
+  static FrameBufferPool* const instance = new FrameBufferPool();
+  return *instance;
+}
+
+FrameBufferPool::~FrameBufferPool() noexcept {
+  Trim();
+}
+
+size_t FrameBufferPool::GetBucketCapacity(size_t size) noexcept {
+  if (size <= kMinBucketCapacity) {
+    return kMinBucketCapacity;
+  }
+  // Find the largest power of two strictly less than |size|, and split the
+  // range above it into evenly-sized buckets. This bounds the memory wasted
+  // per block to 1/kBucketsPerPowerOfTwo of the requested size.
+  size_t pow2 = kMinBucketCapacity;
+  while (pow2 * 2 < size) {
+    pow2 *= 2;
+  }
+  const size_t step = pow2 / kBucketsPerPowerOfTwo;
+  return ((size + step - 1) / step) * step;
+}
+
+PooledMemory FrameBufferPool::Acquire(size_t size) noexcept {
+  const size_t capacity = GetBucketCapacity(size);
+  uint8_t* ptr = nullptr;
+  {
+    auto lock = std::scoped_lock{mutex_};
+    auto it = free_blocks_.find(capacity);
+    if ((it != free_blocks_.end()) && !it->second.empty()) {
+      ptr = it->second.back();
+      it->second.pop_back();
+      cached_bytes_ -= capacity;
+    }
+  }
+  if (ptr) {
+    hit_count_.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    miss_count_.fetch_add(1, std::memory_order_relaxed);
+    ptr = static_cast<uint8_t*>(
+        webrtc::AlignedMalloc(capacity, kBufferAlignment));
+  }
+  outstanding_count_.fetch_add(1, std::memory_order_relaxed);
+  return PooledMemory(ptr, PooledMemoryDeleter{this, capacity});
+}
+
+rtc::scoped_refptr<rtc::RefCountedObject<PooledI420Buffer>>
+FrameBufferPool::CreateI420Buffer(int width, int height) noexcept {
+  PooledMemory data = Acquire(PooledI420Buffer::ByteSize(width, height));
+  return new rtc::RefCountedObject<PooledI420Buffer>(width, height,
+                                                     std::move(data));
+}
+
+void FrameBufferPool::Release(uint8_t* ptr, size_t capacity) noexcept {
+  outstanding_count_.fetch_sub(1, std::memory_order_relaxed);
+  {
+    auto lock = std::scoped_lock{mutex_};
+    if (cached_bytes_ + capacity <= kMaxCachedBytes) {
+      std::vector<uint8_t*>& blocks = free_blocks_[capacity];
+      if (blocks.size() < kMaxFreeBlocksPerBucket) {
+        if (blocks.capacity() == 0) {
+          blocks.reserve(kMaxFreeBlocksPerBucket);
+        }
+        blocks.push_back(ptr);
+        cached_bytes_ += capacity;
+        recycle_count_.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+    }
+  }
+  discard_count_.fetch_add(1, std::memory_order_relaxed);
+  webrtc::AlignedFree(ptr);
+}
+
+void FrameBufferPool::Trim() noexcept {
+  std::unordered_map<size_t, std::vector<uint8_t*>> free_blocks;
+  {
+    auto lock = std::scoped_lock{mutex_};
+    free_blocks.swap(free_blocks_);
+    cached_bytes_ = 0;
+  }
+  for (auto&& pair : free_blocks) {
+    for (uint8_t* ptr : pair.second) {
+      webrtc::AlignedFree(ptr);
+    }
+  }
+}
+
+FrameBufferPoolStats FrameBufferPool::GetStats() const noexcept {
+  FrameBufferPoolStats stats;
+  stats.hit_count = hit_count_.load(std::memory_order_relaxed);
+  stats.miss_count = miss_count_.load(std::memory_order_relaxed);
+  stats.recycle_count = recycle_count_.load(std::memory_order_relaxed);
+  stats.discard_count = discard_count_.load(std::memory_order_relaxed);
+  stats.outstanding_count = outstanding_count_.load(std::memory_order_relaxed);
+  {
+    auto lock = std::scoped_lock{mutex_};
+    stats.cached_bytes = cached_bytes_;
+  }
+  return stats;
+}
+
+}  // namespace Microsoft::MixedReality::WebRTC
@@ -0,0 +1,165 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "api/video/video_frame_buffer.h"
+#include "rtc_base/refcountedobject.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace Microsoft::MixedReality::WebRTC {
+
+class FrameBufferPool;
+
+/// Deleter returning a memory block to the pool it was acquired from, instead
+/// of deallocating it.
+struct PooledMemoryDeleter {
+  /// Pool the memory block was acquired from.
+  FrameBufferPool* pool_{};
+
+  /// Capacity of the memory block, in bytes. This is the size of the bucket the
+  /// block belongs to, which can be larger than the size requested on acquire.
+  size_t capacity_{};
+
+  void operator()(uint8_t* ptr) const noexcept;
+};
+
+/// Block of raw memory acquired from a |FrameBufferPool|. The block is returned
+/// to its pool when the pointer is destroyed.
+using PooledMemory = std::unique_ptr<uint8_t, PooledMemoryDeleter>;
+
+/// Snapshot of the statistics of a |FrameBufferPool|.
+struct FrameBufferPoolStats {
+  /// Number of acquire requests served from a cached memory block.
+  uint64_t hit_count{0};
+
+  /// Number of acquire requests which needed a new allocation.
+  uint64_t miss_count{0};
+
+  /// Number of memory blocks returned to the pool and cached for reuse.
+  uint64_t recycle_count{0};
+
+  /// Number of memory blocks returned to the pool but deallocated, because the
+  /// pool already reached its caching limits.
+  uint64_t discard_count{0};
+
+  /// Number of memory blocks currently acquired and not yet returned.
+  uint64_t outstanding_count{0};
+
+  /// Total size in bytes of the memory blocks currently cached for reuse.
+  uint64_t cached_bytes{0};
+};
+
+/// I420 buffer whose three planes are stored contiguously in a single memory
+/// block acquired from a |FrameBufferPool|. This is the pooled equivalent of
+/// webrtc::I420Buffer, with the same plane layout.
+class PooledI420Buffer : public webrtc::I420BufferInterface {
+ public:
+  // VideoFrameBuffer implementation.
+  int width() const override { return width_; }
+  int height() const override { return height_; }
+
+  // PlanarYuvBuffer implementation.
+  const uint8_t* DataY() const override { return data_.get(); }
+  const uint8_t* DataU() const override {
+    return data_.get() + static_cast<size_t>(stride_y_) * height_;
+  }
+  const uint8_t* DataV() const override {
+    return DataU() + static_cast<size_t>(stride_uv_) * ((height_ + 1) / 2);
+  }
+  int StrideY() const override { return stride_y_; }
+  int StrideU() const override { return stride_uv_; }
+  int StrideV() const override { return stride_uv_; }
+
+  uint8_t* MutableDataY() { return const_cast<uint8_t*>(DataY()); }
+  uint8_t* MutableDataU() { return const_cast<uint8_t*>(DataU()); }
+  uint8_t* MutableDataV() { return const_cast<uint8_t*>(DataV()); }
+
+  /// Size in bytes of the memory block needed to store an I420 frame of the
+  /// given dimensions, with the default stride layout.
+  static size_t ByteSize(int width, int height) noexcept;
+
+ protected:
+  friend class FrameBufferPool;
+  PooledI420Buffer(int width, int height, PooledMemory data) noexcept;
+  ~PooledI420Buffer() override = default;
+
+ private:
+  const int width_;
+  const int height_;
+  const int stride_y_;
+  const int stride_uv_;
+  const PooledMemory data_;
+};
+
+/// Thread-safe pool of raw memory blocks for video frame buffers.
+///
+/// Memory blocks are grouped in buckets by capacity, such that frames of the
+/// same resolution (or of close resolutions) reuse the same blocks. Blocks are
+/// acquired by frame buffers and automatically returned to the pool when the
+/// last reference to the frame buffer is released, which can happen on any
+/// thread. The pool keeps a bounded number of free blocks per bucket, and a
+/// bounded total amount of cached memory, beyond which returned blocks are
+/// deallocated.
+class FrameBufferPool {
+ public:
+  /// Get the global pool instance shared by all video objects.
+  /// The global pool is never destroyed, since frame buffers can be released
+  /// by the WebRTC threads at any time, including during static destruction.
+  /// Call |Trim()| to release the cached memory once the library shuts down.
+  static FrameBufferPool& Instance() noexcept;
+
+  FrameBufferPool() noexcept = default;
+  ~FrameBufferPool() noexcept;
+
+  /// Acquire a block of memory of at least |size| bytes, aligned for SIMD
+  /// access. The block is returned to the pool when the returned pointer is
+  /// destroyed.
+  PooledMemory Acquire(size_t size) noexcept;
+
+  /// Create a new I420 frame buffer backed by pooled memory.
+  rtc::scoped_refptr<rtc::RefCountedObject<PooledI420Buffer>> CreateI420Buffer(
+      int width,
+      int height) noexcept;
+
+  /// Deallocate all cached memory blocks. Blocks currently acquired are not
+  /// affected, and will be cached again when returned.
+  void Trim() noexcept;
+
+  /// Get a snapshot of the pool statistics.
+  FrameBufferPoolStats GetStats() const noexcept;
+
+  /// Compute the capacity of the bucket serving a request of |size| bytes.
+  static size_t GetBucketCapacity(size_t size) noexcept;
+
+ protected:
+  friend struct PooledMemoryDeleter;
+
+  /// Return to the pool a memory block previously acquired with |Acquire()|.
+  void Release(uint8_t* ptr, size_t capacity) noexcept;
+
+ private:
+  /// Collection of free memory blocks, indexed by bucket capacity.
+  std::unordered_map<size_t, std::vector<uint8_t*>> free_blocks_
+      RTC_GUARDED_BY(mutex_);
+
+  /// Total size of all blocks in |free_blocks_|, in bytes.
+  size_t cached_bytes_ RTC_GUARDED_BY(mutex_){0};
+
+  /// Mutex protecting the collection of free memory blocks.
+  mutable std::mutex mutex_;
+
+  std::atomic_uint64_t hit_count_{0};
+  std::atomic_uint64_t miss_count_{0};
+  std::atomic_uint64_t recycle_count_{0};
+  std::atomic_uint64_t discard_count_{0};
+  std::atomic_uint64_t outstanding_count_{0};
+};
+
+}  // namespace Microsoft::MixedReality::WebRTC
@@ -0,0 +1,120 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+// This is a precompiled header, it must be on its own, followed by a blank
+// line, to prevent clang-format from reordering it with other headers.
+#include "pch.h"
+
+#include "audio_read_buffer.h"
+#include "audio_read_buffer_interop.h"
+
+using namespace Microsoft::MixedReality::WebRTC;
+
+void MRS_CALL mrsAudioReadBufferAddRef(AudioReadBufferHandle handle) noexcept {
+  if (auto buffer = static_cast<AudioReadBuffer*>(handle)) {
+    buffer->AddRef();
+  } else {
+    RTC_LOG(LS_WARNING)
+        << "Trying to add reference to NULL AudioReadBuffer object.";
+  }
+}
+
+void MRS_CALL
+mrsAudioReadBufferRemoveRef(AudioReadBufferHandle handle) noexcept {
+  if (auto buffer = static_cast<AudioReadBuffer*>(handle)) {
+    buffer->RemoveRef();
+  } else {
+    RTC_LOG(LS_WARNING)
+        << "Trying to remove reference from NULL AudioReadBuffer object.";
+  }
+}
+
+mrsResult MRS_CALL
+mrsAudioReadBufferCreate(const mrsAudioReadBufferConfig* config,
+                         AudioReadBufferHandle* handle_out) noexcept {
+  if (!handle_out) {
+    return Result::kInvalidParameter;
+  }
+  *handle_out = nullptr;
+  if (!config) {
+    return Result::kInvalidParameter;
+  }
+  AudioReadBufferConfig buffer_config;
+  buffer_config.capacity_ms_ = config->capacity_ms;
+  buffer_config.silence_fill_ = (config->silence_fill != mrsBool::kFalse);
+  buffer_config.channel_count_ = config->channel_count;
+  RefPtr<AudioReadBuffer> buffer = AudioReadBuffer::Create(buffer_config);
+  if (!buffer) {
+    return Result::kInvalidParameter;
+  }
+  *handle_out = buffer.release();
+  return Result::kSuccess;
+}
+
+mrsResult MRS_CALL
+mrsAudioReadBufferGetFormat(AudioReadBufferHandle handle,
+                            uint32_t* sampling_rate_hz,
+                            uint32_t* channel_count) noexcept {
+  auto buffer = static_cast<AudioReadBuffer*>(handle);
+  if (!buffer) {
+    return Result::kInvalidNativeHandle;
+  }
+  if (!sampling_rate_hz || !channel_count) {
+    return Result::kInvalidParameter;
+  }
+  if (!buffer->GetFormat(*sampling_rate_hz, *channel_count)) {
+    return Result::kInvalidOperation;
+  }
+  return Result::kSuccess;
+}
+
+mrsResult MRS_CALL mrsAudioReadBufferRead(AudioReadBufferHandle handle,
+                                          int16_t* data,
+                                          uint32_t sample_count,
+                                          uint32_t* read_count_out) noexcept {
+  auto buffer = static_cast<AudioReadBuffer*>(handle);
+  if (!buffer) {
+    return Result::kInvalidNativeHandle;
+  }
+  if (!data || !read_count_out) {
+    return Result::kInvalidParameter;
+  }
+  *read_count_out = buffer->Read(data, sample_count);
+  return Result::kSuccess;
+}
+
+mrsResult MRS_CALL
+mrsAudioReadBufferGetAvailableSampleCount(AudioReadBufferHandle handle,
+                                          uint32_t* sample_count) noexcept {
+  auto buffer = static_cast<AudioReadBuffer*>(handle);
+  if (!buffer) {
+    return Result::kInvalidNativeHandle;
+  }
+  if (!sample_count) {
+    return Result::kInvalidParameter;
+  }
+  *sample_count = buffer->GetAvailableSampleCount();
+  return Result::kSuccess;
+}
+
+mrsResult MRS_CALL
+mrsAudioReadBufferGetStats(AudioReadBufferHandle handle,
+                           mrsAudioReadBufferStats* stats) noexcept {
+  auto buffer = static_cast<AudioReadBuffer*>(handle);
+  if (!buffer) {
+    return Result::kInvalidNativeHandle;
+  }
+  if (!stats) {
+    return Result::kInvalidParameter;
+  }
+  const AudioReadBufferStats buffer_stats = buffer->GetStats();
+  stats->available_sample_count = buffer_stats.available_sample_count_;
+  stats->written_sample_count = buffer_stats.written_sample_count_;
+  stats->read_sample_count = buffer_stats.read_sample_count_;
+  stats->overrun_count = buffer_stats.overrun_count_;
+  stats->dropped_sample_count = buffer_stats.dropped_sample_count_;
+  stats->underrun_count = buffer_stats.underrun_count_;
+  stats->missing_sample_count = buffer_stats.missing_sample_count_;
+  stats->format_mismatch_count = buffer_stats.format_mismatch_count_;
+  return Result::kSuccess;
+}
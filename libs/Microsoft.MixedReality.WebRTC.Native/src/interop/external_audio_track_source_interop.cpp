@@ -0,0 +1,175 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+// This is a precompiled header, it must be on its own, followed by a blank
+// line, to prevent clang-format from reordering it with other headers.
+#include "pch.h"
+
+#include "callback.h"
+#include "media/external_audio_track_source.h"
+#include "external_audio_track_source_interop.h"
+
+using namespace Microsoft::MixedReality::WebRTC;
+
+namespace {
+
+/// Convert an interop source configuration.
+ExternalAudioTrackSourceConfig ToConfig(
+    const mrsExternalAudioTrackSourceConfig& config) {
+  ExternalAudioTrackSourceConfig out;
+  out.sampling_rate_hz_ = config.sampling_rate_hz;
+  out.channel_count_ = config.channel_count;
+  out.jitter_buffer_ms_ = config.jitter_buffer_ms;
+  out.capacity_ms_ = config.capacity_ms;
+  return out;
+}
+
+/// Adapter for an interop-based custom audio source.
+struct InteropAudioSource : ExternalAudioSource {
+  using callback_type = RetCallback<uint32_t,
+                                    ExternalAudioTrackSourceHandle,
+                                    int64_t,
+                                    int16_t*,
+                                    uint32_t>;
+
+  /// Interop callback to generate audio.
+  callback_type callback_;
+
+  InteropAudioSource(mrsRequestExternalAudioFrameCallback callback,
+                     void* user_data)
+      : callback_({callback, user_data}) {}
+
+  uint32_t FrameRequested(AudioFrameRequest& frame_request) override {
+    // The request references the track source, so this adapter does not need
+    // to keep it alive.
+    return callback_(&frame_request.track_source_, frame_request.timestamp_ms_,
+                     frame_request.data_, frame_request.sample_count_);
+  }
+};
+
+}  // namespace
+
+void MRS_CALL mrsExternalAudioTrackSourceAddRef(
+    ExternalAudioTrackSourceHandle handle) noexcept {
+  if (auto track = static_cast<ExternalAudioTrackSource*>(handle)) {
+    track->AddRef();
+  } else {
+    RTC_LOG(LS_WARNING)
+        << "Trying to add reference to NULL ExternalAudioTrackSource object.";
+  }
+}
+
+void MRS_CALL mrsExternalAudioTrackSourceRemoveRef(
+    ExternalAudioTrackSourceHandle handle) noexcept {
+  if (auto track = static_cast<ExternalAudioTrackSource*>(handle)) {
+    track->RemoveRef();
+  } else {
+    RTC_LOG(LS_WARNING) << "Trying to remove reference from NULL "
+                           "ExternalAudioTrackSource object.";
+  }
+}
+
+mrsResult MRS_CALL mrsExternalAudioTrackSourceCreateFromCallback(
+    const mrsExternalAudioTrackSourceConfig* config,
+    mrsRequestExternalAudioFrameCallback callback,
+    void* user_data,
+    ExternalAudioTrackSourceHandle* source_handle_out) noexcept {
+  if (!source_handle_out || !config || !callback) {
+    return Result::kInvalidParameter;
+  }
+  *source_handle_out = nullptr;
+  const ExternalAudioTrackSourceConfig source_config = ToConfig(*config);
+  if (ExternalAudioTrackSource::ValidateConfig(source_config) !=
+      Result::kSuccess) {
+    return Result::kInvalidParameter;
+  }
+  RefPtr<ExternalAudioTrackSource> track_source =
+      detail::ExternalAudioTrackSourceCreateFromCallback(source_config,
+                                                         callback, user_data);
+  if (!track_source) {
+    return Result::kUnknownError;
+  }
+  *source_handle_out = track_source.release();
+  return Result::kSuccess;
+}
+
+mrsResult MRS_CALL mrsExternalAudioTrackSourceCreatePushMode(
+    const mrsExternalAudioTrackSourceConfig* config,
+    ExternalAudioTrackSourceHandle* source_handle_out) noexcept {
+  if (!source_handle_out || !config) {
+    return Result::kInvalidParameter;
+  }
+  *source_handle_out = nullptr;
+  const ExternalAudioTrackSourceConfig source_config = ToConfig(*config);
+  if (ExternalAudioTrackSource::ValidateConfig(source_config) !=
+      Result::kSuccess) {
+    return Result::kInvalidParameter;
+  }
+  RefPtr<ExternalAudioTrackSource> track_source =
+      ExternalAudioTrackSource::createPushMode(source_config);
+  if (!track_source) {
+    return Result::kUnknownError;
+  }
+  *source_handle_out = track_source.release();
+  return Result::kSuccess;
+}
+
+mrsResult MRS_CALL
+mrsExternalAudioTrackSourceSubmitFrame(ExternalAudioTrackSourceHandle handle,
+                                       const mrsAudioFrame* frame,
+                                       int64_t timestamp_ms) noexcept {
+  if (!frame) {
+    return Result::kInvalidParameter;
+  }
+  if (auto track = static_cast<ExternalAudioTrackSource*>(handle)) {
+    return track->SubmitFrame(*frame, timestamp_ms);
+  }
+  return mrsResult::kInvalidNativeHandle;
+}
+
+mrsResult MRS_CALL mrsExternalAudioTrackSourceGetStats(
+    ExternalAudioTrackSourceHandle handle,
+    mrsExternalAudioTrackSourceStats* stats) noexcept {
+  if (!stats) {
+    return Result::kInvalidParameter;
+  }
+  if (auto track = static_cast<ExternalAudioTrackSource*>(handle)) {
+    const ExternalAudioTrackSourceStats source_stats = track->GetStats();
+    stats->frame_count = source_stats.frame_count;
+    stats->skipped_frame_count = source_stats.pacing.skipped_count;
+    stats->mean_jitter_us = source_stats.pacing.mean_jitter_us;
+    stats->max_jitter_us = source_stats.pacing.max_jitter_us;
+    stats->silence_frame_count = source_stats.silence_frame_count;
+    stats->underrun_count = source_stats.underrun_count;
+    stats->overrun_sample_count = source_stats.overrun_sample_count;
+    stats->buffered_sample_count = source_stats.buffered_sample_count;
+    stats->gap_count = source_stats.gap_count;
+    stats->inserted_sample_count = source_stats.inserted_sample_count;
+    stats->overlap_count = source_stats.overlap_count;
+    stats->overlap_sample_count = source_stats.overlap_sample_count;
+    stats->drift_sample_count = source_stats.drift_sample_count;
+    return Result::kSuccess;
+  }
+  return mrsResult::kInvalidNativeHandle;
+}
+
+void MRS_CALL mrsExternalAudioTrackSourceShutdown(
+    ExternalAudioTrackSourceHandle handle) noexcept {
+  if (auto track = static_cast<ExternalAudioTrackSource*>(handle)) {
+    track->Shutdown();
+  }
+}
+
+namespace Microsoft::MixedReality::WebRTC::detail {
+
+RefPtr<ExternalAudioTrackSource> ExternalAudioTrackSourceCreateFromCallback(
+    const ExternalAudioTrackSourceConfig& config,
+    mrsRequestExternalAudioFrameCallback callback,
+    void* user_data) {
+  RefPtr<InteropAudioSource> custom_source =
+      new InteropAudioSource(callback, user_data);
+  return ExternalAudioTrackSource::createFromSource(std::move(custom_source),
+                                                    config);
+}
+
+}  // namespace Microsoft::MixedReality::WebRTC::detail
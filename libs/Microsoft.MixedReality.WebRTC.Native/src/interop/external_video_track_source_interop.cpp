@@ -6,6 +6,7 @@
 #include "pch.h"
 
 #include "callback.h"
+#include "media/capture_scheduler.h"
 #include "media/external_video_track_source.h"
 #include "external_video_track_source_interop.h"
 
@@ -65,6 +66,21 @@ mrsResult MRS_CALL mrsExternalVideoTrackSourceCreateFromArgb32Callback(
   return Result::kSuccess;
 }
 
+mrsResult MRS_CALL mrsExternalVideoTrackSourceCreatePushMode(
+    ExternalVideoTrackSourceHandle* source_handle_out) noexcept {
+  if (!source_handle_out) {
+    return Result::kInvalidParameter;
+  }
+  *source_handle_out = nullptr;
+  RefPtr<ExternalVideoTrackSource> track_source =
+      ExternalVideoTrackSource::createPushMode();
+  if (!track_source) {
+    return Result::kUnknownError;
+  }
+  *source_handle_out = track_source.release();
+  return Result::kSuccess;
+}
+
 mrsResult MRS_CALL mrsExternalVideoTrackSourceCompleteI420AFrameRequest(
     ExternalVideoTrackSourceHandle handle,
     uint32_t request_id,
@@ -93,6 +109,142 @@ mrsResult MRS_CALL mrsExternalVideoTrackSourceCompleteArgb32FrameRequest(
   return mrsResult::kInvalidNativeHandle;
 }
 
+mrsResult MRS_CALL
+mrsExternalVideoTrackSourceCompleteI420AFrameRequestZeroCopy(
+    ExternalVideoTrackSourceHandle handle,
+    uint32_t request_id,
+    int64_t timestamp_ms,
+    const mrsI420AVideoFrame* frame_view,
+    mrsExternalVideoFrameReleasedCallback release_callback,
+    void* release_user_data) noexcept {
+  const VideoFrameReleasedCallback released{release_callback,
+                                            release_user_data};
+  if (!frame_view) {
+    released();
+    return Result::kInvalidParameter;
+  }
+  if (auto track = static_cast<ExternalVideoTrackSource*>(handle)) {
+    return track->CompleteRequest(request_id, timestamp_ms, *frame_view,
+                                  released);
+  }
+  released();
+  return mrsResult::kInvalidNativeHandle;
+}
+
+mrsResult MRS_CALL mrsExternalVideoTrackSourceSubmitI420AFrame(
+    ExternalVideoTrackSourceHandle handle,
+    const mrsI420AVideoFrame* frame_view) noexcept {
+  if (!frame_view) {
+    return Result::kInvalidParameter;
+  }
+  if (auto track = static_cast<ExternalVideoTrackSource*>(handle)) {
+    return track->SubmitFrame(*frame_view);
+  }
+  return mrsResult::kInvalidNativeHandle;
+}
+
+mrsResult MRS_CALL mrsExternalVideoTrackSourceSubmitI420AFrameZeroCopy(
+    ExternalVideoTrackSourceHandle handle,
+    const mrsI420AVideoFrame* frame_view,
+    mrsExternalVideoFrameReleasedCallback release_callback,
+    void* release_user_data) noexcept {
+  const VideoFrameReleasedCallback released{release_callback,
+                                            release_user_data};
+  if (!frame_view) {
+    released();
+    return Result::kInvalidParameter;
+  }
+  if (auto track = static_cast<ExternalVideoTrackSource*>(handle)) {
+    return track->SubmitFrame(*frame_view, released);
+  }
+  released();
+  return mrsResult::kInvalidNativeHandle;
+}
+
+mrsResult MRS_CALL mrsExternalVideoTrackSourceSubmitArgb32Frame(
+    ExternalVideoTrackSourceHandle handle,
+    const mrsArgb32VideoFrame* frame_view) noexcept {
+  if (!frame_view) {
+    return Result::kInvalidParameter;
+  }
+  if (auto track = static_cast<ExternalVideoTrackSource*>(handle)) {
+    return track->SubmitFrame(*frame_view);
+  }
+  return mrsResult::kInvalidNativeHandle;
+}
+
+mrsResult MRS_CALL
+mrsExternalVideoTrackSourceSetOddSizeMode(ExternalVideoTrackSourceHandle handle,
+                                          mrsOddSizeMode mode) noexcept {
+  switch (mode) {
+    case mrsOddSizeMode::kCrop:
+    case mrsOddSizeMode::kPad:
+      break;
+    default:
+      return Result::kInvalidParameter;
+  }
+  if (auto track = static_cast<ExternalVideoTrackSource*>(handle)) {
+    track->SetOddSizeMode((OddSizeMode)mode);
+    return Result::kSuccess;
+  }
+  return mrsResult::kInvalidNativeHandle;
+}
+
+mrsResult MRS_CALL
+mrsExternalVideoTrackSourceSetFramerate(ExternalVideoTrackSourceHandle handle,
+                                        double framerate) noexcept {
+  if (auto track = static_cast<ExternalVideoTrackSource*>(handle)) {
+    return track->SetFramerate(framerate);
+  }
+  return mrsResult::kInvalidNativeHandle;
+}
+
+mrsResult MRS_CALL mrsExternalVideoTrackSourceGetStats(
+    ExternalVideoTrackSourceHandle handle,
+    mrsExternalVideoTrackSourceStats* stats) noexcept {
+  if (!stats) {
+    return Result::kInvalidParameter;
+  }
+  if (auto track = static_cast<ExternalVideoTrackSource*>(handle)) {
+    const FramePacerStats pacing = track->GetPacingStats();
+    stats->framerate = pacing.framerate;
+    stats->request_count = pacing.tick_count;
+    stats->skipped_request_count = pacing.skipped_count;
+    stats->mean_jitter_us = pacing.mean_jitter_us;
+    stats->max_jitter_us = pacing.max_jitter_us;
+    stats->last_jitter_us = pacing.last_jitter_us;
+    const FrameRequestStats requests = track->GetRequestStats();
+    stats->outstanding_request_count = requests.outstanding_count;
+    stats->completed_request_count = requests.completed_count;
+    stats->expired_request_count = requests.expired_count;
+    stats->rejected_request_count = requests.rejected_count;
+    const I420BufferCacheStats buffers = track->GetBufferCacheStats();
+    stats->frame_width = buffers.width;
+    stats->frame_height = buffers.height;
+    stats->buffer_reuse_count = buffers.reuse_count;
+    stats->buffer_allocation_count = buffers.allocation_count;
+    stats->reconfiguration_count = buffers.reconfiguration_count;
+    return Result::kSuccess;
+  }
+  return mrsResult::kInvalidNativeHandle;
+}
+
+mrsResult MRS_CALL
+mrsSetExternalVideoTrackSourceThreadCount(int32_t thread_count) noexcept {
+  if ((thread_count < 1) ||
+      (thread_count > CaptureScheduler::kMaxWorkerCount)) {
+    return Result::kInvalidParameter;
+  }
+  if (!CaptureScheduler::Instance().SetWorkerCount(thread_count)) {
+    return Result::kInvalidOperation;
+  }
+  return Result::kSuccess;
+}
+
+int32_t MRS_CALL mrsGetExternalVideoTrackSourceThreadCount() noexcept {
+  return CaptureScheduler::Instance().GetWorkerCount();
+}
+
 void MRS_CALL mrsExternalVideoTrackSourceShutdown(
     ExternalVideoTrackSourceHandle handle) noexcept {
   if (auto track = static_cast<ExternalVideoTrackSource*>(handle)) {
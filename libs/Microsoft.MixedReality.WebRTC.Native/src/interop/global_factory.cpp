@@ -5,9 +5,14 @@
 // line, to prevent clang-format from reordering it with other headers.
 #include "pch.h"
 
+#include "data_send_buffer.h"
+#include "frame_buffer_pool.h"
 #include "interop/global_factory.h"
+#include "media/capture_scheduler.h"
+#include "media/local_audio_tap.h"
 #include "media/local_video_track.h"
 #include "peer_connection.h"
+#include "worker_pool.h"
 
 namespace {
 
@@ -26,8 +31,10 @@ std::string_view ObjectTypeToString(ObjectType type) {
   static_assert((int)ObjectType::kPeerConnection == 0, "");
   static_assert((int)ObjectType::kLocalVideoTrack == 1, "");
   static_assert((int)ObjectType::kExternalVideoTrackSource == 2, "");
+  static_assert((int)ObjectType::kExternalAudioTrackSource == 3, "");
   constexpr const std::string_view s_types[] = {
-      "PeerConnection", "LocalVideoTrack", "ExternalVideoTrackSource"};
+      "PeerConnection", "LocalVideoTrack", "ExternalVideoTrackSource",
+      "ExternalAudioTrackSource"};
   return s_types[(int)type];
 }
 
@@ -116,6 +123,32 @@ rtc::Thread* GlobalFactory::GetWorkerThread() noexcept {
 #endif  // defined(WINUWP)
 }
 
+rtc::Thread* GlobalFactory::GetSignalingThread() noexcept {
+  std::scoped_lock lock(mutex_);
+#if defined(WINUWP)
+  return impl_->signalingThread.get();
+#else   // defined(WINUWP)
+  return signaling_thread_.get();
+#endif  // defined(WINUWP)
+}
+
+void GlobalFactory::AddExternalAudioTrack(
+    webrtc::PeerConnectionInterface* peer) noexcept {
+  std::scoped_lock lock(external_audio_mutex_);
+  if (external_audio_track_count_++ == 0) {
+    peer->SetAudioRecording(false);
+  }
+}
+
+void GlobalFactory::RemoveExternalAudioTrack(
+    webrtc::PeerConnectionInterface* peer) noexcept {
+  std::scoped_lock lock(external_audio_mutex_);
+  RTC_DCHECK_GT(external_audio_track_count_, 0);
+  if (--external_audio_track_count_ == 0) {
+    peer->SetAudioRecording(true);
+  }
+}
+
 void GlobalFactory::AddObject(ObjectType type, TrackedObject* obj) noexcept {
   try {
     std::scoped_lock lock(mutex_);
@@ -225,6 +258,13 @@ mrsResult GlobalFactory::Initialize() {
                              signaling_thread_.get());
   signaling_thread_->Start();
 
+  // Tap the captured audio after processing, for the local audio callbacks
+  rtc::scoped_refptr<webrtc::AudioProcessing> audio_processing =
+      webrtc::AudioProcessingBuilder()
+          .SetCapturePostProcessing(
+              LocalAudioTap::Instance().CreateCaptureProcessing())
+          .Create();
+
   factory_ = webrtc::CreatePeerConnectionFactory(
       network_thread_.get(), worker_thread_.get(), signaling_thread_.get(),
       nullptr, webrtc::CreateBuiltinAudioEncoderFactory(),
@@ -235,7 +275,7 @@ mrsResult GlobalFactory::Initialize() {
       std::unique_ptr<webrtc::VideoDecoderFactory>(
           new webrtc::MultiplexDecoderFactory(
               absl::make_unique<webrtc::InternalDecoderFactory>())),
-      nullptr, nullptr);
+      nullptr, std::move(audio_processing));
 #endif  // defined(WINUWP)
   return (factory_.get() != nullptr ? Result::kSuccess : Result::kUnknownError);
 }
@@ -249,6 +289,15 @@ void GlobalFactory::ShutdownNoLock() {
   worker_thread_.reset();
   signaling_thread_.reset();
 #endif  // defined(WINUWP)
+
+  // Once the WebRTC threads are stopped, no more frames are produced and no
+  // more messages are sent, so release the memory cached for recycling video
+  // frames and data channel messages, and the threads used to request and
+  // convert frames.
+  FrameBufferPool::Instance().Trim();
+  DataSendBufferPool::Instance().Trim();
+  CaptureScheduler::Instance().Shutdown();
+  WorkerPool::Instance().Shutdown();
 }
 
 }  // namespace Microsoft::MixedReality::WebRTC
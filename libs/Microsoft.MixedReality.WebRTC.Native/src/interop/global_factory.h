@@ -12,6 +12,7 @@ enum class ObjectType : int {
   kPeerConnection,
   kLocalVideoTrack,
   kExternalVideoTrackSource,
+  kExternalAudioTrackSource,
 };
 
 /// Global factory wrapper adding thread safety to all global objects, including
@@ -38,6 +39,9 @@ class GlobalFactory {
   /// Get the worker thread. This is only valid if initialized.
   rtc::Thread* GetWorkerThread() noexcept;
 
+  /// Get the signaling thread. This is only valid if initialized.
+  rtc::Thread* GetSignalingThread() noexcept;
+
   /// Add to the global factory collection an object whose lifetime must be
   /// tracked to know when it is safe to terminate the WebRTC threads. This is
   /// generally called form the object's constructor for safety.
@@ -47,6 +51,19 @@ class GlobalFactory {
   /// object's destructor for safety.
   void RemoveObject(ObjectType type, TrackedObject* obj) noexcept;
 
+  /// Record that an external audio track was added to |peer|. The audio device
+  /// module sends the recorded audio to every sending audio stream, including
+  /// the stream of an external track, so the recording from the audio capture
+  /// device is paused while at least one external audio track is added to any
+  /// peer connection. The recording state is shared by all the peer connections
+  /// of the process, so this also pauses their capture device tracks.
+  void AddExternalAudioTrack(webrtc::PeerConnectionInterface* peer) noexcept;
+
+  /// Record that an external audio track added with |AddExternalAudioTrack()|
+  /// was removed from |peer|, and resume the recording from the audio capture
+  /// device once no external audio track is left.
+  void RemoveExternalAudioTrack(webrtc::PeerConnectionInterface* peer) noexcept;
+
 #if defined(WINUWP)
   using WebRtcFactoryPtr =
       std::shared_ptr<wrapper::impl::org::webRtc::WebRtcFactory>;
@@ -73,6 +90,14 @@ class GlobalFactory {
   /// Collection of all objects alive.
   std::unordered_map<TrackedObject*, ObjectType> alive_objects_
       RTC_GUARDED_BY(mutex_);
+
+  /// Number of external audio tracks currently added to a peer connection.
+  int external_audio_track_count_ RTC_GUARDED_BY(external_audio_mutex_){0};
+
+  /// Mutex serializing the changes of the audio recording state. This is
+  /// distinct from |mutex_|, which the signaling thread can acquire while the
+  /// recording state change is proxied to it.
+  std::mutex external_audio_mutex_;
 };
 
 }  // namespace Microsoft::MixedReality::WebRTC
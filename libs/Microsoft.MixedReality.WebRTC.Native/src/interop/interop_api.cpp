@@ -8,14 +8,18 @@
 #include "api/stats/rtcstats_objects.h"
 
 #include "data_channel.h"
+#include "data_send_buffer.h"
 #include "external_video_track_source_interop.h"
+#include "frame_buffer_pool.h"
 #include "interop/global_factory.h"
 #include "interop_api.h"
 #include "peer_connection_interop.h"
 #include "media/local_video_track.h"
+#include "media/external_audio_track_source_impl.h"
 #include "media/external_video_track_source_impl.h"
 #include "peer_connection.h"
 #include "sdp_utils.h"
+#include "video_conversion.h"
 
 using namespace Microsoft::MixedReality::WebRTC;
 
@@ -262,6 +266,49 @@ std::vector<std::string> SplitString(const std::string& str, char sep) {
   return ret;
 }
 
+/// Convert an interop video frame delivery configuration. Return |false| if the
+/// configuration is not valid.
+bool ToVideoFrameDeliveryConfig(const mrsVideoFrameDeliveryConfig& config,
+                                VideoFrameDeliveryConfig& delivery_config) {
+  switch (config.drop_policy) {
+    case mrsVideoFrameDropPolicy::kDropOldest:
+    case mrsVideoFrameDropPolicy::kDropNewest:
+    case mrsVideoFrameDropPolicy::kKeepLatest:
+      break;
+    default:
+      return false;
+  }
+  delivery_config.async_ = (config.async != mrsBool::kFalse);
+  delivery_config.queue_capacity_ = config.queue_capacity;
+  delivery_config.drop_policy_ = (VideoFrameDropPolicy)config.drop_policy;
+  return true;
+}
+
+/// Convert video frame delivery statistics to their interop counterpart.
+void FromVideoFrameDeliveryStats(const VideoFrameDeliveryStats& delivery_stats,
+                                 mrsVideoFrameDeliveryStats& stats) {
+  stats.delivered_count = delivery_stats.delivered_count_;
+  stats.dropped_count = delivery_stats.dropped_count_;
+  stats.queue_size = delivery_stats.queue_size_;
+  stats.latency_p50_us = delivery_stats.latency_p50_us_;
+  stats.latency_p90_us = delivery_stats.latency_p90_us_;
+  stats.latency_p99_us = delivery_stats.latency_p99_us_;
+}
+
+/// Convert an interop audio output format, if any, to its native counterpart.
+std::optional<AudioOutputFormat> ToAudioOutputFormat(
+    const mrsAudioOutputFormat* format) {
+  if (!format) {
+    return {};
+  }
+  AudioOutputFormat output_format;
+  output_format.sample_format_ = format->sample_format;
+  output_format.sample_layout_ = format->sample_layout;
+  output_format.sampling_rate_hz_ = format->sampling_rate_hz;
+  output_format.channel_count_ = format->channel_count;
+  return output_format;
+}
+
 /// Convert a WebRTC VideoType format into its FOURCC counterpart.
 uint32_t FourCCFromVideoType(webrtc::VideoType videoType) {
   switch (videoType) {
@@ -678,6 +725,131 @@ void MRS_CALL mrsPeerConnectionRegisterArgb32RemoteVideoFrameCallback(
   }
 }
 
+void MRS_CALL mrsPeerConnectionRegisterNv12RemoteVideoFrameCallback(
+    PeerConnectionHandle peerHandle,
+    PeerConnectionNv12VideoFrameCallback callback,
+    void* user_data) noexcept {
+  if (auto peer = static_cast<PeerConnection*>(peerHandle)) {
+    peer->RegisterRemoteVideoFrameCallback(
+        Nv12FrameReadyCallback{callback, user_data});
+  }
+}
+
+void MRS_CALL mrsPeerConnectionRegisterRgba32RemoteVideoFrameCallback(
+    PeerConnectionHandle peerHandle,
+    mrsBool premultiplied_alpha,
+    PeerConnectionRgba32VideoFrameCallback callback,
+    void* user_data) noexcept {
+  if (auto peer = static_cast<PeerConnection*>(peerHandle)) {
+    peer->RegisterRemoteVideoFrameCallback(Rgba32FrameReadyCallback{
+        {callback, user_data}, (premultiplied_alpha != mrsBool::kFalse)});
+  }
+}
+
+void MRS_CALL mrsPeerConnectionRegisterBgra32RemoteVideoFrameCallback(
+    PeerConnectionHandle peerHandle,
+    mrsBool premultiplied_alpha,
+    PeerConnectionBgra32VideoFrameCallback callback,
+    void* user_data) noexcept {
+  if (auto peer = static_cast<PeerConnection*>(peerHandle)) {
+    peer->RegisterRemoteVideoFrameCallback(Bgra32FrameReadyCallback{
+        {callback, user_data}, (premultiplied_alpha != mrsBool::kFalse)});
+  }
+}
+
+void MRS_CALL mrsPeerConnectionRegisterRemoteVideoFrameHandleCallback(
+    PeerConnectionHandle peerHandle,
+    PeerConnectionVideoFrameHandleCallback callback,
+    void* user_data) noexcept {
+  if (auto peer = static_cast<PeerConnection*>(peerHandle)) {
+    peer->RegisterRemoteVideoFrameCallback(
+        VideoFrameHandleReadyCallback{callback, user_data});
+  }
+}
+
+mrsResult MRS_CALL mrsPeerConnectionSetRemoteVideoFrameDeliveryConfig(
+    PeerConnectionHandle peerHandle,
+    const mrsVideoFrameDeliveryConfig* config) noexcept {
+  auto peer = static_cast<PeerConnection*>(peerHandle);
+  if (!peer) {
+    return Result::kInvalidNativeHandle;
+  }
+  VideoFrameDeliveryConfig delivery_config;
+  if (!config || !ToVideoFrameDeliveryConfig(*config, delivery_config)) {
+    return Result::kInvalidParameter;
+  }
+  return peer->SetRemoteVideoFrameDeliveryConfig(delivery_config);
+}
+
+mrsResult MRS_CALL mrsPeerConnectionGetRemoteVideoFrameDeliveryStats(
+    PeerConnectionHandle peerHandle,
+    mrsVideoFrameDeliveryStats* stats) noexcept {
+  auto peer = static_cast<PeerConnection*>(peerHandle);
+  if (!peer) {
+    return Result::kInvalidNativeHandle;
+  }
+  if (!stats) {
+    return Result::kInvalidParameter;
+  }
+  FromVideoFrameDeliveryStats(peer->GetRemoteVideoFrameDeliveryStats(),
+                              *stats);
+  return Result::kSuccess;
+}
+
+mrsResult MRS_CALL mrsPeerConnectionRegisterRemoteVideoTrackFrameCallback(
+    PeerConnectionHandle peerHandle,
+    const char* track_name,
+    PeerConnectionRemoteVideoTrackFrameCallback callback,
+    void* user_data) noexcept {
+  auto peer = static_cast<PeerConnection*>(peerHandle);
+  if (!peer) {
+    return Result::kInvalidNativeHandle;
+  }
+  if (IsStringNullOrEmpty(track_name)) {
+    return Result::kInvalidParameter;
+  }
+  peer->RegisterRemoteVideoTrackFrameCallback(
+      track_name, TrackVideoFrameHandleReadyCallback{callback, user_data});
+  return Result::kSuccess;
+}
+
+mrsResult MRS_CALL mrsPeerConnectionSetRemoteVideoTrackFrameDeliveryConfig(
+    PeerConnectionHandle peerHandle,
+    const char* track_name,
+    const mrsVideoFrameDeliveryConfig* config) noexcept {
+  auto peer = static_cast<PeerConnection*>(peerHandle);
+  if (!peer) {
+    return Result::kInvalidNativeHandle;
+  }
+  VideoFrameDeliveryConfig delivery_config;
+  if (IsStringNullOrEmpty(track_name) || !config ||
+      !ToVideoFrameDeliveryConfig(*config, delivery_config)) {
+    return Result::kInvalidParameter;
+  }
+  return peer->SetRemoteVideoTrackFrameDeliveryConfig(track_name,
+                                                      delivery_config);
+}
+
+mrsResult MRS_CALL mrsPeerConnectionGetRemoteVideoTrackFrameDeliveryStats(
+    PeerConnectionHandle peerHandle,
+    const char* track_name,
+    mrsVideoFrameDeliveryStats* stats) noexcept {
+  auto peer = static_cast<PeerConnection*>(peerHandle);
+  if (!peer) {
+    return Result::kInvalidNativeHandle;
+  }
+  if (IsStringNullOrEmpty(track_name) || !stats) {
+    return Result::kInvalidParameter;
+  }
+  VideoFrameDeliveryStats delivery_stats;
+  const Result result =
+      peer->GetRemoteVideoTrackFrameDeliveryStats(track_name, delivery_stats);
+  if (result == Result::kSuccess) {
+    FromVideoFrameDeliveryStats(delivery_stats, *stats);
+  }
+  return result;
+}
+
 void MRS_CALL mrsPeerConnectionRegisterLocalAudioFrameCallback(
     PeerConnectionHandle peerHandle,
     PeerConnectionAudioFrameCallback callback,
@@ -698,6 +870,64 @@ void MRS_CALL mrsPeerConnectionRegisterRemoteAudioFrameCallback(
   }
 }
 
+mrsResult MRS_CALL mrsPeerConnectionRegisterRemoteAudioTrackFrameCallback(
+    PeerConnectionHandle peerHandle,
+    const char* track_name,
+    PeerConnectionRemoteAudioTrackFrameCallback callback,
+    void* user_data) noexcept {
+  auto peer = static_cast<PeerConnection*>(peerHandle);
+  if (!peer) {
+    return Result::kInvalidNativeHandle;
+  }
+  if (IsStringNullOrEmpty(track_name)) {
+    return Result::kInvalidParameter;
+  }
+  peer->RegisterRemoteAudioTrackFrameCallback(
+      track_name, TrackAudioFrameReadyCallback{callback, user_data});
+  return Result::kSuccess;
+}
+
+mrsResult MRS_CALL mrsPeerConnectionSetRemoteAudioOutputFormat(
+    PeerConnectionHandle peerHandle,
+    const mrsAudioOutputFormat* format) noexcept {
+  auto peer = static_cast<PeerConnection*>(peerHandle);
+  if (!peer) {
+    return Result::kInvalidNativeHandle;
+  }
+  return peer->SetRemoteAudioOutputFormat(ToAudioOutputFormat(format));
+}
+
+mrsResult MRS_CALL mrsPeerConnectionSetRemoteAudioTrackOutputFormat(
+    PeerConnectionHandle peerHandle,
+    const char* track_name,
+    const mrsAudioOutputFormat* format) noexcept {
+  auto peer = static_cast<PeerConnection*>(peerHandle);
+  if (!peer) {
+    return Result::kInvalidNativeHandle;
+  }
+  if (IsStringNullOrEmpty(track_name)) {
+    return Result::kInvalidParameter;
+  }
+  return peer->SetRemoteAudioTrackOutputFormat(track_name,
+                                               ToAudioOutputFormat(format));
+}
+
+mrsResult MRS_CALL mrsPeerConnectionSetRemoteAudioTrackReadBuffer(
+    PeerConnectionHandle peerHandle,
+    const char* track_name,
+    AudioReadBufferHandle buffer_handle) noexcept {
+  auto peer = static_cast<PeerConnection*>(peerHandle);
+  if (!peer) {
+    return Result::kInvalidNativeHandle;
+  }
+  if (IsStringNullOrEmpty(track_name)) {
+    return Result::kInvalidParameter;
+  }
+  peer->SetRemoteAudioTrackReadBuffer(
+      track_name, static_cast<AudioReadBuffer*>(buffer_handle));
+  return Result::kSuccess;
+}
+
 mrsResult MRS_CALL mrsPeerConnectionAddLocalVideoTrack(
     PeerConnectionHandle peerHandle,
     const char* track_name,
@@ -861,6 +1091,36 @@ mrsPeerConnectionAddLocalAudioTrack(PeerConnectionHandle peerHandle) noexcept {
   return Result::kUnknownError;
 }
 
+mrsResult MRS_CALL mrsPeerConnectionAddLocalAudioTrackFromExternalSource(
+    PeerConnectionHandle peer_handle,
+    const char* track_name,
+    ExternalAudioTrackSourceHandle source_handle) noexcept {
+  auto peer = static_cast<PeerConnection*>(peer_handle);
+  if (!peer) {
+    return Result::kInvalidNativeHandle;
+  }
+  auto track_source =
+      static_cast<detail::ExternalAudioTrackSourceImpl*>(source_handle);
+  if (!track_source) {
+    return Result::kInvalidNativeHandle;
+  }
+  auto pc_factory = GlobalFactory::Instance()->GetExisting();
+  if (!pc_factory) {
+    return Result::kInvalidOperation;
+  }
+  const std::string track_name_str =
+      (IsStringNullOrEmpty(track_name) ? kLocalAudioLabel : track_name);
+  // The audio track keeps a reference to the audio source, like for video.
+  rtc::scoped_refptr<webrtc::AudioTrackInterface> audio_track =
+      pc_factory->CreateAudioTrack(track_name_str, track_source->impl());
+  if (!audio_track) {
+    return Result::kUnknownError;
+  }
+  return (peer->AddLocalAudioTrackFromExternalSource(std::move(audio_track))
+              ? Result::kSuccess
+              : Result::kUnknownError);
+}
+
 mrsResult MRS_CALL mrsPeerConnectionAddDataChannel(
     PeerConnectionHandle peerHandle,
     mrsDataChannelInteropHandle dataChannelInteropHandle,
@@ -968,6 +1228,191 @@ mrsDataChannelSendMessage(DataChannelHandle dataChannelHandle,
                                                  : Result::kUnknownError);
 }
 
+mrsResult MRS_CALL
+mrsDataChannelSendMessageBatch(DataChannelHandle dataChannelHandle,
+                               const void* const* messages,
+                               const uint64_t* sizes,
+                               uint32_t count,
+                               uint32_t* sent_count_out) noexcept {
+  if (!sent_count_out) {
+    return Result::kInvalidParameter;
+  }
+  *sent_count_out = 0;
+  auto data_channel = static_cast<DataChannel*>(dataChannelHandle);
+  if (!data_channel) {
+    return Result::kInvalidNativeHandle;
+  }
+  if ((count > 0) && (!messages || !sizes)) {
+    return Result::kInvalidParameter;
+  }
+  for (uint32_t i = 0; i < count; ++i) {
+    if ((!messages[i] && (sizes[i] > 0)) || (sizes[i] > SIZE_MAX)) {
+      return Result::kInvalidParameter;
+    }
+  }
+  const size_t sent_count = data_channel->SendBatch(messages, sizes, count);
+  *sent_count_out = static_cast<uint32_t>(sent_count);
+  return (sent_count == count ? Result::kSuccess : Result::kUnknownError);
+}
+
+mrsResult MRS_CALL
+mrsDataChannelEnableSendQueue(DataChannelHandle dataChannelHandle,
+                              const mrsDataChannelSendQueueConfig* config,
+                              mrsDataChannelBackpressureCallback callback,
+                              void* user_data) noexcept {
+  if (!config) {
+    return Result::kInvalidParameter;
+  }
+  auto data_channel = static_cast<DataChannel*>(dataChannelHandle);
+  if (!data_channel) {
+    return Result::kInvalidNativeHandle;
+  }
+  DataChannelSendQueueConfig queue_config;
+  queue_config.capacity_bytes_ = config->capacity_bytes;
+  queue_config.high_watermark_bytes_ = config->high_watermark_bytes;
+  queue_config.low_watermark_bytes_ = config->low_watermark_bytes;
+  return data_channel->EnableSendQueue(
+      queue_config, DataChannel::BackpressureCallback{callback, user_data});
+}
+
+mrsResult MRS_CALL
+mrsDataChannelGetSendQueueStats(DataChannelHandle dataChannelHandle,
+                                mrsDataChannelSendQueueStats* stats) noexcept {
+  if (!stats) {
+    return Result::kInvalidParameter;
+  }
+  auto data_channel = static_cast<DataChannel*>(dataChannelHandle);
+  if (!data_channel) {
+    return Result::kInvalidNativeHandle;
+  }
+  const DataChannelSendQueueStats queue_stats =
+      data_channel->GetSendQueueStats();
+  stats->queued_message_count = queue_stats.queued_message_count;
+  stats->queued_bytes = queue_stats.queued_bytes;
+  stats->rejected_message_count = queue_stats.rejected_message_count;
+  stats->discarded_message_count = queue_stats.discarded_message_count;
+  stats->backpressure =
+      (queue_stats.backpressure ? mrsBool::kTrue : mrsBool::kFalse);
+  return Result::kSuccess;
+}
+
+mrsResult MRS_CALL mrsDataChannelEnableFraming(
+    DataChannelHandle dataChannelHandle,
+    const mrsDataChannelFramingConfig* config) noexcept {
+  if (!config) {
+    return Result::kInvalidParameter;
+  }
+  auto data_channel = static_cast<DataChannel*>(dataChannelHandle);
+  if (!data_channel) {
+    return Result::kInvalidNativeHandle;
+  }
+  DataChannelFramingConfig framing_config;
+  framing_config.chunk_size_ = config->chunk_size;
+  framing_config.max_message_size_ = config->max_message_size;
+  framing_config.max_reassembly_size_ = config->max_reassembly_size;
+  return data_channel->EnableFraming(framing_config);
+}
+
+mrsResult MRS_CALL mrsDataChannelSetReceiveConfig(
+    DataChannelHandle dataChannelHandle,
+    const mrsDataChannelReceiveConfig* config,
+    mrsDataChannelMessageBatchCallback batch_callback,
+    void* user_data) noexcept {
+  if (!config) {
+    return Result::kInvalidParameter;
+  }
+  auto data_channel = static_cast<DataChannel*>(dataChannelHandle);
+  if (!data_channel) {
+    return Result::kInvalidNativeHandle;
+  }
+  DataChannelReceiveConfig receive_config;
+  receive_config.mode_ = (DataChannelReceiveMode)config->mode;
+  receive_config.queue_capacity_ = config->queue_capacity;
+  receive_config.max_batch_size_ = config->max_batch_size;
+  return data_channel->SetReceiveConfig(
+      receive_config,
+      DataChannel::MessageBatchCallback{batch_callback, user_data});
+}
+
+mrsResult MRS_CALL
+mrsDataChannelDispatchMessages(DataChannelHandle dataChannelHandle,
+                               uint32_t max_count,
+                               uint32_t* dispatched_count_out) noexcept {
+  if (!dispatched_count_out) {
+    return Result::kInvalidParameter;
+  }
+  *dispatched_count_out = 0;
+  auto data_channel = static_cast<DataChannel*>(dataChannelHandle);
+  if (!data_channel) {
+    return Result::kInvalidNativeHandle;
+  }
+  *dispatched_count_out = data_channel->DispatchMessages(max_count);
+  return Result::kSuccess;
+}
+
+mrsResult MRS_CALL
+mrsDataChannelGetReceiveStats(DataChannelHandle dataChannelHandle,
+                              mrsDataChannelReceiveStats* stats) noexcept {
+  if (!stats) {
+    return Result::kInvalidParameter;
+  }
+  auto data_channel = static_cast<DataChannel*>(dataChannelHandle);
+  if (!data_channel) {
+    return Result::kInvalidNativeHandle;
+  }
+  const DataChannelReceiveStats receive_stats =
+      data_channel->GetReceiveStats();
+  stats->delivered_message_count = receive_stats.delivered_message_count;
+  stats->dropped_message_count = receive_stats.dropped_message_count;
+  stats->queue_depth = receive_stats.queue_depth;
+  stats->max_queue_depth = receive_stats.max_queue_depth;
+  stats->latency_p50_us = receive_stats.latency_p50_us;
+  stats->latency_p90_us = receive_stats.latency_p90_us;
+  stats->latency_p99_us = receive_stats.latency_p99_us;
+  return Result::kSuccess;
+}
+
+mrsResult MRS_CALL
+mrsDataSendBufferAcquire(uint64_t size,
+                         DataSendBufferHandle* buffer_handle_out,
+                         void** data_out) noexcept {
+  if (!buffer_handle_out || !data_out) {
+    return Result::kInvalidParameter;
+  }
+  *buffer_handle_out = nullptr;
+  *data_out = nullptr;
+  if (size > SIZE_MAX) {
+    return Result::kInvalidParameter;
+  }
+  DataSendBuffer* const buffer =
+      DataSendBufferPool::Instance().Acquire((size_t)size);
+  *buffer_handle_out = buffer;
+  *data_out = buffer->data();
+  return Result::kSuccess;
+}
+
+void MRS_CALL
+mrsDataSendBufferRelease(DataSendBufferHandle buffer_handle) noexcept {
+  DataSendBufferPool::Instance().Release(
+      static_cast<DataSendBuffer*>(buffer_handle));
+}
+
+mrsResult MRS_CALL
+mrsDataChannelSendBuffer(DataChannelHandle dataChannelHandle,
+                         DataSendBufferHandle buffer_handle) noexcept {
+  auto buffer = static_cast<DataSendBuffer*>(buffer_handle);
+  if (!buffer) {
+    return Result::kInvalidNativeHandle;
+  }
+  auto data_channel = static_cast<DataChannel*>(dataChannelHandle);
+  const bool sent = (data_channel && data_channel->Send(buffer->buffer()));
+  DataSendBufferPool::Instance().Release(buffer);
+  if (!data_channel) {
+    return Result::kInvalidNativeHandle;
+  }
+  return (sent ? Result::kSuccess : Result::kUnknownError);
+}
+
 mrsResult MRS_CALL
 mrsPeerConnectionAddIceCandidate(PeerConnectionHandle peerHandle,
                                  const char* sdp,
@@ -1110,6 +1555,87 @@ void MRS_CALL mrsMemCpyStride(void* dst,
   }
 }
 
+void MRS_CALL
+mrsSetParallelVideoConversionMinPixelCount(int64_t pixel_count) noexcept {
+  SetParallelConversionMinPixelCount(pixel_count);
+}
+
+mrsResult MRS_CALL
+mrsConvertI420AVideoFrameToArgb32(const mrsI420AVideoFrame* frame,
+                                  void* argb32_data,
+                                  int32_t argb32_stride) noexcept {
+  if (!frame || !argb32_data || !frame->ydata_ || !frame->udata_ ||
+      !frame->vdata_) {
+    return Result::kInvalidParameter;
+  }
+  const int width = static_cast<int>(frame->width_);
+  const int height = static_cast<int>(frame->height_);
+  if ((width <= 0) || (height <= 0) || (argb32_stride < width * 4)) {
+    return Result::kInvalidParameter;
+  }
+  const uint8_t* const ydata = static_cast<const uint8_t*>(frame->ydata_);
+  const uint8_t* const udata = static_cast<const uint8_t*>(frame->udata_);
+  const uint8_t* const vdata = static_cast<const uint8_t*>(frame->vdata_);
+  uint8_t* const argb = static_cast<uint8_t*>(argb32_data);
+  if (frame->adata_) {
+    ConvertI420AlphaToArgb32(ydata, frame->ystride_, udata, frame->ustride_,
+                             vdata, frame->vstride_,
+                             static_cast<const uint8_t*>(frame->adata_),
+                             frame->astride_, argb, argb32_stride, width,
+                             height);
+  } else {
+    ConvertI420ToArgb32(ydata, frame->ystride_, udata, frame->ustride_, vdata,
+                        frame->vstride_, argb, argb32_stride, width, height);
+  }
+  return Result::kSuccess;
+}
+
+mrsResult MRS_CALL
+mrsConvertArgb32VideoFrameToI420(const mrsArgb32VideoFrame* frame,
+                                 void* ydata,
+                                 int32_t ystride,
+                                 void* udata,
+                                 int32_t ustride,
+                                 void* vdata,
+                                 int32_t vstride) noexcept {
+  if (!frame || !frame->argb32_data_ || !ydata || !udata || !vdata) {
+    return Result::kInvalidParameter;
+  }
+  const int width = static_cast<int>(frame->width_);
+  const int height = static_cast<int>(frame->height_);
+  const int chroma_width = (width + 1) / 2;
+  if ((width <= 0) || (height <= 0) || (frame->stride_ < width * 4) ||
+      (ystride < width) || (ustride < chroma_width) ||
+      (vstride < chroma_width)) {
+    return Result::kInvalidParameter;
+  }
+  ConvertArgb32ToI420(static_cast<const uint8_t*>(frame->argb32_data_),
+                      frame->stride_, static_cast<uint8_t*>(ydata), ystride,
+                      static_cast<uint8_t*>(udata), ustride,
+                      static_cast<uint8_t*>(vdata), vstride, width, height);
+  return Result::kSuccess;
+}
+
+mrsResult MRS_CALL
+mrsFrameBufferPoolGetStats(mrsFrameBufferPoolStats* stats) noexcept {
+  if (!stats) {
+    return Result::kInvalidParameter;
+  }
+  const FrameBufferPoolStats pool_stats =
+      FrameBufferPool::Instance().GetStats();
+  stats->hit_count = pool_stats.hit_count;
+  stats->miss_count = pool_stats.miss_count;
+  stats->recycle_count = pool_stats.recycle_count;
+  stats->discard_count = pool_stats.discard_count;
+  stats->outstanding_count = pool_stats.outstanding_count;
+  stats->cached_bytes = pool_stats.cached_bytes;
+  return Result::kSuccess;
+}
+
+void MRS_CALL mrsFrameBufferPoolTrim() noexcept {
+  FrameBufferPool::Instance().Trim();
+}
+
 namespace {
 template <class T>
 T& FindOrInsert(std::vector<std::pair<std::string, T>>& vec,
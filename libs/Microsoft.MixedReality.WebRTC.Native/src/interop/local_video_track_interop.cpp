@@ -47,6 +47,46 @@ void MRS_CALL mrsLocalVideoTrackRegisterArgb32FrameCallback(
   }
 }
 
+void MRS_CALL mrsLocalVideoTrackRegisterNv12FrameCallback(
+    LocalVideoTrackHandle trackHandle,
+    PeerConnectionNv12VideoFrameCallback callback,
+    void* user_data) noexcept {
+  if (auto track = static_cast<LocalVideoTrack*>(trackHandle)) {
+    track->SetCallback(Nv12FrameReadyCallback{callback, user_data});
+  }
+}
+
+void MRS_CALL mrsLocalVideoTrackRegisterRgba32FrameCallback(
+    LocalVideoTrackHandle trackHandle,
+    mrsBool premultiplied_alpha,
+    PeerConnectionRgba32VideoFrameCallback callback,
+    void* user_data) noexcept {
+  if (auto track = static_cast<LocalVideoTrack*>(trackHandle)) {
+    track->SetCallback(Rgba32FrameReadyCallback{
+        {callback, user_data}, (premultiplied_alpha != mrsBool::kFalse)});
+  }
+}
+
+void MRS_CALL mrsLocalVideoTrackRegisterBgra32FrameCallback(
+    LocalVideoTrackHandle trackHandle,
+    mrsBool premultiplied_alpha,
+    PeerConnectionBgra32VideoFrameCallback callback,
+    void* user_data) noexcept {
+  if (auto track = static_cast<LocalVideoTrack*>(trackHandle)) {
+    track->SetCallback(Bgra32FrameReadyCallback{
+        {callback, user_data}, (premultiplied_alpha != mrsBool::kFalse)});
+  }
+}
+
+void MRS_CALL mrsLocalVideoTrackRegisterFrameHandleCallback(
+    LocalVideoTrackHandle trackHandle,
+    PeerConnectionVideoFrameHandleCallback callback,
+    void* user_data) noexcept {
+  if (auto track = static_cast<LocalVideoTrack*>(trackHandle)) {
+    track->SetCallback(VideoFrameHandleReadyCallback{callback, user_data});
+  }
+}
+
 mrsResult MRS_CALL
 mrsLocalVideoTrackSetEnabled(LocalVideoTrackHandle track_handle,
                              mrsBool enabled) noexcept {
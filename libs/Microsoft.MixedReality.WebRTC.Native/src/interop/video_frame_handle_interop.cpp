@@ -0,0 +1,97 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+// This is a precompiled header, it must be on its own, followed by a blank
+// line, to prevent clang-format from reordering it with other headers.
+#include "pch.h"
+
+#include "video_frame_handle.h"
+#include "video_frame_handle_interop.h"
+
+using namespace Microsoft::MixedReality::WebRTC;
+
+void MRS_CALL mrsVideoFrameHandleAddRef(mrsVideoFrameHandle handle) noexcept {
+  if (handle) {
+    handle->AddRef();
+  } else {
+    RTC_LOG(LS_WARNING)
+        << "Trying to add reference to NULL VideoFrameHandle object.";
+  }
+}
+
+void MRS_CALL
+mrsVideoFrameHandleRemoveRef(mrsVideoFrameHandle handle) noexcept {
+  if (handle) {
+    handle->RemoveRef();
+  } else {
+    RTC_LOG(LS_WARNING)
+        << "Trying to remove reference from NULL VideoFrameHandle object.";
+  }
+}
+
+mrsResult MRS_CALL
+mrsVideoFrameHandleGetI420A(mrsVideoFrameHandle handle,
+                            mrsI420AVideoFrame* frame) noexcept {
+  if (!handle) {
+    return Result::kInvalidNativeHandle;
+  }
+  if (!frame) {
+    return Result::kInvalidParameter;
+  }
+  *frame = handle->GetI420A();
+  return Result::kSuccess;
+}
+
+mrsResult MRS_CALL
+mrsVideoFrameHandleGetArgb32(mrsVideoFrameHandle handle,
+                             mrsArgb32VideoFrame* frame) noexcept {
+  if (!handle) {
+    return Result::kInvalidNativeHandle;
+  }
+  if (!frame) {
+    return Result::kInvalidParameter;
+  }
+  *frame = handle->GetArgb32();
+  return Result::kSuccess;
+}
+
+mrsResult MRS_CALL
+mrsVideoFrameHandleGetRgba32(mrsVideoFrameHandle handle,
+                             mrsBool premultiplied_alpha,
+                             mrsRgba32VideoFrame* frame) noexcept {
+  if (!handle) {
+    return Result::kInvalidNativeHandle;
+  }
+  if (!frame) {
+    return Result::kInvalidParameter;
+  }
+  *frame = handle->GetRgba32(premultiplied_alpha != mrsBool::kFalse);
+  return Result::kSuccess;
+}
+
+mrsResult MRS_CALL
+mrsVideoFrameHandleGetBgra32(mrsVideoFrameHandle handle,
+                             mrsBool premultiplied_alpha,
+                             mrsBgra32VideoFrame* frame) noexcept {
+  if (!handle) {
+    return Result::kInvalidNativeHandle;
+  }
+  if (!frame) {
+    return Result::kInvalidParameter;
+  }
+  *frame = handle->GetBgra32(premultiplied_alpha != mrsBool::kFalse);
+  return Result::kSuccess;
+}
+
+mrsResult MRS_CALL
+mrsVideoFrameHandleGetNv12(mrsVideoFrameHandle handle,
+                           mrsNv12VideoFrame* frame) noexcept {
+  if (!handle) {
+    return Result::kInvalidNativeHandle;
+  }
+  if (!frame) {
+    return Result::kInvalidParameter;
+  }
+  *frame = handle->GetNv12();
+  return Result::kSuccess;
+}
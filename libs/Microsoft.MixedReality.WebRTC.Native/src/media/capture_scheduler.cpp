@@ -0,0 +1,318 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "capture_scheduler.h"
+
+namespace Microsoft::MixedReality::WebRTC {
+
+CaptureScheduler& CaptureScheduler::Instance() noexcept {
+  // Intentionally leaked; see declaration.
+  static CaptureScheduler* const instance = new CaptureScheduler();
+  return *instance;
+}
+
+CaptureScheduler::~CaptureScheduler() noexcept {
+  Shutdown();
+}
+
+bool CaptureScheduler::SetWorkerCount(int worker_count) noexcept {
+  if ((worker_count < 1) || (worker_count > kMaxWorkerCount)) {
+    return false;
+  }
+  auto config_lock = std::scoped_lock{config_mutex_};
+  std::vector<std::thread> threads;
+  {
+    auto lock = std::scoped_lock{mutex_};
+    // Joining the workers from one of them would deadlock.
+    const std::thread::id this_id = std::this_thread::get_id();
+    for (auto&& pair : clients_) {
+      if (pair.second.running_ && (pair.second.runner_ == this_id)) {
+        return false;
+      }
+    }
+    if (worker_count == worker_count_) {
+      return true;
+    }
+    worker_count_ = worker_count;
+    if (worker_threads_.empty()) {
+      return true;
+    }
+    stop_workers_ = true;
+    threads.swap(worker_threads_);
+  }
+
+  // Let the workers complete the client they are executing, if any, and exit.
+  // Due clients wait in the run queue for the new workers.
+  run_cv_.notify_all();
+  for (auto&& thread : threads) {
+    thread.join();
+  }
+  auto lock = std::scoped_lock{mutex_};
+  stop_workers_ = false;
+  if (timer_thread_.joinable()) {
+    StartWorkers();
+  }
+  return true;
+}
+
+int CaptureScheduler::GetWorkerCount() const noexcept {
+  auto lock = std::scoped_lock{mutex_};
+  return worker_count_;
+}
+
+void CaptureScheduler::Register(Client* client) noexcept {
+  auto lock = std::scoped_lock{mutex_};
+  clients_.try_emplace(client);
+  EnsureStarted();
+}
+
+void CaptureScheduler::Unregister(Client* client) noexcept {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = clients_.find(client);
+  if (it == clients_.end()) {
+    return;
+  }
+
+  // Invalidate the pending timer, if any, and remove the client from the run
+  // queue if it is already due. If another call is concurrently unregistering
+  // the client, only wait for the client execution, and let that call remove
+  // the client.
+  const bool owner = !it->second.unregistering_;
+  if (owner) {
+    it->second.unregistering_ = true;
+    it->second.generation_ = ++next_generation_;
+    it->second.rerun_ = false;
+    if (it->second.queued_) {
+      run_queue_.erase(
+          std::remove(run_queue_.begin(), run_queue_.end(), client),
+          run_queue_.end());
+      it->second.queued_ = false;
+    }
+  }
+  const uint64_t generation = it->second.generation_;
+
+  // Wait for the client to complete its current execution, unless this is
+  // called from that execution itself. The client can be removed, and even
+  // registered again, by another call while waiting.
+  const std::thread::id this_id = std::this_thread::get_id();
+  done_cv_.wait(lock, [this, client, generation, this_id]() {
+    auto found = clients_.find(client);
+    if ((found == clients_.end()) ||
+        (found->second.generation_ != generation)) {
+      return true;
+    }
+    const ClientState& state = found->second;
+    return (!state.running_ || (state.runner_ == this_id));
+  });
+  if (owner) {
+    it = clients_.find(client);
+    if ((it != clients_.end()) && (it->second.generation_ == generation)) {
+      clients_.erase(it);
+    }
+  }
+}
+
+void CaptureScheduler::Schedule(Client* client, int64_t deadline_us) noexcept {
+  auto lock = std::scoped_lock{mutex_};
+  auto it = clients_.find(client);
+  if ((it == clients_.end()) || it->second.unregistering_) {
+    return;
+  }
+  EnsureStarted();
+  const uint64_t generation = ++next_generation_;
+  it->second.generation_ = generation;
+
+  // Deadlines already passed are stored in the current slot, which is the next
+  // one processed.
+  const int64_t deadline_ms =
+      std::max(deadline_us / rtc::kNumMicrosecsPerMillisec, cursor_ms_);
+  wheel_[deadline_ms & (kSlotCount - 1)].push_back(
+      Timer{client, deadline_us, generation});
+  ++timer_count_;
+  if (deadline_us < next_wake_us_) {
+    timer_cv_.notify_one();
+  }
+}
+
+void CaptureScheduler::Shutdown() noexcept {
+  auto config_lock = std::scoped_lock{config_mutex_};
+  std::thread timer_thread;
+  std::vector<std::thread> threads;
+  {
+    auto lock = std::scoped_lock{mutex_};
+    // A thread cannot join itself, so keep running if the last object was
+    // released from a client execution.
+    const std::thread::id this_id = std::this_thread::get_id();
+    for (auto&& thread : worker_threads_) {
+      if (thread.get_id() == this_id) {
+        return;
+      }
+    }
+    stop_timer_ = true;
+    stop_workers_ = true;
+    timer_thread.swap(timer_thread_);
+    threads.swap(worker_threads_);
+  }
+  timer_cv_.notify_all();
+  run_cv_.notify_all();
+  if (timer_thread.joinable()) {
+    timer_thread.join();
+  }
+  for (auto&& thread : threads) {
+    thread.join();
+  }
+  auto lock = std::scoped_lock{mutex_};
+  stop_timer_ = false;
+  stop_workers_ = false;
+}
+
+void CaptureScheduler::RunTimer() noexcept {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_timer_) {
+    // Process all slots up to the current time. If the thread was late by more
+    // than a revolution, all slots are processed once.
+    const int64_t now_us = rtc::TimeMicros();
+    const int64_t now_ms = now_us / rtc::kNumMicrosecsPerMillisec;
+    const int64_t last_ms = std::min(now_ms, cursor_ms_ + kSlotCount - 1);
+    for (int64_t slot_ms = cursor_ms_; slot_ms <= last_ms; ++slot_ms) {
+      FireSlot(slot_ms, now_us);
+    }
+
+    // The current slot may still hold timers due later in the current
+    // millisecond, so process it again next time.
+    cursor_ms_ = std::max(cursor_ms_, now_ms);
+
+    // Sleep until the next deadline. If none is found in the next revolution,
+    // check again after that revolution.
+    int64_t next_wake_us = INT64_MAX;
+    if (timer_count_ > 0) {
+      next_wake_us = FindNextDeadline(cursor_ms_);
+      if (next_wake_us == INT64_MAX) {
+        next_wake_us =
+            (cursor_ms_ + kSlotCount) * rtc::kNumMicrosecsPerMillisec;
+      }
+    }
+    next_wake_us_ = next_wake_us;
+    if (next_wake_us == INT64_MAX) {
+      timer_cv_.wait(lock);
+    } else if (next_wake_us > now_us) {
+      timer_cv_.wait_for(lock,
+                         std::chrono::microseconds(next_wake_us - now_us));
+    }
+    next_wake_us_ = INT64_MAX;
+  }
+}
+
+void CaptureScheduler::RunWorker() noexcept {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    run_cv_.wait(lock,
+                 [this]() { return (stop_workers_ || !run_queue_.empty()); });
+    if (stop_workers_) {
+      break;
+    }
+    Client* const client = run_queue_.front();
+    run_queue_.pop_front();
+    auto it = clients_.find(client);
+    if (it == clients_.end()) {
+      continue;
+    }
+    it->second.queued_ = false;
+    it->second.running_ = true;
+    it->second.runner_ = std::this_thread::get_id();
+    lock.unlock();
+    client->OnScheduledTick();
+    lock.lock();
+
+    // The client is still registered, unless it unregistered itself during
+    // its execution; other threads wait for the execution to complete.
+    it = clients_.find(client);
+    if (it != clients_.end()) {
+      ClientState& state = it->second;
+      state.running_ = false;
+      state.runner_ = std::thread::id{};
+      if (state.rerun_) {
+        state.rerun_ = false;
+        state.queued_ = true;
+        run_queue_.push_back(client);
+        run_cv_.notify_one();
+      }
+    }
+    done_cv_.notify_all();
+  }
+}
+
+void CaptureScheduler::FireSlot(int64_t slot_ms, int64_t now_us) {
+  std::vector<Timer>& slot = wheel_[slot_ms & (kSlotCount - 1)];
+  size_t index = 0;
+  while (index < slot.size()) {
+    const Timer& timer = slot[index];
+    auto it = clients_.find(timer.client_);
+    const bool stale = ((it == clients_.end()) ||
+                        (it->second.generation_ != timer.generation_));
+    if (!stale && (timer.deadline_us_ > now_us)) {
+      // Timer of a later revolution, or later in the current millisecond
+      ++index;
+      continue;
+    }
+    if (!stale) {
+      ClientState& state = it->second;
+      if (state.running_) {
+        state.rerun_ = true;
+      } else if (!state.queued_) {
+        state.queued_ = true;
+        run_queue_.push_back(timer.client_);
+        run_cv_.notify_one();
+      }
+    }
+
+    // Remove the timer; the order of the timers in a slot does not matter.
+    slot[index] = slot.back();
+    slot.pop_back();
+    --timer_count_;
+  }
+}
+
+int64_t CaptureScheduler::FindNextDeadline(int64_t from_ms) const {
+  for (int64_t slot_ms = from_ms; slot_ms < from_ms + kSlotCount; ++slot_ms) {
+    int64_t next_deadline_us = INT64_MAX;
+    for (auto&& timer : wheel_[slot_ms & (kSlotCount - 1)]) {
+      // Skip the timers of later revolutions
+      if (timer.deadline_us_ / rtc::kNumMicrosecsPerMillisec > slot_ms) {
+        continue;
+      }
+      next_deadline_us = std::min(next_deadline_us, timer.deadline_us_);
+    }
+    if (next_deadline_us != INT64_MAX) {
+      return next_deadline_us;
+    }
+  }
+  return INT64_MAX;
+}
+
+void CaptureScheduler::EnsureStarted() {
+  if (timer_thread_.joinable()) {
+    return;
+  }
+  // Start one revolution in the past, so that the first pass processes all the
+  // slots, and fires the timers which became due while the threads were
+  // stopped.
+  cursor_ms_ =
+      rtc::TimeMicros() / rtc::kNumMicrosecsPerMillisec - kSlotCount + 1;
+  timer_thread_ = std::thread([this]() { RunTimer(); });
+  StartWorkers();
+}
+
+void CaptureScheduler::StartWorkers() {
+  worker_threads_.reserve(worker_count_);
+  for (int i = 0; i < worker_count_; ++i) {
+    worker_threads_.emplace_back([this]() { RunWorker(); });
+  }
+}
+
+}  // namespace Microsoft::MixedReality::WebRTC
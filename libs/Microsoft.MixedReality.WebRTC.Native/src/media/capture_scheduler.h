@@ -0,0 +1,193 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "rtc_base/thread_annotations.h"
+
+namespace Microsoft::MixedReality::WebRTC {
+
+/// Scheduler of the periodic work of the external video track sources, like
+/// frame requests, shared by all sources instead of each source running its own
+/// thread.
+///
+/// Deadlines are stored in a hashed timer wheel with a 1 ms resolution, served
+/// by a single timer thread which sleeps until the next deadline. Due clients
+/// are executed on a small pool of worker threads, so that a client slow to
+/// execute only delays the other clients if all workers are busy. A given
+/// client is never executed concurrently with itself.
+///
+/// The threads are started on first use, and stopped by |Shutdown()| when the
+/// library shuts down, to allow the module to be unloaded.
+class CaptureScheduler {
+ public:
+  /// Object executing some work at scheduled times.
+  class Client {
+   public:
+    /// Invoked on a worker thread once the deadline passed to |Schedule()| is
+    /// reached. The client generally calls |Schedule()| again from here to
+    /// schedule its next execution.
+    virtual void OnScheduledTick() noexcept = 0;
+
+   protected:
+    ~Client() = default;
+  };
+
+  /// Default number of worker threads.
+  static constexpr int kDefaultWorkerCount = 2;
+
+  /// Maximum number of worker threads.
+  static constexpr int kMaxWorkerCount = 64;
+
+  /// Get the global scheduler instance shared by all sources. The global
+  /// scheduler is never destroyed; see |FrameBufferPool::Instance()|.
+  static CaptureScheduler& Instance() noexcept;
+
+  CaptureScheduler() noexcept = default;
+  ~CaptureScheduler() noexcept;
+
+  /// Set the number of worker threads executing the clients. This restarts the
+  /// workers if already running, so must not be called from a client.
+  /// Return |false| if |worker_count| is not in the range [1, kMaxWorkerCount].
+  bool SetWorkerCount(int worker_count) noexcept;
+
+  /// Get the number of worker threads executing the clients.
+  int GetWorkerCount() const noexcept;
+
+  /// Register a client, which can then be scheduled.
+  void Register(Client* client) noexcept;
+
+  /// Unregister a client, cancelling its scheduled execution, if any. If the
+  /// client is executing on another thread, this waits for that execution to
+  /// complete, so that the client can be safely destroyed once this returns.
+  void Unregister(Client* client) noexcept;
+
+  /// Schedule the next execution of a registered client at time |deadline_us|,
+  /// as given by |rtc::TimeMicros()|. This replaces any previous deadline of
+  /// the client not reached yet. This is ignored if the client is not
+  /// registered.
+  void Schedule(Client* client, int64_t deadline_us) noexcept;
+
+  /// Stop all threads. Those are restarted on next use. This does nothing if
+  /// called from a worker thread.
+  void Shutdown() noexcept;
+
+ protected:
+  /// Number of slots of the timer wheel, each covering 1 ms. Deadlines further
+  /// in the future than a wheel revolution share slots with nearer ones, and
+  /// are skipped until the revolution they belong to.
+  static constexpr int kSlotCount = 1024;
+
+  /// Deadline of a client, stored in the timer wheel.
+  struct Timer {
+    Client* client_;
+    int64_t deadline_us_;
+
+    /// Generation of the client schedule this timer belongs to. The timer is
+    /// stale and ignored if the client was rescheduled since.
+    uint64_t generation_;
+  };
+
+  /// Scheduling state of a registered client.
+  struct ClientState {
+    /// Generation of the latest schedule, incremented each time the client is
+    /// scheduled or unregistered.
+    uint64_t generation_{0};
+
+    /// The client is waiting in |run_queue_|.
+    bool queued_{false};
+
+    /// The client is executing on |runner_|.
+    bool running_{false};
+
+    /// The client timer fired while the client was executing, so it needs to
+    /// execute again once done.
+    bool rerun_{false};
+
+    /// The client is being unregistered, and waits for its current execution
+    /// to complete. It cannot be scheduled again.
+    bool unregistering_{false};
+    std::thread::id runner_;
+  };
+
+  /// Entry point of the timer thread.
+  void RunTimer() noexcept;
+
+  /// Entry point of the worker threads.
+  void RunWorker() noexcept;
+
+  /// Move the timers of slot |slot_ms| due at time |now_us| to the run queue.
+  /// The caller must hold |mutex_|.
+  void FireSlot(int64_t slot_ms, int64_t now_us);
+
+  /// Find the deadline of the earliest timer in the next wheel revolution from
+  /// |from_ms|, or |INT64_MAX| if none. The caller must hold |mutex_|.
+  int64_t FindNextDeadline(int64_t from_ms) const;
+
+  /// Start the timer and worker threads if not already running. The caller must
+  /// hold |mutex_|.
+  void EnsureStarted();
+
+  /// Start the worker threads. The caller must hold |mutex_|.
+  void StartWorkers();
+
+ private:
+  mutable std::mutex mutex_;
+
+  /// Registered clients.
+  std::unordered_map<Client*, ClientState> clients_ RTC_GUARDED_BY(mutex_);
+
+  /// Timer wheel, indexed by deadline in milliseconds modulo |kSlotCount|.
+  std::array<std::vector<Timer>, kSlotCount> wheel_ RTC_GUARDED_BY(mutex_);
+
+  /// Generation of the latest client schedule. This is shared by all clients,
+  /// so that the stale timers of an unregistered client never match a new
+  /// client registered at the same address.
+  uint64_t next_generation_ RTC_GUARDED_BY(mutex_){0};
+
+  /// Number of timers in |wheel_|, including stale ones.
+  size_t timer_count_ RTC_GUARDED_BY(mutex_){0};
+
+  /// Next wheel slot to process by the timer thread, in milliseconds.
+  int64_t cursor_ms_ RTC_GUARDED_BY(mutex_){0};
+
+  /// Time the timer thread is sleeping until, in microseconds.
+  int64_t next_wake_us_ RTC_GUARDED_BY(mutex_){INT64_MAX};
+
+  /// Clients due for execution, in deadline order.
+  std::deque<Client*> run_queue_ RTC_GUARDED_BY(mutex_);
+
+  /// Number of worker threads to start.
+  int worker_count_ RTC_GUARDED_BY(mutex_){kDefaultWorkerCount};
+
+  std::thread timer_thread_ RTC_GUARDED_BY(mutex_);
+  std::vector<std::thread> worker_threads_ RTC_GUARDED_BY(mutex_);
+
+  /// Request the timer thread, respectively the worker threads, to exit.
+  bool stop_timer_ RTC_GUARDED_BY(mutex_){false};
+  bool stop_workers_ RTC_GUARDED_BY(mutex_){false};
+
+  /// Signaled when the timer thread needs to wake up earlier than planned.
+  std::condition_variable timer_cv_;
+
+  /// Signaled when a client is due, or on shutdown.
+  std::condition_variable run_cv_;
+
+  /// Signaled when a client completes its execution.
+  std::condition_variable done_cv_;
+
+  /// Serializes |SetWorkerCount()| and |Shutdown()|, which join threads
+  /// outside of |mutex_|.
+  std::mutex config_mutex_;
+};
+
+}  // namespace Microsoft::MixedReality::WebRTC
@@ -0,0 +1,361 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include <algorithm>
+
+#include "interop/global_factory.h"
+#include "media/external_audio_track_source_impl.h"
+
+namespace {
+
+using namespace Microsoft::MixedReality::WebRTC;
+
+/// Number of 10 ms ticks over which the minimum amount of buffered audio is
+/// measured to detect a producer running faster than the source.
+constexpr int kDriftWindowTicks = 100;
+
+}  // namespace
+
+namespace Microsoft::MixedReality::WebRTC {
+namespace detail {
+
+void CustomAudioSourceAdapter::DispatchFrame(const int16_t* data,
+                                             int sampling_rate_hz,
+                                             size_t channel_count,
+                                             size_t sample_count) {
+  auto lock = std::scoped_lock{mutex_};
+  for (auto* sink : sinks_) {
+    sink->OnData(data, 16, sampling_rate_hz, channel_count, sample_count);
+  }
+}
+
+void CustomAudioSourceAdapter::AddSink(webrtc::AudioTrackSinkInterface* sink) {
+  auto lock = std::scoped_lock{mutex_};
+  if (std::find(sinks_.begin(), sinks_.end(), sink) == sinks_.end()) {
+    sinks_.push_back(sink);
+  }
+}
+
+void CustomAudioSourceAdapter::RemoveSink(
+    webrtc::AudioTrackSinkInterface* sink) {
+  auto lock = std::scoped_lock{mutex_};
+  auto it = std::find(sinks_.begin(), sinks_.end(), sink);
+  if (it != sinks_.end()) {
+    sinks_.erase(it);
+  }
+}
+
+RefPtr<ExternalAudioTrackSource> ExternalAudioTrackSourceImpl::create(
+    RefPtr<ExternalAudioSource> audio_source,
+    const ExternalAudioTrackSourceConfig& config) {
+  if (ValidateConfig(config) != Result::kSuccess) {
+    return {};
+  }
+  auto source =
+      new ExternalAudioTrackSourceImpl(std::move(audio_source), config);
+
+  // Like video track sources, audio track sources start already capturing.
+  source->StartCapture();
+
+  return source;
+}
+
+ExternalAudioTrackSourceImpl::ExternalAudioTrackSourceImpl(
+    RefPtr<ExternalAudioSource> audio_source,
+    const ExternalAudioTrackSourceConfig& config)
+    : config_(config),
+      frame_sample_count_(
+          static_cast<uint32_t>(config.sampling_rate_hz_ / 100)),
+      track_source_(new rtc::RefCountedObject<CustomAudioSourceAdapter>()),
+      audio_source_(std::move(audio_source)),
+      pacer_(100.0),
+      frame_buffer_(frame_sample_count_ * config.channel_count_) {
+  if (!audio_source_) {
+    AudioReadBufferConfig buffer_config;
+    buffer_config.capacity_ms_ = config_.capacity_ms_;
+    buffer_config.silence_fill_ = true;
+    buffer_ = AudioReadBuffer::Create(buffer_config);
+    silence_.resize(frame_sample_count_ * config_.channel_count_);
+  }
+  GlobalFactory::Instance()->AddObject(ObjectType::kExternalAudioTrackSource,
+                                       this);
+}
+
+ExternalAudioTrackSourceImpl::~ExternalAudioTrackSourceImpl() {
+  StopCapture();
+  GlobalFactory::Instance()->RemoveObject(ObjectType::kExternalAudioTrackSource,
+                                          this);
+}
+
+void ExternalAudioTrackSourceImpl::StartCapture() {
+  // Check if |Shutdown()| was called, in which case the source cannot restart.
+  if (!audio_source_ && !buffer_) {
+    return;
+  }
+
+  // Unlike push-mode video sources, push-mode audio sources still produce
+  // frames on their own clock, reading them from the jitter buffer.
+  track_source_->state_ = SourceState::kLive;
+  buffering_ = true;
+  min_buffered_count_ = UINT32_MAX;
+  drift_window_ticks_ = kDriftWindowTicks;
+  CaptureScheduler& scheduler = CaptureScheduler::Instance();
+  scheduler.Register(this);
+
+  // Schedule first frame for 10ms from now
+  pacer_.Reset(rtc::TimeMicros() + 10 * rtc::kNumMicrosecsPerMillisec);
+  scheduler.Schedule(this, pacer_.NextDeadlineUs());
+}
+
+Result ExternalAudioTrackSourceImpl::SubmitFrame(const AudioFrame& frame,
+                                                 int64_t timestamp_ms) {
+  if ((frame.bits_per_sample_ != 16) ||
+      (frame.sample_format_ != AudioSampleFormat::kInt16) ||
+      ((frame.sample_layout_ != AudioSampleLayout::kInterleaved) &&
+       (frame.channel_count_ > 1)) ||
+      (frame.sampling_rate_hz_ !=
+       static_cast<uint32_t>(config_.sampling_rate_hz_)) ||
+      (frame.channel_count_ != static_cast<uint32_t>(config_.channel_count_)) ||
+      (!frame.data_ && (frame.sample_count_ > 0))) {
+    return Result::kInvalidParameter;
+  }
+  rtc::CritScope lock(&push_lock_);
+  if (!buffer_) {
+    return Result::kInvalidOperation;
+  }
+
+  // Compare the frame timestamp with the end of the previous frame, allowing
+  // for some rounding of the timestamps by the producer.
+  const int64_t duration_us = static_cast<int64_t>(frame.sample_count_) *
+                              rtc::kNumMicrosecsPerSec /
+                              config_.sampling_rate_hz_;
+  AudioFrame chunk = frame;
+  chunk.sample_layout_ = AudioSampleLayout::kInterleaved;
+  int64_t end_us = (timestamp_ms >= 0
+                        ? timestamp_ms * rtc::kNumMicrosecsPerMillisec
+                        : next_timestamp_us_);
+  if (end_us >= 0) {
+    end_us += duration_us;
+  }
+  if ((timestamp_ms >= 0) && (next_timestamp_us_ >= 0)) {
+    const int64_t delta_us =
+        timestamp_ms * rtc::kNumMicrosecsPerMillisec - next_timestamp_us_;
+    const int64_t tolerance_us =
+        kTimestampToleranceMs * rtc::kNumMicrosecsPerMillisec;
+    if (delta_us > tolerance_us) {
+      // Fill the gap with silence, up to the buffer capacity.
+      const int64_t max_count =
+          static_cast<int64_t>(config_.sampling_rate_hz_) *
+          config_.capacity_ms_ / 1000;
+      const uint32_t count = static_cast<uint32_t>(
+          std::min(delta_us * config_.sampling_rate_hz_ /
+                       rtc::kNumMicrosecsPerSec,
+                   max_count));
+      WriteSilence(count);
+      gap_count_.fetch_add(1, std::memory_order_relaxed);
+      inserted_sample_count_.fetch_add(count, std::memory_order_relaxed);
+    } else if (delta_us < -tolerance_us) {
+      // Drop the samples already covered by the previous frames.
+      const uint32_t count = static_cast<uint32_t>(
+          std::min<int64_t>(-delta_us * config_.sampling_rate_hz_ /
+                                rtc::kNumMicrosecsPerSec,
+                            chunk.sample_count_));
+      chunk.data_ = static_cast<const int16_t*>(chunk.data_) +
+                    count * chunk.channel_count_;
+      chunk.sample_count_ -= count;
+      overlap_count_.fetch_add(1, std::memory_order_relaxed);
+      overlap_sample_count_.fetch_add(count, std::memory_order_relaxed);
+
+      // A frame entirely covered by the previous ones does not move back the
+      // expected timestamp of the next frame.
+      end_us = std::max(end_us, next_timestamp_us_);
+    }
+  }
+  next_timestamp_us_ = end_us;
+
+  if (chunk.sample_count_ > 0) {
+    buffer_->Write(chunk);
+  }
+  return Result::kSuccess;
+}
+
+void ExternalAudioTrackSourceImpl::WriteSilence(uint32_t sample_count) {
+  AudioFrame frame{};
+  frame.data_ = silence_.data();
+  frame.bits_per_sample_ = 16;
+  frame.sampling_rate_hz_ = static_cast<uint32_t>(config_.sampling_rate_hz_);
+  frame.channel_count_ = static_cast<uint32_t>(config_.channel_count_);
+  while (sample_count > 0) {
+    frame.sample_count_ = std::min(sample_count, frame_sample_count_);
+    buffer_->Write(frame);
+    sample_count -= frame.sample_count_;
+  }
+}
+
+ExternalAudioTrackSourceStats ExternalAudioTrackSourceImpl::GetStats() const {
+  ExternalAudioTrackSourceStats stats;
+  stats.pacing = pacer_.GetStats();
+  stats.frame_count = frame_count_.load(std::memory_order_relaxed);
+  stats.silence_frame_count =
+      silence_frame_count_.load(std::memory_order_relaxed);
+  stats.underrun_count = underrun_count_.load(std::memory_order_relaxed);
+  stats.gap_count = gap_count_.load(std::memory_order_relaxed);
+  stats.inserted_sample_count =
+      inserted_sample_count_.load(std::memory_order_relaxed);
+  stats.overlap_count = overlap_count_.load(std::memory_order_relaxed);
+  stats.overlap_sample_count =
+      overlap_sample_count_.load(std::memory_order_relaxed);
+  stats.drift_sample_count =
+      drift_sample_count_.load(std::memory_order_relaxed);
+  RefPtr<AudioReadBuffer> buffer;
+  {
+    rtc::CritScope lock(&push_lock_);
+    buffer = buffer_;
+  }
+  if (buffer) {
+    const AudioReadBufferStats buffer_stats = buffer->GetStats();
+    stats.overrun_sample_count = buffer_stats.dropped_sample_count_;
+    stats.buffered_sample_count = buffer_stats.available_sample_count_;
+  }
+  return stats;
+}
+
+void ExternalAudioTrackSourceImpl::StopCapture() {
+  if (track_source_->state_ != SourceState::kEnded) {
+    // This waits for the frame being produced, if any.
+    CaptureScheduler::Instance().Unregister(this);
+    track_source_->state_ = SourceState::kEnded;
+  }
+}
+
+void ExternalAudioTrackSourceImpl::Shutdown() noexcept {
+  StopCapture();
+  {
+    rtc::CritScope lock(&push_lock_);
+    buffer_ = nullptr;
+  }
+  audio_source_ = nullptr;
+}
+
+bool ExternalAudioTrackSourceImpl::PullFrame(int64_t timestamp_ms) noexcept {
+  AudioFrameRequest request{*this, timestamp_ms, frame_buffer_.data(),
+                            frame_sample_count_,
+                            static_cast<uint32_t>(config_.channel_count_)};
+  const uint32_t count =
+      std::min(audio_source_->FrameRequested(request), frame_sample_count_);
+  std::fill(frame_buffer_.begin() + count * config_.channel_count_,
+            frame_buffer_.end(), int16_t{0});
+  return (count > 0);
+}
+
+bool ExternalAudioTrackSourceImpl::ReadFrame() noexcept {
+  const uint32_t buffered_count = buffer_->GetAvailableSampleCount();
+
+  // Discard the audio buffered in excess of the jitter buffer size during a
+  // whole measurement window. This is latency accumulated because the producer
+  // clock runs faster than the source clock, as opposed to bursts submitted by
+  // the producer, which are consumed within the window.
+  const uint32_t target_count = std::max<uint32_t>(
+      static_cast<uint32_t>(static_cast<int64_t>(config_.sampling_rate_hz_) *
+                            config_.jitter_buffer_ms_ / 1000),
+      frame_sample_count_);
+  if (!buffering_) {
+    min_buffered_count_ = std::min(min_buffered_count_, buffered_count);
+    if (--drift_window_ticks_ <= 0) {
+      if ((min_buffered_count_ != UINT32_MAX) &&
+          (min_buffered_count_ > target_count + frame_sample_count_)) {
+        const uint32_t count =
+            buffer_->Skip(min_buffered_count_ - target_count);
+        drift_sample_count_.fetch_add(count, std::memory_order_relaxed);
+      }
+      min_buffered_count_ = UINT32_MAX;
+      drift_window_ticks_ = kDriftWindowTicks;
+    }
+  }
+
+  // Wait for the jitter buffer to fill before playing out, to absorb the
+  // jitter of the producer.
+  if (buffering_) {
+    if (buffered_count < target_count) {
+      std::fill(frame_buffer_.begin(), frame_buffer_.end(), int16_t{0});
+      return false;
+    }
+    buffering_ = false;
+  }
+
+  // Read a frame, completed with silence on underrun
+  const uint32_t count =
+      buffer_->Read(frame_buffer_.data(), frame_sample_count_);
+  if (count < frame_sample_count_) {
+    underrun_count_.fetch_add(1, std::memory_order_relaxed);
+    buffering_ = true;
+    min_buffered_count_ = UINT32_MAX;
+    drift_window_ticks_ = kDriftWindowTicks;
+  }
+  return (count > 0);
+}
+
+// Note - This is called on a capture scheduler worker thread, never
+// concurrently with itself.
+void ExternalAudioTrackSourceImpl::OnScheduledTick() noexcept {
+  const int64_t now_us = rtc::TimeMicros();
+  const bool has_audio =
+      (audio_source_ ? PullFrame(now_us / rtc::kNumMicrosecsPerMillisec)
+                     : ReadFrame());
+  frame_count_.fetch_add(1, std::memory_order_relaxed);
+  if (!has_audio) {
+    silence_frame_count_.fetch_add(1, std::memory_order_relaxed);
+  }
+  track_source_->DispatchFrame(frame_buffer_.data(), config_.sampling_rate_hz_,
+                               static_cast<size_t>(config_.channel_count_),
+                               frame_sample_count_);
+
+  // Schedule the next frame at the next pacer deadline. Deadlines are derived
+  // from a fixed epoch, so late frames do not cause any drift.
+  CaptureScheduler::Instance().Schedule(this, pacer_.OnTick(now_us));
+}
+
+}  // namespace detail
+
+Result ExternalAudioTrackSource::ValidateConfig(
+    const ExternalAudioTrackSourceConfig& config) noexcept {
+  if ((config.sampling_rate_hz_ < kMinSamplingRateHz) ||
+      (config.sampling_rate_hz_ > kMaxSamplingRateHz) ||
+      (config.sampling_rate_hz_ % 100 != 0)) {
+    return Result::kInvalidParameter;
+  }
+  if ((config.channel_count_ < 1) ||
+      (config.channel_count_ > kMaxChannelCount)) {
+    return Result::kInvalidParameter;
+  }
+  if ((config.capacity_ms_ < AudioReadBuffer::kMinCapacityMs) ||
+      (config.capacity_ms_ > AudioReadBuffer::kMaxCapacityMs)) {
+    return Result::kInvalidParameter;
+  }
+  // Keep room for at least one frame above the jitter buffer, otherwise the
+  // source could never start playing.
+  if ((config.jitter_buffer_ms_ < 0) ||
+      (config.jitter_buffer_ms_ > config.capacity_ms_ - 10)) {
+    return Result::kInvalidParameter;
+  }
+  return Result::kSuccess;
+}
+
+RefPtr<ExternalAudioTrackSource> ExternalAudioTrackSource::createFromSource(
+    RefPtr<ExternalAudioSource> audio_source,
+    const ExternalAudioTrackSourceConfig& config) {
+  if (!audio_source) {
+    return {};
+  }
+  return detail::ExternalAudioTrackSourceImpl::create(std::move(audio_source),
+                                                      config);
+}
+
+RefPtr<ExternalAudioTrackSource> ExternalAudioTrackSource::createPushMode(
+    const ExternalAudioTrackSourceConfig& config) {
+  return detail::ExternalAudioTrackSourceImpl::create(nullptr, config);
+}
+
+}  // namespace Microsoft::MixedReality::WebRTC
@@ -0,0 +1,186 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "audio_frame.h"
+#include "media/frame_pacer.h"
+#include "mrs_errors.h"
+#include "refptr.h"
+#include "tracked_object.h"
+#include "external_audio_track_source_interop.h"
+
+namespace Microsoft::MixedReality::WebRTC {
+
+class ExternalAudioTrackSource;
+
+/// Configuration of an |ExternalAudioTrackSource|.
+struct ExternalAudioTrackSourceConfig {
+  /// Sampling rate of the audio produced by the source, in Hertz. This must be
+  /// a multiple of 100 Hz, since the source produces 10 ms frames.
+  int sampling_rate_hz_{48000};
+
+  /// Number of channels of the audio produced by the source.
+  int channel_count_{1};
+
+  /// Amount of audio a push-mode source buffers before starting to play it
+  /// out, and again after running out of audio, in milliseconds. This absorbs
+  /// the jitter of the producer submitting audio on its own clock.
+  int jitter_buffer_ms_{40};
+
+  /// Maximum amount of audio a push-mode source buffers, in milliseconds.
+  /// Audio submitted while the buffer is full is dropped.
+  int capacity_ms_{500};
+};
+
+/// Statistics of an |ExternalAudioTrackSource|.
+struct ExternalAudioTrackSourceStats {
+  /// Pacing of the 10 ms frames produced by the source.
+  FramePacerStats pacing;
+
+  /// Number of frames dispatched to the audio tracks, including the frames of
+  /// silence.
+  uint64_t frame_count{0};
+
+  /// Number of frames of silence dispatched by a push-mode source because not
+  /// enough audio was buffered, or by a pull-mode source because the request
+  /// was not completed at all.
+  uint64_t silence_frame_count{0};
+
+  /// Number of times a push-mode source ran out of buffered audio while
+  /// playing, and started buffering again.
+  uint64_t underrun_count{0};
+
+  /// Number of samples per channel submitted to a push-mode source and dropped
+  /// because its buffer was full.
+  uint64_t overrun_sample_count{0};
+
+  /// Number of samples per channel currently buffered by a push-mode source.
+  uint64_t buffered_sample_count{0};
+
+  /// Number of gaps detected between the timestamps of consecutive submitted
+  /// frames, and number of samples per channel of silence inserted to fill
+  /// them.
+  uint64_t gap_count{0};
+  uint64_t inserted_sample_count{0};
+
+  /// Number of submitted frames overlapping the previous one according to their
+  /// timestamps, and number of samples per channel dropped as a result.
+  uint64_t overlap_count{0};
+  uint64_t overlap_sample_count{0};
+
+  /// Number of samples per channel discarded because the producer ran faster
+  /// than the source, which would otherwise increase the latency indefinitely.
+  uint64_t drift_sample_count{0};
+};
+
+/// Audio frame request for an external audio source.
+struct AudioFrameRequest {
+  /// Audio track source the request is related to.
+  ExternalAudioTrackSource& track_source_;
+
+  /// Timestamp of the first sample of the requested audio, in milliseconds.
+  std::int64_t timestamp_ms_;
+
+  /// Buffer to fill with |sample_count_| samples of |channel_count_| channels,
+  /// 16-bit interleaved, at the sampling rate of the track source.
+  std::int16_t* data_;
+
+  /// Number of samples per channel requested.
+  std::uint32_t sample_count_;
+
+  /// Number of channels of the audio requested.
+  std::uint32_t channel_count_;
+};
+
+/// Custom audio source producing 16-bit PCM audio on request.
+class ExternalAudioSource : public RefCountedBase {
+ public:
+  /// Produce the audio for a request initiated by an external track source.
+  ///
+  /// This callback is invoked automatically by the track source every 10 ms
+  /// (pull model), from a capture scheduler thread. The implementation fills
+  /// the request buffer and returns the number of samples per channel written,
+  /// which can be less than requested; the rest of the buffer is then filled
+  /// with silence.
+  virtual std::uint32_t FrameRequested(AudioFrameRequest& frame_request) = 0;
+};
+
+/// Audio track source acting as an adapter for an external source of raw PCM
+/// audio, like synthesized audio or audio decoded from a file.
+///
+/// The source produces a 10 ms frame every 10 ms on the capture scheduler
+/// shared with the external video track sources, and dispatches it to the
+/// audio tracks using it. In pull mode the audio of each frame is requested
+/// from an |ExternalAudioSource|; in push mode it is read from a jitter buffer
+/// filled by the producer with |SubmitFrame()|, in chunks of any size.
+///
+/// Because the audio device module feeds the audio captured from the audio
+/// device to all the audio streams sent, the peer connection pauses the
+/// recording from the device while sending the audio of an external source.
+class ExternalAudioTrackSource : public TrackedObject {
+ public:
+  /// Minimum and maximum sampling rate of a source, in Hertz.
+  static constexpr int kMinSamplingRateHz = 8000;
+  static constexpr int kMaxSamplingRateHz = 192000;
+
+  /// Maximum number of channels of a source.
+  static constexpr int kMaxChannelCount = 8;
+
+  /// Maximum difference between the timestamp of a submitted frame and the
+  /// end of the previous one still considered contiguous, in milliseconds.
+  static constexpr int64_t kTimestampToleranceMs = 5;
+
+  /// Check that a source configuration is supported.
+  static Result ValidateConfig(
+      const ExternalAudioTrackSourceConfig& config) noexcept;
+
+  /// Create an external audio track source requesting audio from a custom
+  /// source every 10 ms, or return null if the configuration is invalid.
+  static RefPtr<ExternalAudioTrackSource> createFromSource(
+      RefPtr<ExternalAudioSource> audio_source,
+      const ExternalAudioTrackSourceConfig& config);
+
+  /// Create an external audio track source in push mode, or return null if the
+  /// configuration is invalid. The producer submits audio with |SubmitFrame()|
+  /// whenever ready, on its own clock, and the source plays it out from a
+  /// jitter buffer.
+  static RefPtr<ExternalAudioTrackSource> createPushMode(
+      const ExternalAudioTrackSourceConfig& config);
+
+  /// Get the configuration of the source.
+  virtual const ExternalAudioTrackSourceConfig& GetConfig() const noexcept = 0;
+
+  /// Start producing audio frames. Sources start already producing audio when
+  /// created.
+  virtual void StartCapture() = 0;
+
+  /// Submit audio to a push-mode source. The frame can have any number of
+  /// samples, and must be made of 16-bit interleaved samples in the format of
+  /// the source. If |timestamp_ms| is not negative, it is compared with the
+  /// end of the previous frame submitted, to fill any gap with silence and to
+  /// drop any overlapping samples. This fails with |Result::kInvalidOperation|
+  /// if the source is not in push mode, or was shut down.
+  virtual Result SubmitFrame(const AudioFrame& frame, int64_t timestamp_ms) = 0;
+
+  /// Get a snapshot of the statistics of the source.
+  virtual ExternalAudioTrackSourceStats GetStats() const = 0;
+
+  /// Stop producing audio frames.
+  virtual void StopCapture() = 0;
+
+  /// Shutdown the source and release the custom audio source, if any.
+  virtual void Shutdown() noexcept = 0;
+};
+
+namespace detail {
+
+/// Create an external audio track source wrapping the given interop callback.
+RefPtr<ExternalAudioTrackSource> ExternalAudioTrackSourceCreateFromCallback(
+    const ExternalAudioTrackSourceConfig& config,
+    mrsRequestExternalAudioFrameCallback callback,
+    void* user_data);
+
+}  // namespace detail
+
+}  // namespace Microsoft::MixedReality::WebRTC
@@ -0,0 +1,162 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "api/mediastreaminterface.h"
+#include "api/notifier.h"
+#include "rtc_base/criticalsection.h"
+
+#include "audio_read_buffer.h"
+#include "external_audio_track_source.h"
+#include "media/capture_scheduler.h"
+
+namespace Microsoft::MixedReality::WebRTC::detail {
+
+/// Adapter to bridge an audio track source to the underlying core
+/// implementation. The audio tracks using the source add their sinks to it,
+/// including the audio send stream of the RTP sender of a local audio track.
+class CustomAudioSourceAdapter
+    : public webrtc::Notifier<webrtc::AudioSourceInterface> {
+ public:
+  /// Dispatch a frame of 16-bit interleaved samples to all sinks.
+  void DispatchFrame(const int16_t* data,
+                     int sampling_rate_hz,
+                     size_t channel_count,
+                     size_t sample_count);
+
+  // MediaSourceInterface
+  SourceState state() const override { return state_; }
+  bool remote() const override { return false; }
+
+  // AudioSourceInterface
+  void AddSink(webrtc::AudioTrackSinkInterface* sink) override;
+  void RemoveSink(webrtc::AudioTrackSinkInterface* sink) override;
+
+  SourceState state_ = SourceState::kInitializing;
+
+ private:
+  /// Mutex for |sinks_|, held while dispatching a frame, so that a sink can be
+  /// safely destroyed once removed.
+  std::mutex mutex_;
+  std::vector<webrtc::AudioTrackSinkInterface*> sinks_ RTC_GUARDED_BY(mutex_);
+};
+
+/// Audio track source acting as an adapter for an external source of raw PCM
+/// audio.
+class ExternalAudioTrackSourceImpl : public ExternalAudioTrackSource,
+                                     public CaptureScheduler::Client {
+ public:
+  using SourceState = webrtc::MediaSourceInterface::SourceState;
+
+  /// Create a pull-mode source if |audio_source| is not null, or a push-mode
+  /// source otherwise. Return null if the configuration is invalid.
+  static RefPtr<ExternalAudioTrackSource> create(
+      RefPtr<ExternalAudioSource> audio_source,
+      const ExternalAudioTrackSourceConfig& config);
+
+  ~ExternalAudioTrackSourceImpl() override;
+
+  void SetName(std::string name) { name_ = std::move(name); }
+  std::string GetName() const override { return name_; }
+
+  const ExternalAudioTrackSourceConfig& GetConfig() const noexcept override {
+    return config_;
+  }
+
+  /// Start producing audio frames.
+  void StartCapture() override;
+
+  /// Submit audio produced by a push-mode source.
+  Result SubmitFrame(const AudioFrame& frame, int64_t timestamp_ms) override;
+
+  /// Get the source statistics.
+  ExternalAudioTrackSourceStats GetStats() const override;
+
+  /// Stop producing audio frames.
+  void StopCapture() override;
+
+  /// Shutdown the source and release the custom audio source, if any.
+  void Shutdown() noexcept override;
+
+  webrtc::AudioSourceInterface* impl() const { return track_source_; }
+
+ protected:
+  ExternalAudioTrackSourceImpl(RefPtr<ExternalAudioSource> audio_source,
+                               const ExternalAudioTrackSourceConfig& config);
+
+  /// Produce and dispatch the next frame, and schedule the next one.
+  void OnScheduledTick() noexcept override;
+
+  /// Fill |frame_buffer_| from the custom audio source. Return |false| if the
+  /// frame is silent because the source did not produce any audio.
+  bool PullFrame(int64_t timestamp_ms) noexcept;
+
+  /// Fill |frame_buffer_| from the jitter buffer. Return |false| if the frame
+  /// is silent because not enough audio is buffered.
+  bool ReadFrame() noexcept;
+
+  /// Write |sample_count| samples per channel of silence into the jitter
+  /// buffer. The caller must hold |push_lock_|.
+  void WriteSilence(uint32_t sample_count);
+
+  const ExternalAudioTrackSourceConfig config_;
+
+  /// Number of samples per channel of a 10 ms frame.
+  const uint32_t frame_sample_count_;
+
+  rtc::scoped_refptr<CustomAudioSourceAdapter> track_source_;
+
+  /// Custom audio source of a pull-mode source, or null in push mode.
+  RefPtr<ExternalAudioSource> audio_source_;
+
+  /// Jitter buffer of a push-mode source, or null in pull mode. This is written
+  /// by the producer under |push_lock_|, and read by the capture scheduler.
+  RefPtr<AudioReadBuffer> buffer_;
+
+  /// Scheduler of the 10 ms frames.
+  FramePacer pacer_;
+
+  /// Frame dispatched to the tracks, only accessed from the capture scheduler.
+  std::vector<int16_t> frame_buffer_;
+
+  /// A push-mode source is filling its jitter buffer before playing it out.
+  /// Only accessed from the capture scheduler.
+  bool buffering_{true};
+
+  /// Minimum number of samples per channel buffered at the start of a tick
+  /// during the current drift measurement window, and number of ticks left in
+  /// that window. Only accessed from the capture scheduler.
+  uint32_t min_buffered_count_{UINT32_MAX};
+  int drift_window_ticks_{0};
+
+  /// Expected timestamp of the next frame submitted in push mode, in
+  /// microseconds, or -1 if unknown.
+  int64_t next_timestamp_us_ RTC_GUARDED_BY(push_lock_){-1};
+
+  /// Silence written into the jitter buffer to fill timestamp gaps.
+  std::vector<int16_t> silence_ RTC_GUARDED_BY(push_lock_);
+
+  /// Lock serializing the audio submitted in push mode with |Shutdown()|,
+  /// which releases |buffer_|.
+  rtc::CriticalSection push_lock_;
+
+  /// Statistics, updated by the side detecting the event.
+  std::atomic_uint64_t frame_count_{0};
+  std::atomic_uint64_t silence_frame_count_{0};
+  std::atomic_uint64_t underrun_count_{0};
+  std::atomic_uint64_t gap_count_{0};
+  std::atomic_uint64_t inserted_sample_count_{0};
+  std::atomic_uint64_t overlap_count_{0};
+  std::atomic_uint64_t overlap_sample_count_{0};
+  std::atomic_uint64_t drift_sample_count_{0};
+
+  /// Friendly track source name, for debugging.
+  std::string name_;
+};
+
+}  // namespace Microsoft::MixedReality::WebRTC::detail
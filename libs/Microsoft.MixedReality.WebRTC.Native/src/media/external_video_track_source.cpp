@@ -3,17 +3,142 @@
 
 #include "pch.h"
 
+#include "common_video/include/video_frame_buffer.h"
+#include "frame_buffer_pool.h"
 #include "interop/global_factory.h"
 #include "media/external_video_track_source_impl.h"
+#include "video_conversion.h"
 
 namespace {
 
 using namespace Microsoft::MixedReality::WebRTC;
 
-enum {
-  /// Request a new video frame from the source.
-  MSG_REQUEST_FRAME
-};
+/// Copy an I420A video frame into an I420 frame buffer from |buffer_cache|. If
+/// the frame has an alpha plane, that plane is copied into pooled memory, and
+/// the result is an I420A buffer referencing both, which the multiplex encoder
+/// encodes alongside the color planes.
+rtc::scoped_refptr<webrtc::VideoFrameBuffer> CopyI420AFrame(
+    const I420AVideoFrame& frame_view,
+    I420BufferCache& buffer_cache) {
+  // Get I420 buffer from the cache
+  const int width = (int)frame_view.width_;
+  const int height = (int)frame_view.height_;
+  rtc::scoped_refptr<PooledI420Buffer> buffer =
+      buffer_cache.GetBuffer(width, height);
+
+  // Copy the frame into the buffer
+  libyuv::I420Copy((const uint8_t*)frame_view.ydata_, frame_view.ystride_,
+                   (const uint8_t*)frame_view.udata_, frame_view.ustride_,
+                   (const uint8_t*)frame_view.vdata_, frame_view.vstride_,
+                   buffer->MutableDataY(), buffer->StrideY(),
+                   buffer->MutableDataU(), buffer->StrideU(),
+                   buffer->MutableDataV(), buffer->StrideV(), width, height);
+  if (!frame_view.adata_) {
+    return buffer;
+  }
+
+  // Copy the alpha plane into pooled memory. The I420A wrapper keeps the I420
+  // buffer and the alpha plane alive until the last reference to the frame is
+  // released, which also allows |buffer_cache| to reuse the I420 buffer only
+  // after that.
+  const int stride_a = width;
+  std::shared_ptr<uint8_t> alpha(FrameBufferPool::Instance().Acquire(
+      static_cast<size_t>(stride_a) * height));
+  libyuv::CopyPlane((const uint8_t*)frame_view.adata_, frame_view.astride_,
+                    alpha.get(), stride_a, width, height);
+  rtc::Callback0<void> no_longer_used([buffer, alpha]() {});
+  return webrtc::WrapI420ABuffer(
+      width, height, buffer->DataY(), buffer->StrideY(), buffer->DataU(),
+      buffer->StrideU(), buffer->DataV(), buffer->StrideV(), alpha.get(),
+      stride_a, no_longer_used);
+}
+
+/// Convert an ARGB32 video frame into an I420 frame buffer from
+/// |buffer_cache|. In |OddSizeMode::kCrop| mode, the frame is truncated to even
+/// dimensions if needed, in which case a warning is logged once if |has_warned|
+/// is |false|. In |OddSizeMode::kPad| mode, the frame keeps its dimensions, and
+/// the last chroma column and row cover a single luma column and row.
+/// Large frames are converted in parallel.
+rtc::scoped_refptr<webrtc::VideoFrameBuffer> ConvertArgb32Frame(
+    const Argb32VideoFrame& frame_view,
+    OddSizeMode odd_size_mode,
+    bool& has_warned,
+    I420BufferCache& buffer_cache) {
+  uint32_t width = frame_view.width_;
+  uint32_t height = frame_view.height_;
+
+  // Check that the input frame fits within the constraints of chroma
+  // downsampling (width and height multiple of 2), unless padding the chroma
+  // planes instead.
+  if ((odd_size_mode == OddSizeMode::kCrop) && (width & 0x1)) {
+    if (!has_warned) {
+      RTC_LOG(LS_WARNING) << "ARGB32 video frame has width " << width
+                          << " which is not a multiple of 2, so cannot be "
+                             "chroma-downsampled. "
+                             "Truncating to "
+                          << (width - 1) << " before I420 conversion.";
+      has_warned = true;
+    }
+    --width;
+  }
+  if ((odd_size_mode == OddSizeMode::kCrop) && (height & 0x1)) {
+    if (!has_warned) {
+      RTC_LOG(LS_WARNING) << "ARGB32 video frame has height " << height
+                          << " which is not a multiple of 2, so cannot be "
+                             "chroma-downsampled. "
+                             "Truncating to "
+                          << (height - 1) << " before I420 conversion.";
+      has_warned = true;
+    }
+    --height;
+  }
+
+  // Get I420 buffer from the cache
+  rtc::scoped_refptr<PooledI420Buffer> buffer =
+      buffer_cache.GetBuffer(static_cast<int>(width), static_cast<int>(height));
+
+  // Convert to I420 and copy to buffer
+  ConvertArgb32ToI420(static_cast<const uint8_t*>(frame_view.argb32_data_),
+                      frame_view.stride_, buffer->MutableDataY(),
+                      buffer->StrideY(), buffer->MutableDataU(),
+                      buffer->StrideU(), buffer->MutableDataV(),
+                      buffer->StrideV(), static_cast<int>(width),
+                      static_cast<int>(height));
+
+  return buffer;
+}
+
+/// Check that an I420A frame submitted without copy can be wrapped.
+bool IsValidI420AFrame(const I420AVideoFrame& frame_view) {
+  return (frame_view.ydata_ && frame_view.udata_ && frame_view.vdata_ &&
+          (frame_view.width_ > 0) && (frame_view.height_ > 0));
+}
+
+/// Wrap the caller's memory of an I420A video frame instead of copying it. The
+/// wrapper buffer invokes the release callback when destroyed, that is once the
+/// encoder and all the local video sinks released their reference to the
+/// frame.
+rtc::scoped_refptr<webrtc::VideoFrameBuffer> WrapI420AFrame(
+    const I420AVideoFrame& frame_view,
+    VideoFrameReleasedCallback release_callback) {
+  const int width = static_cast<int>(frame_view.width_);
+  const int height = static_cast<int>(frame_view.height_);
+  rtc::Callback0<void> no_longer_used(
+      [release_callback]() { release_callback(); });
+  if (frame_view.adata_) {
+    return webrtc::WrapI420ABuffer(
+        width, height, static_cast<const uint8_t*>(frame_view.ydata_),
+        frame_view.ystride_, static_cast<const uint8_t*>(frame_view.udata_),
+        frame_view.ustride_, static_cast<const uint8_t*>(frame_view.vdata_),
+        frame_view.vstride_, static_cast<const uint8_t*>(frame_view.adata_),
+        frame_view.astride_, no_longer_used);
+  }
+  return webrtc::WrapI420Buffer(
+      width, height, static_cast<const uint8_t*>(frame_view.ydata_),
+      frame_view.ystride_, static_cast<const uint8_t*>(frame_view.udata_),
+      frame_view.ustride_, static_cast<const uint8_t*>(frame_view.vdata_),
+      frame_view.vstride_, no_longer_used);
+}
 
 /// Buffer adapter for an I420 video frame.
 class I420ABufferAdapter : public detail::BufferAdapter {
@@ -28,15 +153,14 @@ class I420ABufferAdapter : public detail::BufferAdapter {
     return video_source_->FrameRequested(request);
   }
   rtc::scoped_refptr<webrtc::VideoFrameBuffer> FillBuffer(
-      const I420AVideoFrame& frame_view) override {
-    return webrtc::I420Buffer::Copy(
-        (int)frame_view.width_, (int)frame_view.height_,
-        (const uint8_t*)frame_view.ydata_, frame_view.ystride_,
-        (const uint8_t*)frame_view.udata_, frame_view.ustride_,
-        (const uint8_t*)frame_view.vdata_, frame_view.vstride_);
+      const I420AVideoFrame& frame_view,
+      I420BufferCache& buffer_cache) override {
+    return CopyI420AFrame(frame_view, buffer_cache);
   }
   rtc::scoped_refptr<webrtc::VideoFrameBuffer> FillBuffer(
-      const Argb32VideoFrame& /*frame_view*/) override {
+      const Argb32VideoFrame& /*frame_view*/,
+      OddSizeMode /*odd_size_mode*/,
+      I420BufferCache& /*buffer_cache*/) override {
     RTC_CHECK(false);
   }
 
@@ -57,54 +181,48 @@ class Argb32BufferAdapter : public detail::BufferAdapter {
     return video_source_->FrameRequested(request);
   }
   rtc::scoped_refptr<webrtc::VideoFrameBuffer> FillBuffer(
-      const I420AVideoFrame& /*frame_view*/) override {
+      const I420AVideoFrame& /*frame_view*/,
+      I420BufferCache& /*buffer_cache*/) override {
     RTC_CHECK(false);
   }
   rtc::scoped_refptr<webrtc::VideoFrameBuffer> FillBuffer(
-      const Argb32VideoFrame& frame_view) override {
-    // Check that the input frame fits within the constraints of chroma
-    // downsampling (width and height multiple of 2).
-    uint32_t width = frame_view.width_;
-    if (width & 0x1) {
-      if (!has_warned_) {
-        RTC_LOG(LS_WARNING) << "ARGB32 video frame has width " << width
-                            << " which is not a multiple of 2, so cannot be "
-                               "chroma-downsampled. "
-                               "Truncating to "
-                            << (width - 1) << " before I420 conversion.";
-        has_warned_ = true;
-      }
-      --width;
-    }
-    uint32_t height = frame_view.height_;
-    if (height & 0x1) {
-      if (!has_warned_) {
-        RTC_LOG(LS_WARNING) << "ARGB32 video frame has height " << height
-                            << " which is not a multiple of 2, so cannot be "
-                               "chroma-downsampled. "
-                               "Truncating to "
-                            << (height - 1) << " before I420 conversion.";
-        has_warned_ = true;
-      }
-      --height;
-    }
-
-    // Create I420 buffer
-    rtc::scoped_refptr<webrtc::I420Buffer> buffer =
-        webrtc::I420Buffer::Create(width, height);
+      const Argb32VideoFrame& frame_view,
+      OddSizeMode odd_size_mode,
+      I420BufferCache& buffer_cache) override {
+    return ConvertArgb32Frame(frame_view, odd_size_mode, has_warned_,
+                              buffer_cache);
+  }
 
-    // Convert to I420 and copy to buffer
-    libyuv::ARGBToI420((const uint8_t*)frame_view.argb32_data_,
-                       frame_view.stride_, buffer->MutableDataY(),
-                       buffer->StrideY(), buffer->MutableDataU(),
-                       buffer->StrideU(), buffer->MutableDataV(),
-                       buffer->StrideV(), width, height);
+ private:
+  RefPtr<Argb32ExternalVideoSource> video_source_;
+  bool has_warned_ = false;
+};
 
-    return buffer;
+/// Buffer adapter for a push-mode source, where the producer submits frames in
+/// any supported encoding whenever they are ready, instead of frames being
+/// requested from it.
+class PushBufferAdapter : public detail::BufferAdapter {
+ public:
+  bool IsPullMode() const noexcept override { return false; }
+  Result RequestFrame(ExternalVideoTrackSource& /*track_source*/,
+                      std::uint32_t /*request_id*/,
+                      std::int64_t /*timestamp_ms*/) noexcept override {
+    return Result::kInvalidOperation;
+  }
+  rtc::scoped_refptr<webrtc::VideoFrameBuffer> FillBuffer(
+      const I420AVideoFrame& frame_view,
+      I420BufferCache& buffer_cache) override {
+    return CopyI420AFrame(frame_view, buffer_cache);
+  }
+  rtc::scoped_refptr<webrtc::VideoFrameBuffer> FillBuffer(
+      const Argb32VideoFrame& frame_view,
+      OddSizeMode odd_size_mode,
+      I420BufferCache& buffer_cache) override {
+    return ConvertArgb32Frame(frame_view, odd_size_mode, has_warned_,
+                              buffer_cache);
   }
 
  private:
-  RefPtr<Argb32ExternalVideoSource> video_source_;
   bool has_warned_ = false;
 };
 
@@ -113,8 +231,6 @@ class Argb32BufferAdapter : public detail::BufferAdapter {
 namespace Microsoft::MixedReality::WebRTC {
 namespace detail {
 
-constexpr const size_t kMaxPendingRequestCount = 64;
-
 RefPtr<ExternalVideoTrackSource> ExternalVideoTrackSourceImpl::create(
     std::unique_ptr<BufferAdapter> adapter) {
   auto source = new ExternalVideoTrackSourceImpl(std::move(adapter));
@@ -130,9 +246,7 @@ RefPtr<ExternalVideoTrackSource> ExternalVideoTrackSourceImpl::create(
 ExternalVideoTrackSourceImpl::ExternalVideoTrackSourceImpl(
     std::unique_ptr<BufferAdapter> adapter)
     : track_source_(new rtc::RefCountedObject<CustomTrackSourceAdapter>()),
-      adapter_(std::forward<std::unique_ptr<BufferAdapter>>(adapter)),
-      capture_thread_(rtc::Thread::Create()) {
-  capture_thread_->SetName("ExternalVideoTrackSource capture thread", this);
+      adapter_(std::forward<std::unique_ptr<BufferAdapter>>(adapter)) {
   GlobalFactory::Instance()->AddObject(ObjectType::kExternalVideoTrackSource,
                                        this);
 }
@@ -149,51 +263,50 @@ void ExternalVideoTrackSourceImpl::StartCapture() {
     return;
   }
 
-  // Start capture thread
+  // In push mode, the producer submits frames on its own; there is no need for
+  // scheduling requests for them.
   track_source_->state_ = SourceState::kLive;
-  pending_requests_.clear();
-  capture_thread_->Start();
+  if (!adapter_->IsPullMode()) {
+    return;
+  }
+
+  // Register with the capture scheduler shared by all sources
+  {
+    rtc::CritScope lock(&request_lock_);
+    pending_requests_.Clear();
+  }
+  CaptureScheduler& scheduler = CaptureScheduler::Instance();
+  scheduler.Register(this);
 
   // Schedule first frame request for 10ms from now
-  int64_t now = rtc::TimeMillis();
-  capture_thread_->PostAt(RTC_FROM_HERE, now + 10, this, MSG_REQUEST_FRAME);
+  pacer_.Reset(rtc::TimeMicros() + 10 * rtc::kNumMicrosecsPerMillisec);
+  scheduler.Schedule(this, pacer_.NextDeadlineUs());
 }
 
 Result ExternalVideoTrackSourceImpl::CompleteRequest(
     uint32_t request_id,
     int64_t timestamp_ms,
     const I420AVideoFrame& frame_view) {
-  // Validate pending request ID and retrieve frame timestamp
-  int64_t timestamp_ms_original = -1;
-  {
-    rtc::CritScope lock(&request_lock_);
-    for (auto it = pending_requests_.begin(); it != pending_requests_.end();
-         ++it) {
-      if (it->first == request_id) {
-        timestamp_ms_original = it->second;
-        // Remove outdated requests, including current one
-        ++it;
-        pending_requests_.erase(pending_requests_.begin(), it);
-        break;
-      }
-    }
-    if (timestamp_ms_original < 0) {
-      return Result::kInvalidParameter;
-    }
+  if (!PopPendingRequest(request_id, timestamp_ms)) {
+    return Result::kInvalidParameter;
   }
+  DispatchBuffer(adapter_->FillBuffer(frame_view, buffer_cache_),
+                 timestamp_ms * rtc::kNumMicrosecsPerMillisec);
+  return Result::kSuccess;
+}
 
-  // Apply user override if any
-  if (timestamp_ms != timestamp_ms_original) {
-    timestamp_ms = timestamp_ms_original;
+Result ExternalVideoTrackSourceImpl::CompleteRequest(
+    uint32_t request_id,
+    int64_t timestamp_ms,
+    const I420AVideoFrame& frame_view,
+    VideoFrameReleasedCallback release_callback) {
+  if (!IsValidI420AFrame(frame_view) ||
+      !PopPendingRequest(request_id, timestamp_ms)) {
+    release_callback();
+    return Result::kInvalidParameter;
   }
-
-  // Create and dispatch the video frame
-  webrtc::VideoFrame frame{
-      webrtc::VideoFrame::Builder()
-          .set_video_frame_buffer(adapter_->FillBuffer(frame_view))
-          .set_timestamp_ms(timestamp_ms)
-          .build()};
-  track_source_->DispatchFrame(frame);
+  DispatchBuffer(WrapI420AFrame(frame_view, std::move(release_callback)),
+                 timestamp_ms * rtc::kNumMicrosecsPerMillisec);
   return Result::kSuccess;
 }
 
@@ -201,22 +314,97 @@ Result ExternalVideoTrackSourceImpl::CompleteRequest(
     uint32_t request_id,
     int64_t timestamp_ms,
     const Argb32VideoFrame& frame_view) {
+  if (!PopPendingRequest(request_id, timestamp_ms)) {
+    return Result::kInvalidParameter;
+  }
+  DispatchBuffer(adapter_->FillBuffer(frame_view, odd_size_mode_.load(),
+                                      buffer_cache_),
+                 timestamp_ms * rtc::kNumMicrosecsPerMillisec);
+  return Result::kSuccess;
+}
+
+Result ExternalVideoTrackSourceImpl::SubmitFrame(
+    const I420AVideoFrame& frame_view) {
+  // Timestamp the frame on submission, using the same clock as WebRTC.
+  const int64_t timestamp_us = rtc::TimeMicros();
+  rtc::CritScope lock(&push_lock_);
+  if (!adapter_ || adapter_->IsPullMode()) {
+    return Result::kInvalidOperation;
+  }
+  DispatchBuffer(adapter_->FillBuffer(frame_view, buffer_cache_), timestamp_us);
+  return Result::kSuccess;
+}
+
+Result ExternalVideoTrackSourceImpl::SubmitFrame(
+    const I420AVideoFrame& frame_view,
+    VideoFrameReleasedCallback release_callback) {
+  const int64_t timestamp_us = rtc::TimeMicros();
+  if (!IsValidI420AFrame(frame_view)) {
+    release_callback();
+    return Result::kInvalidParameter;
+  }
+  rtc::CritScope lock(&push_lock_);
+  if (!adapter_ || adapter_->IsPullMode()) {
+    release_callback();
+    return Result::kInvalidOperation;
+  }
+  DispatchBuffer(WrapI420AFrame(frame_view, std::move(release_callback)),
+                 timestamp_us);
+  return Result::kSuccess;
+}
+
+Result ExternalVideoTrackSourceImpl::SubmitFrame(
+    const Argb32VideoFrame& frame_view) {
+  const int64_t timestamp_us = rtc::TimeMicros();
+  rtc::CritScope lock(&push_lock_);
+  if (!adapter_ || adapter_->IsPullMode()) {
+    return Result::kInvalidOperation;
+  }
+  DispatchBuffer(adapter_->FillBuffer(frame_view, odd_size_mode_.load(),
+                                      buffer_cache_),
+                 timestamp_us);
+  return Result::kSuccess;
+}
+
+Result ExternalVideoTrackSourceImpl::SetFramerate(double framerate) {
+  {
+    rtc::CritScope lock(&push_lock_);
+    if (!adapter_ || !adapter_->IsPullMode()) {
+      return Result::kInvalidOperation;
+    }
+  }
+  if (!pacer_.SetFramerate(framerate)) {
+    return Result::kInvalidParameter;
+  }
+  return Result::kSuccess;
+}
+
+void ExternalVideoTrackSourceImpl::SetOddSizeMode(OddSizeMode mode) {
+  odd_size_mode_.store(mode);
+}
+
+FramePacerStats ExternalVideoTrackSourceImpl::GetPacingStats() const {
+  return pacer_.GetStats();
+}
+
+FrameRequestStats ExternalVideoTrackSourceImpl::GetRequestStats() const {
+  rtc::CritScope lock(&request_lock_);
+  return pending_requests_.GetStats();
+}
+
+I420BufferCacheStats ExternalVideoTrackSourceImpl::GetBufferCacheStats()
+    const {
+  return buffer_cache_.GetStats();
+}
+
+bool ExternalVideoTrackSourceImpl::PopPendingRequest(uint32_t request_id,
+                                                     int64_t& timestamp_ms) {
   // Validate pending request ID and retrieve frame timestamp
   int64_t timestamp_ms_original = -1;
   {
     rtc::CritScope lock(&request_lock_);
-    for (auto it = pending_requests_.begin(); it != pending_requests_.end();
-         ++it) {
-      if (it->first == request_id) {
-        timestamp_ms_original = it->second;
-        // Remove outdated requests, including current one
-        ++it;
-        pending_requests_.erase(pending_requests_.begin(), it);
-        break;
-      }
-    }
-    if (timestamp_ms_original < 0) {
-      return Result::kInvalidParameter;
+    if (!pending_requests_.Complete(request_id, timestamp_ms_original)) {
+      return false;
     }
   }
 
@@ -224,58 +412,56 @@ Result ExternalVideoTrackSourceImpl::CompleteRequest(
   if (timestamp_ms != timestamp_ms_original) {
     timestamp_ms = timestamp_ms_original;
   }
+  return true;
+}
 
+void ExternalVideoTrackSourceImpl::DispatchBuffer(
+    rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer,
+    int64_t timestamp_us) {
   // Create and dispatch the video frame
-  webrtc::VideoFrame frame{
-      webrtc::VideoFrame::Builder()
-          .set_video_frame_buffer(adapter_->FillBuffer(frame_view))
-          .set_timestamp_ms(timestamp_ms)
-          .build()};
+  webrtc::VideoFrame frame{webrtc::VideoFrame::Builder()
+                               .set_video_frame_buffer(std::move(buffer))
+                               .set_timestamp_us(timestamp_us)
+                               .build()};
   track_source_->DispatchFrame(frame);
-  return Result::kSuccess;
 }
 
 void ExternalVideoTrackSourceImpl::StopCapture() {
   if (track_source_->state_ != SourceState::kEnded) {
-    capture_thread_->Stop();
+    // This waits for the frame request in progress, if any.
+    CaptureScheduler::Instance().Unregister(this);
     track_source_->state_ = SourceState::kEnded;
   }
-  pending_requests_.clear();
+  rtc::CritScope lock(&request_lock_);
+  pending_requests_.Clear();
 }
 
 void ExternalVideoTrackSourceImpl::Shutdown() noexcept {
   StopCapture();
-  adapter_ = nullptr;
+  {
+    rtc::CritScope lock(&push_lock_);
+    adapter_ = nullptr;
+  }
+  buffer_cache_.Clear();
 }
 
-// Note - This is called on the capture thread only.
-void ExternalVideoTrackSourceImpl::OnMessage(rtc::Message* message) {
-  switch (message->message_id) {
-    case MSG_REQUEST_FRAME:
-      const int64_t now = rtc::TimeMillis();
-
-      // Request a frame from the external video source
-      uint32_t request_id = 0;
-      {
-        rtc::CritScope lock(&request_lock_);
-        // Discard an old request if no space available. This allows restarting
-        // after a long delay, otherwise skipping the request generally also
-        // prevent the user from calling CompleteFrame() to make some space for
-        // more. The queue is still useful for just-in-time or short delays.
-        if (pending_requests_.size() >= kMaxPendingRequestCount) {
-          pending_requests_.erase(pending_requests_.begin());
-        }
-        request_id = next_request_id_++;
-        pending_requests_.emplace_back(request_id, now);
-      }
-      adapter_->RequestFrame(*this, request_id, now);
-
-      // Schedule a new request for 30ms from now
-      //< TODO - this is unreliable and prone to drifting; figure out something
-      // better
-      capture_thread_->PostAt(RTC_FROM_HERE, now + 30, this, MSG_REQUEST_FRAME);
-      break;
+// Note - This is called on a capture scheduler worker thread, never
+// concurrently with itself.
+void ExternalVideoTrackSourceImpl::OnScheduledTick() noexcept {
+  const int64_t now_us = rtc::TimeMicros();
+  const int64_t now = now_us / rtc::kNumMicrosecsPerMillisec;
+
+  // Request a frame from the external video source
+  uint32_t request_id = 0;
+  {
+    rtc::CritScope lock(&request_lock_);
+    request_id = pending_requests_.Issue(now);
   }
+  adapter_->RequestFrame(*this, request_id, now);
+
+  // Schedule the next request at the next pacer deadline. Deadlines are derived
+  // from a fixed epoch, so late requests do not cause any drift.
+  CaptureScheduler::Instance().Schedule(this, pacer_.OnTick(now_us));
 }
 
 }  // namespace detail
@@ -292,6 +478,11 @@ RefPtr<ExternalVideoTrackSource> ExternalVideoTrackSource::createFromArgb32(
       std::make_unique<Argb32BufferAdapter>(std::move(video_source)));
 }
 
+RefPtr<ExternalVideoTrackSource> ExternalVideoTrackSource::createPushMode() {
+  return detail::ExternalVideoTrackSourceImpl::create(
+      std::make_unique<PushBufferAdapter>());
+}
+
 Result I420AVideoFrameRequest::CompleteRequest(
     const I420AVideoFrame& frame_view) {
   auto impl =
@@ -299,6 +490,15 @@ Result I420AVideoFrameRequest::CompleteRequest(
   return impl->CompleteRequest(request_id_, timestamp_ms_, frame_view);
 }
 
+Result I420AVideoFrameRequest::CompleteRequest(
+    const I420AVideoFrame& frame_view,
+    VideoFrameReleasedCallback release_callback) {
+  auto impl =
+      static_cast<detail::ExternalVideoTrackSourceImpl*>(&track_source_);
+  return impl->CompleteRequest(request_id_, timestamp_ms_, frame_view,
+                               std::move(release_callback));
+}
+
 Result Argb32VideoFrameRequest::CompleteRequest(
     const Argb32VideoFrame& frame_view) {
   auto impl =
@@ -3,6 +3,10 @@
 
 #pragma once
 
+#include "callback.h"
+#include "media/frame_pacer.h"
+#include "media/frame_request_tracker.h"
+#include "media/i420_buffer_cache.h"
 #include "mrs_errors.h"
 #include "refptr.h"
 #include "tracked_object.h"
@@ -13,6 +17,21 @@ namespace Microsoft::MixedReality::WebRTC {
 
 class ExternalVideoTrackSource;
 
+/// Conversion mode of ARGB32 frames with odd width or height, which cannot be
+/// exactly chroma-downsampled to I420.
+enum class OddSizeMode : int32_t {
+  /// Drop the last column and/or row to get even dimensions.
+  kCrop = 0,
+
+  /// Keep the frame dimensions, and compute the chroma samples of the last
+  /// column and/or row from the edge pixels only.
+  kPad = 1,
+};
+
+/// Callback invoked when a video frame submitted without copy is not used
+/// anymore, and the memory holding it can be reused.
+using VideoFrameReleasedCallback = Callback<>;
+
 /// Frame request for an external video source producing video frames encoded in
 /// I420 format, with optional Alpha (opacity) plane.
 struct I420AVideoFrameRequest {
@@ -28,6 +47,12 @@ struct I420AVideoFrameRequest {
   /// Complete the request by making the track source consume the given video
   /// frame and have it deliver the frame to all its video tracks.
   Result CompleteRequest(const I420AVideoFrame& frame_view);
+
+  /// Complete the request with a video frame read without copy, and invoke
+  /// |release_callback| once the frame memory is not used anymore.
+  /// See |ExternalVideoTrackSource::CompleteRequest()|.
+  Result CompleteRequest(const I420AVideoFrame& frame_view,
+                         VideoFrameReleasedCallback release_callback);
 };
 
 /// Custom video source producing video frames encoded in I420 format, with
@@ -88,6 +113,12 @@ class ExternalVideoTrackSource : public TrackedObject {
   static RefPtr<ExternalVideoTrackSource> createFromArgb32(
       RefPtr<Argb32ExternalVideoSource> video_source);
 
+  /// Create an external video track source in push mode. Instead of the track
+  /// source requesting frames at a fixed interval, the producer submits frames
+  /// with |SubmitFrame()| whenever they are ready, on its own clock. Frames are
+  /// timestamped on submission and dispatched immediately to the video tracks.
+  static RefPtr<ExternalVideoTrackSource> createPushMode();
+
   /// Start the video capture. This will begin to produce video frames and start
   /// calling the video frame callback.
   virtual void StartCapture() = 0;
@@ -99,6 +130,17 @@ class ExternalVideoTrackSource : public TrackedObject {
                                          int64_t timestamp_ms,
                                          const I420AVideoFrame& frame) = 0;
 
+  /// Complete a given video frame request with the provided I420A frame,
+  /// without copying it. The frame memory is read directly by the consumers of
+  /// the frame, and must remain valid and unchanged until |release_callback|
+  /// is invoked. The callback is invoked exactly once, from any thread, and
+  /// possibly before this call returns, including if the request fails.
+  virtual Result CompleteRequest(
+      uint32_t request_id,
+      int64_t timestamp_ms,
+      const I420AVideoFrame& frame,
+      VideoFrameReleasedCallback release_callback) = 0;
+
   /// Complete a given video frame request with the provided ARGB32 frame.
   /// The caller must know the source expects an ARGB32 frame; there is no check
   /// to confirm the source is I420A-based or ARGB32-based.
@@ -106,6 +148,44 @@ class ExternalVideoTrackSource : public TrackedObject {
                                          int64_t timestamp_ms,
                                          const Argb32VideoFrame& frame) = 0;
 
+  /// Submit a new I420A frame to a push-mode source. This fails with
+  /// |Result::kInvalidOperation| if the source is not in push mode, or was
+  /// shut down.
+  virtual Result SubmitFrame(const I420AVideoFrame& frame) = 0;
+
+  /// Submit a new I420A frame to a push-mode source, without copying it. See
+  /// the zero-copy variant of |CompleteRequest()| for the lifetime of the
+  /// frame memory and |release_callback|.
+  virtual Result SubmitFrame(const I420AVideoFrame& frame,
+                             VideoFrameReleasedCallback release_callback) = 0;
+
+  /// Submit a new ARGB32 frame to a push-mode source. This fails with
+  /// |Result::kInvalidOperation| if the source is not in push mode, or was
+  /// shut down.
+  virtual Result SubmitFrame(const Argb32VideoFrame& frame) = 0;
+
+  /// Set how ARGB32 frames with odd dimensions are converted to I420. The
+  /// default is |OddSizeMode::kCrop|.
+  virtual void SetOddSizeMode(OddSizeMode mode) = 0;
+
+  /// Set the target frame rate at which frames are requested from a pull-mode
+  /// source, in frames per second. Fractional frame rates like 29.97 are
+  /// supported. This fails with |Result::kInvalidOperation| for a push-mode
+  /// source, which produces frames at its own rate.
+  virtual Result SetFramerate(double framerate) = 0;
+
+  /// Get the statistics of the pacing of the frame requests of a pull-mode
+  /// source.
+  virtual FramePacerStats GetPacingStats() const = 0;
+
+  /// Get the statistics of the frame requests of a pull-mode source, and how
+  /// they were completed.
+  virtual FrameRequestStats GetRequestStats() const = 0;
+
+  /// Get the statistics of the reuse of the frame buffers of the source across
+  /// frames of identical dimensions.
+  virtual I420BufferCacheStats GetBufferCacheStats() const = 0;
+
   /// Stop the video capture. This will stop producing video frames.
   virtual void StopCapture() = 0;
 
@@ -3,11 +3,14 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "media/base/adaptedvideotracksource.h"
 
 #include "callback.h"
 #include "external_video_track_source.h"
 #include "interop_api.h"
+#include "media/capture_scheduler.h"
 
 namespace Microsoft::MixedReality::WebRTC::detail {
 
@@ -17,17 +20,24 @@ class BufferAdapter {
  public:
   virtual ~BufferAdapter() = default;
 
+  /// Check if frames are requested from the source (pull mode), or submitted
+  /// by the source whenever ready (push mode).
+  virtual bool IsPullMode() const noexcept { return true; }
+
   /// Request a new video frame with the specified request ID.
   virtual Result RequestFrame(ExternalVideoTrackSource& track_source,
                               uint32_t request_id,
                               int64_t time_ms) noexcept = 0;
 
-  /// Allocate a new video frame buffer with a video frame received from a
-  /// fulfilled frame request.
+  /// Fill a video frame buffer with a video frame received from a fulfilled
+  /// frame request, using a buffer from |buffer_cache| where possible.
   virtual rtc::scoped_refptr<webrtc::VideoFrameBuffer> FillBuffer(
-      const I420AVideoFrame& frame_view) = 0;
+      const I420AVideoFrame& frame_view,
+      I420BufferCache& buffer_cache) = 0;
   virtual rtc::scoped_refptr<webrtc::VideoFrameBuffer> FillBuffer(
-      const Argb32VideoFrame& frame_view) = 0;
+      const Argb32VideoFrame& frame_view,
+      OddSizeMode odd_size_mode,
+      I420BufferCache& buffer_cache) = 0;
 };
 
 /// Adapter to bridge a video track source to the underlying core
@@ -51,9 +61,7 @@ struct CustomTrackSourceAdapter : public rtc::AdaptedVideoTrackSource {
 /// Video track source acting as an adapter for an external source of raw
 /// frames.
 class ExternalVideoTrackSourceImpl : public ExternalVideoTrackSource,
-                                     // public rtc::AdaptedVideoTrackSource,
-                                     // public rtc::Runnable,
-                                     public rtc::MessageHandler {
+                                     public CaptureScheduler::Client {
  public:
   using SourceState = webrtc::MediaSourceInterface::SourceState;
 
@@ -74,11 +82,44 @@ class ExternalVideoTrackSourceImpl : public ExternalVideoTrackSource,
                          int64_t timestamp_ms,
                          const I420AVideoFrame& frame) override;
 
+  /// Complete a video frame request with a given I420A video frame, without
+  /// copying it.
+  Result CompleteRequest(
+      uint32_t request_id,
+      int64_t timestamp_ms,
+      const I420AVideoFrame& frame,
+      VideoFrameReleasedCallback release_callback) override;
+
   /// Complete a video frame request with a given ARGB32 video frame.
   Result CompleteRequest(uint32_t request_id,
                          int64_t timestamp_ms,
                          const Argb32VideoFrame& frame) override;
 
+  /// Submit a frame produced by a push-mode source.
+  Result SubmitFrame(const I420AVideoFrame& frame) override;
+
+  /// Submit a frame produced by a push-mode source, without copying it.
+  Result SubmitFrame(const I420AVideoFrame& frame,
+                     VideoFrameReleasedCallback release_callback) override;
+
+  /// Submit a frame produced by a push-mode source.
+  Result SubmitFrame(const Argb32VideoFrame& frame) override;
+
+  /// Set the target frame rate at which frames are requested.
+  Result SetFramerate(double framerate) override;
+
+  /// Set how ARGB32 frames with odd dimensions are converted to I420.
+  void SetOddSizeMode(OddSizeMode mode) override;
+
+  /// Get the frame request pacing statistics.
+  FramePacerStats GetPacingStats() const override;
+
+  /// Get the frame request tracking statistics.
+  FrameRequestStats GetRequestStats() const override;
+
+  /// Get the frame buffer reuse statistics.
+  I420BufferCacheStats GetBufferCacheStats() const override;
+
   /// Stop the video capture. This will stop producing video frames.
   void StopCapture();
 
@@ -89,24 +130,41 @@ class ExternalVideoTrackSourceImpl : public ExternalVideoTrackSource,
 
  protected:
   ExternalVideoTrackSourceImpl(std::unique_ptr<BufferAdapter> adapter);
-  // void Run(rtc::Thread* thread) override;
-  void OnMessage(rtc::Message* message) override;
+
+  /// Request a new frame from the source, and schedule the next request.
+  void OnScheduledTick() noexcept override;
+
+  /// Remove a pending request and all older ones, and retrieve the timestamp of
+  /// the removed request. Return |false| if the request is not pending.
+  bool PopPendingRequest(uint32_t request_id, int64_t& timestamp_ms);
+
+  /// Dispatch a frame buffer to the video tracks using this source.
+  void DispatchBuffer(rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer,
+                      int64_t timestamp_us);
 
   rtc::scoped_refptr<CustomTrackSourceAdapter> track_source_;
 
   std::unique_ptr<BufferAdapter> adapter_;
-  std::unique_ptr<rtc::Thread> capture_thread_;
 
-  /// Collection of pending frame requests
-  std::deque<std::pair<uint32_t, int64_t>> pending_requests_
-      RTC_GUARDED_BY(request_lock_);  //< TODO : circular buffer to avoid alloc
+  /// Scheduler of the frame requests in pull mode.
+  FramePacer pacer_;
 
-  /// Next available ID for a frame request.
-  uint32_t next_request_id_ RTC_GUARDED_BY(request_lock_){};
+  /// Conversion mode of ARGB32 frames with odd dimensions.
+  std::atomic<OddSizeMode> odd_size_mode_{OddSizeMode::kCrop};
+
+  /// Frame buffers reused across frames of identical dimensions.
+  I420BufferCache buffer_cache_;
+
+  /// Collection of pending frame requests
+  FrameRequestTracker pending_requests_ RTC_GUARDED_BY(request_lock_);
 
   /// Lock for frame requests.
   rtc::CriticalSection request_lock_;
 
+  /// Lock serializing the frames submitted in push mode with |Shutdown()|,
+  /// which releases |adapter_|.
+  rtc::CriticalSection push_lock_;
+
   /// Friendly track source name, for debugging.
   std::string name_;
 };
@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "frame_pacer.h"
+
+namespace Microsoft::MixedReality::WebRTC {
+
+FramePacer::FramePacer(double framerate) noexcept
+    : framerate_(framerate > 0.0 && framerate <= kMaxFramerate
+                     ? framerate
+                     : kDefaultFramerate) {}
+
+bool FramePacer::SetFramerate(double framerate) noexcept {
+  // Also rejects NaN.
+  if (!(framerate > 0.0 && framerate <= kMaxFramerate)) {
+    return false;
+  }
+  auto lock = std::scoped_lock{mutex_};
+  // Re-base the tick indices on the next deadline, otherwise changing the
+  // period would move all future deadlines, possibly far into the past.
+  epoch_us_ = DeadlineNoLock(next_tick_);
+  next_tick_ = 0;
+  framerate_ = framerate;
+  return true;
+}
+
+double FramePacer::GetFramerate() const noexcept {
+  auto lock = std::scoped_lock{mutex_};
+  return framerate_;
+}
+
+void FramePacer::Reset(int64_t start_us) noexcept {
+  auto lock = std::scoped_lock{mutex_};
+  epoch_us_ = start_us;
+  next_tick_ = 0;
+  tick_count_ = 0;
+  skipped_count_ = 0;
+  total_jitter_us_ = 0;
+  max_jitter_us_ = 0;
+  last_jitter_us_ = 0;
+}
+
+int64_t FramePacer::NextDeadlineUs() const noexcept {
+  auto lock = std::scoped_lock{mutex_};
+  return DeadlineNoLock(next_tick_);
+}
+
+int64_t FramePacer::OnTick(int64_t now_us) noexcept {
+  auto lock = std::scoped_lock{mutex_};
+
+  // Record the jitter of the tick which just fired
+  const int64_t jitter_us = now_us - DeadlineNoLock(next_tick_);
+  const int64_t abs_jitter_us = (jitter_us >= 0 ? jitter_us : -jitter_us);
+  ++tick_count_;
+  total_jitter_us_ += static_cast<uint64_t>(abs_jitter_us);
+  max_jitter_us_ = std::max(max_jitter_us_, abs_jitter_us);
+  last_jitter_us_ = jitter_us;
+
+  // Advance to the next deadline. If the tick fired so late that the next
+  // deadline(s) already passed, skip directly to the first future one instead
+  // of firing several ticks in a burst.
+  ++next_tick_;
+  if (DeadlineNoLock(next_tick_) <= now_us) {
+    const double elapsed_us = static_cast<double>(now_us - epoch_us_);
+    int64_t tick = static_cast<int64_t>(elapsed_us * framerate_ / 1e6) + 1;
+    // Guard against rounding in the above computation.
+    while (DeadlineNoLock(tick) <= now_us) {
+      ++tick;
+    }
+    skipped_count_ += static_cast<uint64_t>(tick - next_tick_);
+    next_tick_ = tick;
+  }
+  return DeadlineNoLock(next_tick_);
+}
+
+FramePacerStats FramePacer::GetStats() const noexcept {
+  auto lock = std::scoped_lock{mutex_};
+  FramePacerStats stats;
+  stats.framerate = framerate_;
+  stats.tick_count = tick_count_;
+  stats.skipped_count = skipped_count_;
+  stats.mean_jitter_us =
+      (tick_count_ > 0 ? static_cast<int64_t>(total_jitter_us_ / tick_count_)
+                       : 0);
+  stats.max_jitter_us = max_jitter_us_;
+  stats.last_jitter_us = last_jitter_us_;
+  return stats;
+}
+
+int64_t FramePacer::DeadlineNoLock(int64_t tick_index) const noexcept {
+  // Compute each deadline from the epoch rather than from the previous one, so
+  // that rounding errors do not accumulate.
+  return epoch_us_ +
+         std::llround(static_cast<double>(tick_index) * 1e6 / framerate_);
+}
+
+}  // namespace Microsoft::MixedReality::WebRTC
@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+
+#include "rtc_base/thread_annotations.h"
+
+namespace Microsoft::MixedReality::WebRTC {
+
+/// Snapshot of the statistics of a |FramePacer|.
+struct FramePacerStats {
+  /// Target frame rate, in frames per second.
+  double framerate{0.0};
+
+  /// Number of ticks which fired since the pacer was last reset.
+  uint64_t tick_count{0};
+
+  /// Number of ticks skipped because the previous tick fired too late.
+  uint64_t skipped_count{0};
+
+  /// Average and maximum absolute difference between the time a tick fired
+  /// and its deadline, in microseconds.
+  int64_t mean_jitter_us{0};
+  int64_t max_jitter_us{0};
+
+  /// Signed difference between the time the most recent tick fired and its
+  /// deadline, in microseconds. Positive values mean the tick fired late.
+  int64_t last_jitter_us{0};
+};
+
+/// Drift-free tick scheduler for a fixed target frame rate.
+///
+/// Deadlines are computed from a fixed epoch as |epoch + n / framerate|, so
+/// that scheduling inaccuracies do not accumulate over time, and fractional
+/// frame rates like 29.97 FPS are paced exactly on average. When a tick fires
+/// so late that one or more subsequent deadlines already passed, those ticks
+/// are skipped instead of being fired back-to-back to catch up.
+///
+/// This class is thread-safe.
+class FramePacer {
+ public:
+  /// Default target frame rate, in frames per second.
+  static constexpr double kDefaultFramerate = 30.0;
+
+  /// Maximum target frame rate, in frames per second.
+  static constexpr double kMaxFramerate = 240.0;
+
+  explicit FramePacer(double framerate = kDefaultFramerate) noexcept;
+
+  /// Change the target frame rate. This restarts the pacing from the deadline
+  /// of the next tick, so that the tick already scheduled is not affected.
+  /// Return |false| if |framerate| is not in the range (0, kMaxFramerate].
+  bool SetFramerate(double framerate) noexcept;
+
+  /// Get the current target frame rate.
+  double GetFramerate() const noexcept;
+
+  /// Restart the pacing with the first tick deadline at |start_us|, and clear
+  /// the statistics.
+  void Reset(int64_t start_us) noexcept;
+
+  /// Get the deadline of the next tick, in microseconds.
+  int64_t NextDeadlineUs() const noexcept;
+
+  /// Record that the next tick fired at time |now_us|, and advance to the
+  /// following tick deadline not already in the past, which is returned.
+  int64_t OnTick(int64_t now_us) noexcept;
+
+  /// Get a snapshot of the pacing statistics.
+  FramePacerStats GetStats() const noexcept;
+
+ private:
+  /// Compute the deadline of the tick with the given index. The caller must
+  /// hold |mutex_|.
+  int64_t DeadlineNoLock(int64_t tick_index) const noexcept;
+
+  mutable std::mutex mutex_;
+
+  /// Target frame rate, in frames per second.
+  double framerate_ RTC_GUARDED_BY(mutex_);
+
+  /// Time of the tick with index zero, in microseconds.
+  int64_t epoch_us_ RTC_GUARDED_BY(mutex_){0};
+
+  /// Index of the next tick, relative to |epoch_us_|.
+  int64_t next_tick_ RTC_GUARDED_BY(mutex_){0};
+
+  uint64_t tick_count_ RTC_GUARDED_BY(mutex_){0};
+  uint64_t skipped_count_ RTC_GUARDED_BY(mutex_){0};
+  uint64_t total_jitter_us_ RTC_GUARDED_BY(mutex_){0};
+  int64_t max_jitter_us_ RTC_GUARDED_BY(mutex_){0};
+  int64_t last_jitter_us_ RTC_GUARDED_BY(mutex_){0};
+};
+
+}  // namespace Microsoft::MixedReality::WebRTC
@@ -0,0 +1,55 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include "frame_request_tracker.h"
+
+namespace Microsoft::MixedReality::WebRTC {
+
+uint32_t FrameRequestTracker::Issue(int64_t timestamp_ms) noexcept {
+  // Discard the oldest request if no space available. This allows restarting
+  // after a long delay, otherwise skipping the request generally also prevent
+  // the user from completing an old request to make some space for more.
+  if (OutstandingCount() >= kCapacity) {
+    ++oldest_id_;
+    ++expired_count_;
+  }
+  const uint32_t request_id = next_id_++;
+  timestamps_ms_[request_id & (kCapacity - 1)] = timestamp_ms;
+  return request_id;
+}
+
+bool FrameRequestTracker::Complete(uint32_t request_id,
+                                   int64_t& timestamp_ms) noexcept {
+  // Position of the request in the window of outstanding requests. Requests
+  // older than the window wrap around to large values, and are rejected too.
+  const uint32_t offset = request_id - oldest_id_;
+  if (offset >= OutstandingCount()) {
+    ++rejected_count_;
+    return false;
+  }
+  timestamp_ms = timestamps_ms_[request_id & (kCapacity - 1)];
+
+  // Retire the request, and expire all the older ones
+  expired_count_ += offset;
+  ++completed_count_;
+  oldest_id_ = request_id + 1;
+  return true;
+}
+
+void FrameRequestTracker::Clear() noexcept {
+  expired_count_ += OutstandingCount();
+  oldest_id_ = next_id_;
+}
+
+FrameRequestStats FrameRequestTracker::GetStats() const noexcept {
+  FrameRequestStats stats;
+  stats.outstanding_count = OutstandingCount();
+  stats.completed_count = completed_count_;
+  stats.expired_count = expired_count_;
+  stats.rejected_count = rejected_count_;
+  return stats;
+}
+
+}  // namespace Microsoft::MixedReality::WebRTC
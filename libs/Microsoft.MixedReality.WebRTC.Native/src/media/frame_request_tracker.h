@@ -0,0 +1,82 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace Microsoft::MixedReality::WebRTC {
+
+/// Snapshot of the statistics of a |FrameRequestTracker|.
+struct FrameRequestStats {
+  /// Number of requests issued and neither completed nor expired yet.
+  uint64_t outstanding_count{0};
+
+  /// Number of requests completed.
+  uint64_t completed_count{0};
+
+  /// Number of requests which expired without being completed, either because
+  /// a more recent request was completed first, or because too many requests
+  /// were outstanding.
+  uint64_t expired_count{0};
+
+  /// Number of attempts to complete a request which was not outstanding, for
+  /// example because it was already completed or had expired.
+  uint64_t rejected_count{0};
+};
+
+/// Fixed-capacity tracker of the outstanding frame requests of an external
+/// video track source.
+///
+/// Request IDs are allocated sequentially, so the outstanding requests always
+/// form a contiguous window of IDs, from the oldest one not yet retired to the
+/// most recently issued one. The requests are stored in a ring buffer indexed
+/// by their ID modulo the capacity, which makes issuing, looking up and
+/// retiring a request O(1) without any allocation.
+///
+/// This class is not thread-safe.
+class FrameRequestTracker {
+ public:
+  /// Maximum number of outstanding requests. Issuing a request when that many
+  /// are already outstanding expires the oldest one. This is a power of two, so
+  /// that the ring buffer index is a simple mask of the request ID.
+  static constexpr uint32_t kCapacity = 64;
+  static_assert((kCapacity & (kCapacity - 1)) == 0,
+                "Capacity must be a power of two.");
+
+  /// Issue a new request made at time |timestamp_ms| and return its ID.
+  uint32_t Issue(int64_t timestamp_ms) noexcept;
+
+  /// Complete the outstanding request with the given ID, retrieving its
+  /// timestamp. All outstanding requests older than it expire. Return |false|
+  /// and count a rejected request if the request is not outstanding.
+  bool Complete(uint32_t request_id, int64_t& timestamp_ms) noexcept;
+
+  /// Expire all outstanding requests.
+  void Clear() noexcept;
+
+  /// Get a snapshot of the request statistics.
+  FrameRequestStats GetStats() const noexcept;
+
+ private:
+  /// Number of outstanding requests. Unsigned arithmetic makes this correct
+  /// even after the request IDs wrap around.
+  uint32_t OutstandingCount() const noexcept { return next_id_ - oldest_id_; }
+
+  /// Timestamps of the outstanding requests, indexed by request ID modulo
+  /// |kCapacity|.
+  std::array<int64_t, kCapacity> timestamps_ms_{};
+
+  /// ID of the oldest outstanding request, if any.
+  uint32_t oldest_id_{0};
+
+  /// ID of the next request to be issued.
+  uint32_t next_id_{0};
+
+  uint64_t completed_count_{0};
+  uint64_t expired_count_{0};
+  uint64_t rejected_count_{0};
+};
+
+}  // namespace Microsoft::MixedReality::WebRTC
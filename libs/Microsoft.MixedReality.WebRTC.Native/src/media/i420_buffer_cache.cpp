@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include "i420_buffer_cache.h"
+
+namespace Microsoft::MixedReality::WebRTC {
+
+rtc::scoped_refptr<PooledI420Buffer> I420BufferCache::GetBuffer(
+    int width,
+    int height) noexcept {
+  auto lock = std::scoped_lock{mutex_};
+
+  // Discard the cached buffers on resolution change. Buffers still in use are
+  // returned to the global pool once released.
+  if ((width != width_) || (height != height_)) {
+    if (width_ > 0) {
+      ++reconfiguration_count_;
+    }
+    buffers_.clear();
+    buffers_.reserve(kMaxBufferCount);
+    width_ = width;
+    height_ = height;
+  }
+
+  // Reuse a buffer not referenced anymore outside of the cache. No other
+  // thread can add a reference to it, so it is safe to hand it out.
+  for (auto&& buffer : buffers_) {
+    if (buffer->HasOneRef()) {
+      ++reuse_count_;
+      return buffer;
+    }
+  }
+
+  ++allocation_count_;
+  rtc::scoped_refptr<Buffer> buffer =
+      FrameBufferPool::Instance().CreateI420Buffer(width, height);
+  if (buffers_.size() < kMaxBufferCount) {
+    buffers_.push_back(buffer);
+  }
+  return buffer;
+}
+
+void I420BufferCache::Clear() noexcept {
+  auto lock = std::scoped_lock{mutex_};
+  buffers_.clear();
+}
+
+I420BufferCacheStats I420BufferCache::GetStats() const noexcept {
+  auto lock = std::scoped_lock{mutex_};
+  I420BufferCacheStats stats;
+  stats.width = width_;
+  stats.height = height_;
+  stats.reuse_count = reuse_count_;
+  stats.allocation_count = allocation_count_;
+  stats.reconfiguration_count = reconfiguration_count_;
+  return stats;
+}
+
+}  // namespace Microsoft::MixedReality::WebRTC
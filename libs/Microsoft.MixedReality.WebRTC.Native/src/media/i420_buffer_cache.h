@@ -0,0 +1,76 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include "frame_buffer_pool.h"
+
+namespace Microsoft::MixedReality::WebRTC {
+
+/// Snapshot of the statistics of an |I420BufferCache|.
+struct I420BufferCacheStats {
+  /// Width and height of the buffers currently cached, in pixels, or zero if
+  /// no buffer was requested yet.
+  int width{0};
+  int height{0};
+
+  /// Number of buffers served from the cache, without any allocation.
+  uint64_t reuse_count{0};
+
+  /// Number of buffers allocated, because all cached buffers were still in use.
+  uint64_t allocation_count{0};
+
+  /// Number of times the cached buffers were discarded because the frame
+  /// dimensions changed.
+  uint64_t reconfiguration_count{0};
+};
+
+/// Cache of the I420 frame buffers of a single video source, for sources whose
+/// frames have the same dimensions most of the time.
+///
+/// The cache remembers the dimensions of the last frame, and keeps the buffers
+/// of that size it handed out. A buffer is reused as soon as the cache holds
+/// the only reference left to it, that is once the encoder and the local video
+/// sinks released the frame it was holding. This avoids any allocation and
+/// any access to the global |FrameBufferPool| in the steady state. Buffers are
+/// only discarded and reallocated when the frame dimensions change.
+///
+/// This class is thread-safe.
+class I420BufferCache {
+ public:
+  /// Maximum number of buffers kept in the cache. This is the maximum number of
+  /// frames of a source in flight in the encoding pipeline before new buffers
+  /// are allocated without being cached.
+  static constexpr size_t kMaxBufferCount = 8;
+
+  /// Get an I420 buffer of the given dimensions, whose content is undefined.
+  rtc::scoped_refptr<PooledI420Buffer> GetBuffer(int width,
+                                                 int height) noexcept;
+
+  /// Release all cached buffers.
+  void Clear() noexcept;
+
+  /// Get a snapshot of the cache statistics.
+  I420BufferCacheStats GetStats() const noexcept;
+
+ private:
+  using Buffer = rtc::RefCountedObject<PooledI420Buffer>;
+
+  mutable std::mutex mutex_;
+
+  /// Dimensions of the cached buffers.
+  int width_ RTC_GUARDED_BY(mutex_){0};
+  int height_ RTC_GUARDED_BY(mutex_){0};
+
+  /// Cached buffers, either in use or free for reuse.
+  std::vector<rtc::scoped_refptr<Buffer>> buffers_ RTC_GUARDED_BY(mutex_);
+
+  uint64_t reuse_count_ RTC_GUARDED_BY(mutex_){0};
+  uint64_t allocation_count_ RTC_GUARDED_BY(mutex_){0};
+  uint64_t reconfiguration_count_ RTC_GUARDED_BY(mutex_){0};
+};
+
+}  // namespace Microsoft::MixedReality::WebRTC
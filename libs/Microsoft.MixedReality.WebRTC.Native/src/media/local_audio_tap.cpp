@@ -0,0 +1,97 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include <algorithm>
+
+#include "modules/audio_processing/audio_buffer.h"
+
+#include "audio_frame_observer.h"
+#include "local_audio_tap.h"
+
+namespace Microsoft::MixedReality::WebRTC {
+
+/// Capture post-processing step of the audio processing module, forwarding
+/// the captured audio to the tap without modifying it.
+class LocalAudioTap::CaptureProcessing : public webrtc::CustomProcessing {
+ public:
+  explicit CaptureProcessing(LocalAudioTap& tap) noexcept : tap_(tap) {}
+
+  void Initialize(int /*sample_rate_hz*/, int /*num_channels*/) override {}
+
+  void Process(webrtc::AudioBuffer* audio) override { tap_.Deliver(audio); }
+
+  std::string ToString() const override { return "LocalAudioTap"; }
+
+ private:
+  LocalAudioTap& tap_;
+};
+
+LocalAudioTap& LocalAudioTap::Instance() noexcept {
+  // Intentionally leaked; see declaration.
+  static LocalAudioTap* const instance = new LocalAudioTap();
+  return *instance;
+}
+
+std::unique_ptr<webrtc::CustomProcessing>
+LocalAudioTap::CreateCaptureProcessing() {
+  return std::make_unique<CaptureProcessing>(*this);
+}
+
+void LocalAudioTap::AddObserver(AudioFrameObserver* observer) noexcept {
+  auto lock = std::scoped_lock{mutex_};
+  if (std::find(observers_.begin(), observers_.end(), observer) ==
+      observers_.end()) {
+    observers_.push_back(observer);
+  }
+}
+
+void LocalAudioTap::RemoveObserver(AudioFrameObserver* observer) noexcept {
+  auto lock = std::scoped_lock{mutex_};
+  observers_.erase(std::remove(observers_.begin(), observers_.end(), observer),
+                   observers_.end());
+}
+
+void LocalAudioTap::Deliver(webrtc::AudioBuffer* audio) noexcept {
+  auto lock = std::scoped_lock{mutex_};
+  if (observers_.empty()) {
+    return;
+  }
+  const size_t channel_count = audio->num_channels();
+  const size_t sample_count = audio->num_frames();
+  const int16_t* const* channels = audio->channels_const();
+
+  // The channels of the audio processing module are stored in consecutive
+  // planes, so the first one gives a view over the entire frame. Otherwise
+  // gather them into a single buffer.
+  const int16_t* data = channels[0];
+  for (size_t c = 1; c < channel_count; ++c) {
+    if (channels[c] != channels[0] + c * sample_count) {
+      planes_.resize(channel_count * sample_count);
+      for (size_t i = 0; i < channel_count; ++i) {
+        std::copy_n(channels[i], sample_count,
+                    planes_.data() + i * sample_count);
+      }
+      data = planes_.data();
+      break;
+    }
+  }
+
+  // The audio processing module always processes 10 ms chunks. A single plane
+  // is also a valid interleaved frame, which is what most consumers expect.
+  AudioFrame frame;
+  frame.data_ = data;
+  frame.bits_per_sample_ = 16;
+  frame.sampling_rate_hz_ = static_cast<uint32_t>(sample_count * 100);
+  frame.channel_count_ = static_cast<uint32_t>(channel_count);
+  frame.sample_count_ = static_cast<uint32_t>(sample_count);
+  frame.sample_format_ = AudioSampleFormat::kInt16;
+  frame.sample_layout_ = (channel_count > 1 ? AudioSampleLayout::kPlanar
+                                            : AudioSampleLayout::kInterleaved);
+  for (AudioFrameObserver* observer : observers_) {
+    observer->OnFrame(frame);
+  }
+}
+
+}  // namespace Microsoft::MixedReality::WebRTC
@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "modules/audio_processing/include/audio_processing.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace Microsoft::MixedReality::WebRTC {
+
+class AudioFrameObserver;
+
+/// Tap on the local audio capture pipeline, delivering the captured audio to
+/// the local audio frame observers of the peer connections.
+///
+/// The local audio track of a peer connection is backed by the audio device
+/// module and audio processing module shared by the whole peer connection
+/// factory, and its |AddSink()| is a no-op. Instead, the tap hooks into the
+/// audio processing module as a capture post-processing step, so observers
+/// receive the captured audio right after echo cancellation, noise suppression
+/// and gain control, without opening the capture device a second time.
+///
+/// Frames are delivered as a view over the buffer of the audio processing
+/// module, in 16-bit planar samples, without any copy.
+class LocalAudioTap {
+ public:
+  /// Get the global tap instance shared by all peer connections. The global
+  /// tap is never destroyed; see |FrameBufferPool::Instance()|.
+  static LocalAudioTap& Instance() noexcept;
+
+  /// Create the capture post-processing step to install into the audio
+  /// processing module of the peer connection factory. All the steps created
+  /// dispatch to the observers of this tap.
+  std::unique_ptr<webrtc::CustomProcessing> CreateCaptureProcessing();
+
+  /// Add an observer to deliver captured frames to.
+  void AddObserver(AudioFrameObserver* observer) noexcept;
+
+  /// Remove an observer. This waits for any frame currently being delivered,
+  /// so that the observer can be safely destroyed once this returns.
+  void RemoveObserver(AudioFrameObserver* observer) noexcept;
+
+ protected:
+  class CaptureProcessing;
+
+  /// Deliver a captured frame to all observers.
+  void Deliver(webrtc::AudioBuffer* audio) noexcept;
+
+ private:
+  /// Mutex for |observers_|, held while delivering a frame. The observers are
+  /// only added or removed when a local audio track is, so this is virtually
+  /// never contended on the capture thread.
+  std::mutex mutex_;
+  std::vector<AudioFrameObserver*> observers_ RTC_GUARDED_BY(mutex_);
+
+  /// Buffer used to gather the channels of the captured audio if they are not
+  /// contiguous in the buffer of the audio processing module. Only accessed
+  /// from the capture thread, under |mutex_|.
+  std::vector<int16_t> planes_ RTC_GUARDED_BY(mutex_);
+};
+
+}  // namespace Microsoft::MixedReality::WebRTC
@@ -7,6 +7,7 @@
 
 #include "audio_frame_observer.h"
 #include "data_channel.h"
+#include "media/local_audio_tap.h"
 #include "media/local_video_track.h"
 #include "peer_connection.h"
 #include "sdp_utils.h"
@@ -16,6 +17,7 @@
 #include "interop/global_factory.h"
 #include "interop_api.h"
 
+#include <algorithm>
 #include <functional>
 
 #if defined(_M_IX86) /* x86 */ && defined(WINAPI_FAMILY) && \
@@ -146,6 +148,174 @@ Microsoft::MixedReality::WebRTC::Error ErrorFromRTCError(
       ResultFromRTCErrorType(error.type()), error.message());
 }
 
+/// Observer of the frames of a single remote track, or registration waiting for
+/// that track to be added.
+template <typename Track, typename Observer, typename FrameCallback>
+struct RemoteTrackObserver {
+  using track_type = Track;
+  using observer_type = Observer;
+
+  /// Name the user registered a callback with, either the track ID or the MID
+  /// of the transceiver of the track, or empty if none.
+  std::string name_;
+
+  /// Remote track ID, or empty if the track was not added yet.
+  std::string track_id_;
+
+  /// MID of the transceiver of the track, or empty if unknown (Plan B).
+  std::string mid_;
+
+  /// Registered callback, applied to |observer_| once the track is added.
+  FrameCallback callback_;
+
+  /// Remote track and its frame observer, if the track is added. The observer
+  /// is shared so that it can be configured without holding the lock which
+  /// protects this entry.
+  rtc::scoped_refptr<Track> track_;
+  std::shared_ptr<Observer> observer_;
+
+  bool Matches(std::string_view name) const noexcept {
+    return ((name == name_) || (!track_id_.empty() && (name == track_id_)) ||
+            (!mid_.empty() && (name == mid_)));
+  }
+};
+
+struct RemoteVideoTrackObserver
+    : RemoteTrackObserver<webrtc::VideoTrackInterface,
+                          VideoFrameObserver,
+                          TrackVideoFrameHandleReadyCallback> {
+  /// Delivery configuration, applied to |observer_| once the track is added.
+  VideoFrameDeliveryConfig config_;
+
+  /// Check if the user registered anything to apply to this track.
+  bool HasRegistration() const noexcept {
+    return (callback_ || config_.async_);
+  }
+};
+
+struct RemoteAudioTrackObserver
+    : RemoteTrackObserver<webrtc::AudioTrackInterface,
+                          AudioFrameObserver,
+                          TrackAudioFrameReadyCallback> {
+  /// Read buffer and output format, applied to |observer_| once the track is
+  /// added.
+  RefPtr<AudioReadBuffer> read_buffer_;
+  std::optional<AudioOutputFormat> output_format_;
+
+  /// Check if the user registered anything to apply to this track.
+  bool HasRegistration() const noexcept {
+    return (callback_ || read_buffer_ || output_format_);
+  }
+};
+
+/// Find the observer of the remote track with the given track ID or MID, or
+/// null if none.
+template <typename T>
+T* FindRemoteTrackObserver(const std::vector<std::unique_ptr<T>>& observers,
+                           std::string_view track_name) noexcept {
+  for (auto&& entry : observers) {
+    if (entry->Matches(track_name)) {
+      return entry.get();
+    }
+  }
+  return nullptr;
+}
+
+/// Find the observer of the remote track with the given track ID or MID, or
+/// add a registration waiting for that track if none.
+template <typename T>
+T& FindOrAddRemoteTrackObserver(std::vector<std::unique_ptr<T>>& observers,
+                                std::string_view track_name) {
+  if (T* entry = FindRemoteTrackObserver(observers, track_name)) {
+    return *entry;
+  }
+  observers.push_back(std::make_unique<T>());
+  T& entry = *observers.back();
+  entry.name_ = std::string(track_name);
+  return entry;
+}
+
+/// Create the observer of a remote track being added, reusing the registration
+/// made for that track before it was added, if any. The caller attaches the
+/// observer to the track.
+template <typename T>
+T& BindRemoteTrackObserver(std::vector<std::unique_ptr<T>>& observers,
+                           typename T::track_type* track,
+                           std::string mid) {
+  T* entry = nullptr;
+  for (auto&& it : observers) {
+    if (!it->track_ &&
+        (it->Matches(track->id()) || (!mid.empty() && it->Matches(mid)))) {
+      entry = it.get();
+      break;
+    }
+  }
+  if (!entry) {
+    observers.push_back(std::make_unique<T>());
+    entry = observers.back().get();
+  }
+  entry->track_id_ = track->id();
+  entry->mid_ = std::move(mid);
+  entry->track_ = track;
+  entry->observer_ =
+      std::make_shared<typename T::observer_type>(entry->track_id_);
+  return *entry;
+}
+
+/// Detach and destroy the observer of a remote track being removed. Keep the
+/// user registration, if any, in case the track is added again.
+template <typename T>
+void UnbindRemoteTrackObserver(std::vector<std::unique_ptr<T>>& observers,
+                               const webrtc::MediaStreamTrackInterface* track) {
+  auto it = std::find_if(observers.begin(), observers.end(),
+                         [track](const auto& entry) {
+                           return (entry->track_.get() == track);
+                         });
+  if (it == observers.end()) {
+    return;
+  }
+  T& entry = **it;
+  entry.track_->RemoveSink(entry.observer_.get());
+  entry.track_ = nullptr;
+  entry.observer_ = nullptr;
+  if (entry.name_.empty()) {
+    observers.erase(it);
+  } else {
+    entry.track_id_.clear();
+    entry.mid_.clear();
+  }
+}
+
+/// Remove the user registration of |entry| if nothing is left registered for
+/// its track. The entry is erased, unless it still observes an added track, in
+/// which case it is erased once that track is removed.
+template <typename T>
+void RemoveRemoteTrackRegistration(std::vector<std::unique_ptr<T>>& observers,
+                                   T& entry) {
+  if (entry.HasRegistration()) {
+    return;
+  }
+  if (entry.track_) {
+    entry.name_.clear();
+    return;
+  }
+  observers.erase(std::find_if(
+      observers.begin(), observers.end(),
+      [&entry](const auto& it) { return (it.get() == &entry); }));
+}
+
+/// Detach and destroy the observers of all remote tracks, as well as all the
+/// user registrations.
+template <typename T>
+void ClearRemoteTrackObservers(std::vector<std::unique_ptr<T>>& observers) {
+  for (auto&& entry : observers) {
+    if (entry->track_) {
+      entry->track_->RemoveSink(entry->observer_.get());
+    }
+  }
+  observers.clear();
+}
+
 /// Implementation of PeerConnection, which also implements
 /// PeerConnectionObserver at the same time to simplify interaction with
 /// the underlying implementation object.
@@ -256,6 +426,60 @@ class PeerConnectionImpl : public PeerConnection,
     }
   }
 
+  void RegisterRemoteVideoFrameCallback(
+      Nv12FrameReadyCallback callback) noexcept override {
+    if (remote_video_observer_) {
+      remote_video_observer_->SetCallback(std::move(callback));
+    }
+  }
+
+  void RegisterRemoteVideoFrameCallback(
+      Rgba32FrameReadyCallback callback) noexcept override {
+    if (remote_video_observer_) {
+      remote_video_observer_->SetCallback(std::move(callback));
+    }
+  }
+
+  void RegisterRemoteVideoFrameCallback(
+      Bgra32FrameReadyCallback callback) noexcept override {
+    if (remote_video_observer_) {
+      remote_video_observer_->SetCallback(std::move(callback));
+    }
+  }
+
+  void RegisterRemoteVideoFrameCallback(
+      VideoFrameHandleReadyCallback callback) noexcept override {
+    if (remote_video_observer_) {
+      remote_video_observer_->SetCallback(std::move(callback));
+    }
+  }
+
+  Result SetRemoteVideoFrameDeliveryConfig(
+      const VideoFrameDeliveryConfig& config) noexcept override {
+    if (!remote_video_observer_) {
+      return Result::kInvalidOperation;
+    }
+    return remote_video_observer_->SetDeliveryConfig(config);
+  }
+
+  VideoFrameDeliveryStats GetRemoteVideoFrameDeliveryStats()
+      const noexcept override {
+    if (!remote_video_observer_) {
+      return {};
+    }
+    return remote_video_observer_->GetDeliveryStats();
+  }
+
+  void RegisterRemoteVideoTrackFrameCallback(
+      std::string_view track_name,
+      TrackVideoFrameHandleReadyCallback callback) noexcept override;
+  Result SetRemoteVideoTrackFrameDeliveryConfig(
+      std::string_view track_name,
+      const VideoFrameDeliveryConfig& config) noexcept override;
+  Result GetRemoteVideoTrackFrameDeliveryStats(
+      std::string_view track_name,
+      VideoFrameDeliveryStats& stats) const noexcept override;
+
   ErrorOr<RefPtr<LocalVideoTrack>> AddLocalVideoTrack(
       rtc::scoped_refptr<webrtc::VideoTrackInterface>
           video_track) noexcept override;
@@ -278,8 +502,35 @@ class PeerConnectionImpl : public PeerConnection,
     }
   }
 
+  void RegisterRemoteAudioTrackFrameCallback(
+      std::string_view track_name,
+      TrackAudioFrameReadyCallback callback) noexcept override;
+
+  void SetRemoteAudioTrackReadBuffer(
+      std::string_view track_name,
+      RefPtr<AudioReadBuffer> buffer) noexcept override;
+
+  Result SetRemoteAudioOutputFormat(
+      const std::optional<AudioOutputFormat>& format) noexcept override {
+    if (!remote_audio_observer_) {
+      return Result::kInvalidOperation;
+    }
+    if (!format) {
+      remote_audio_observer_->ClearOutputFormat();
+      return Result::kSuccess;
+    }
+    return remote_audio_observer_->SetOutputFormat(*format);
+  }
+
+  Result SetRemoteAudioTrackOutputFormat(
+      std::string_view track_name,
+      const std::optional<AudioOutputFormat>& format) noexcept override;
+
   bool AddLocalAudioTrack(rtc::scoped_refptr<webrtc::AudioTrackInterface>
                               audio_track) noexcept override;
+  bool AddLocalAudioTrackFromExternalSource(
+      rtc::scoped_refptr<webrtc::AudioTrackInterface> audio_track) noexcept
+      override;
   void RemoveLocalAudioTrack() noexcept override;
   void SetLocalAudioTrackEnabled(bool enabled = true) noexcept override;
   bool IsLocalAudioTrackEnabled() const noexcept override;
@@ -440,6 +691,10 @@ class PeerConnectionImpl : public PeerConnection,
 
   rtc::scoped_refptr<webrtc::AudioTrackInterface> local_audio_track_;
   rtc::scoped_refptr<webrtc::RtpSenderInterface> local_audio_sender_;
+
+  /// The local audio track is backed by an external audio track source, and
+  /// the recording from the audio capture device is paused.
+  bool local_audio_external_{false};
   std::vector<rtc::scoped_refptr<webrtc::MediaStreamInterface>> remote_streams_;
 
   /// Collection of all local video tracks associated with this peer connection.
@@ -472,6 +727,25 @@ class PeerConnectionImpl : public PeerConnection,
   std::unique_ptr<AudioFrameObserver> remote_audio_observer_;
   std::unique_ptr<VideoFrameObserver> remote_video_observer_;
 
+  /// Get the MID of the transceiver associated with a remote track receiver,
+  /// or an empty string if unknown.
+  std::string GetReceiverMid(
+      const webrtc::RtpReceiverInterface* receiver) const noexcept;
+
+  /// Per-track observers of the remote video and audio tracks. Those are
+  /// generally small, so a vector is faster than any map.
+  std::vector<std::unique_ptr<RemoteVideoTrackObserver>>
+      remote_video_track_observers_
+          RTC_GUARDED_BY(remote_track_observers_mutex_);
+  std::vector<std::unique_ptr<RemoteAudioTrackObserver>>
+      remote_audio_track_observers_
+          RTC_GUARDED_BY(remote_track_observers_mutex_);
+
+  /// Mutex for the per-track observers of the remote tracks. This is only
+  /// taken when tracks or callbacks are added or removed; frames are
+  /// delivered without holding it.
+  mutable std::mutex remote_track_observers_mutex_;
+
   /// Flag to indicate if SCTP was negotiated during the initial SDP handshake
   /// (m=application), which allows subsequently to use data channels. If this
   /// is false then data channels will never connnect. This is set to true if a
@@ -673,37 +947,71 @@ bool PeerConnectionImpl::AddLocalAudioTrack(
   }
   if (local_audio_sender_) {
     // Reuse the existing sender.
-    if (local_audio_sender_->SetTrack(audio_track.get())) {
-      if (auto* sink = local_audio_observer_.get()) {
-        // FIXME - Current implementation of AddSink() for the local audio
-        // capture device is no-op. So this callback is never fired.
-        audio_track->AddSink(sink);
-      }
-      local_audio_track_ = std::move(audio_track);
-      return true;
+    if (!local_audio_sender_->SetTrack(audio_track.get())) {
+      return false;
     }
   } else if (peer_) {
     // Create a new sender.
     auto result = peer_->AddTrack(audio_track, {kAudioVideoStreamId});
-    if (result.ok()) {
-      if (auto* sink = local_audio_observer_.get()) {
-        // FIXME - Current implementation of AddSink() for the local audio
-        // capture device is no-op. So this callback is never fired.
-        audio_track->AddSink(sink);
-      }
-      local_audio_sender_ = result.value();
-      local_audio_track_ = std::move(audio_track);
-      return true;
+    if (!result.ok()) {
+      return false;
     }
+    local_audio_sender_ = result.value();
+  } else {
+    return false;
   }
-  return false;
+  // The AddSink() implementation of the local audio capture device is a no-op,
+  // so observe the captured audio through the audio processing module instead.
+  if (auto* sink = local_audio_observer_.get()) {
+    LocalAudioTap::Instance().AddObserver(sink);
+  }
+  local_audio_track_ = std::move(audio_track);
+  return true;
+}
+
+bool PeerConnectionImpl::AddLocalAudioTrackFromExternalSource(
+    rtc::scoped_refptr<webrtc::AudioTrackInterface> audio_track) noexcept {
+  if (local_audio_track_ || !peer_) {
+    return false;
+  }
+  if (local_audio_sender_) {
+    // Reuse the existing sender.
+    if (!local_audio_sender_->SetTrack(audio_track.get())) {
+      return false;
+    }
+  } else {
+    // Create a new sender.
+    auto result = peer_->AddTrack(audio_track, {kAudioVideoStreamId});
+    if (!result.ok()) {
+      return false;
+    }
+    local_audio_sender_ = result.value();
+  }
+  // The external source dispatches its audio to the sinks of the track, so the
+  // local audio observer is added like any other sink. This is not done for
+  // the capture device, whose audio would be delivered twice otherwise.
+  if (auto* sink = local_audio_observer_.get()) {
+    audio_track->AddSink(sink);
+  }
+  GlobalFactory::Instance()->AddExternalAudioTrack(peer_.get());
+  local_audio_external_ = true;
+  local_audio_track_ = std::move(audio_track);
+  return true;
 }
 
 void PeerConnectionImpl::RemoveLocalAudioTrack() noexcept {
   if (!local_audio_track_)
     return;
   if (auto* sink = local_audio_observer_.get()) {
-    local_audio_track_->RemoveSink(sink);
+    if (local_audio_external_) {
+      local_audio_track_->RemoveSink(sink);
+    } else {
+      LocalAudioTap::Instance().RemoveObserver(sink);
+    }
+  }
+  if (local_audio_external_) {
+    GlobalFactory::Instance()->RemoveExternalAudioTrack(peer_.get());
+    local_audio_external_ = false;
   }
   local_audio_sender_->SetTrack(nullptr);
   local_audio_track_ = nullptr;
@@ -968,6 +1276,11 @@ void PeerConnectionImpl::Close() noexcept {
     }
   }
   remote_streams_.clear();
+  {
+    auto lock = std::scoped_lock{remote_track_observers_mutex_};
+    ClearRemoteTrackObservers(remote_video_track_observers_);
+    ClearRemoteTrackObservers(remote_audio_track_observers_);
+  }
 
   RemoveAllDataChannels();
 
@@ -1189,6 +1502,21 @@ void PeerConnectionImpl::OnAddTrack(
       auto audio_track = static_cast<webrtc::AudioTrackInterface*>(track.get());
       audio_track->AddSink(sink);
     }
+
+    // Attach a dedicated observer to the track
+    auto lock = std::scoped_lock{remote_track_observers_mutex_};
+    RemoteAudioTrackObserver& entry = BindRemoteTrackObserver(
+        remote_audio_track_observers_,
+        static_cast<webrtc::AudioTrackInterface*>(track.get()),
+        GetReceiverMid(receiver.get()));
+    entry.observer_->SetCallback(entry.callback_);
+    if (entry.read_buffer_) {
+      entry.observer_->SetReadBuffer(entry.read_buffer_);
+    }
+    if (entry.output_format_) {
+      entry.observer_->SetOutputFormat(*entry.output_format_);
+    }
+    entry.track_->AddSink(entry.observer_.get());
   } else if (trackKindStr == webrtc::MediaStreamTrackInterface::kVideoKind) {
     trackKind = TrackKind::kVideoTrack;
     if (auto* sink = remote_video_observer_.get()) {
@@ -1198,6 +1526,20 @@ void PeerConnectionImpl::OnAddTrack(
       auto video_track = static_cast<webrtc::VideoTrackInterface*>(track.get());
       video_track->AddOrUpdateSink(sink, sink_settings);
     }
+
+    // Attach a dedicated observer to the track
+    auto lock = std::scoped_lock{remote_track_observers_mutex_};
+    RemoteVideoTrackObserver& entry = BindRemoteTrackObserver(
+        remote_video_track_observers_,
+        static_cast<webrtc::VideoTrackInterface*>(track.get()),
+        GetReceiverMid(receiver.get()));
+    if (entry.config_.async_) {
+      entry.observer_->SetDeliveryConfig(entry.config_);
+    }
+    entry.observer_->SetCallback(entry.callback_);
+    rtc::VideoSinkWants sink_settings{};
+    sink_settings.rotation_applied = true;
+    entry.track_->AddOrUpdateSink(entry.observer_.get(), sink_settings);
   } else {
     return;
   }
@@ -1232,12 +1574,17 @@ void PeerConnectionImpl::OnRemoveTrack(
       auto audio_track = static_cast<webrtc::AudioTrackInterface*>(track.get());
       audio_track->RemoveSink(sink);
     }
+    auto lock = std::scoped_lock{remote_track_observers_mutex_};
+    UnbindRemoteTrackObserver(remote_audio_track_observers_, track.get());
   } else if (trackKindStr == webrtc::MediaStreamTrackInterface::kVideoKind) {
     trackKind = TrackKind::kVideoTrack;
     if (auto* sink = remote_video_observer_.get()) {
       auto video_track = static_cast<webrtc::VideoTrackInterface*>(track.get());
       video_track->RemoveSink(sink);
     }
+
+    auto lock = std::scoped_lock{remote_track_observers_mutex_};
+    UnbindRemoteTrackObserver(remote_video_track_observers_, track.get());
   } else {
     return;
   }
@@ -1252,6 +1599,184 @@ void PeerConnectionImpl::OnRemoveTrack(
   }
 }
 
+void PeerConnectionImpl::RegisterRemoteVideoTrackFrameCallback(
+    std::string_view track_name,
+    TrackVideoFrameHandleReadyCallback callback) noexcept {
+  std::shared_ptr<VideoFrameObserver> observer;
+  {
+    auto lock = std::scoped_lock{remote_track_observers_mutex_};
+    RemoteVideoTrackObserver* entry;
+    if (callback) {
+      entry = &FindOrAddRemoteTrackObserver(remote_video_track_observers_,
+                                            track_name);
+      entry->name_ = std::string(track_name);
+    } else {
+      entry =
+          FindRemoteTrackObserver(remote_video_track_observers_, track_name);
+      if (!entry) {
+        return;
+      }
+    }
+    entry->callback_ = callback;
+    observer = entry->observer_;
+    if (!callback) {
+      RemoveRemoteTrackRegistration(remote_video_track_observers_, *entry);
+    }
+  }
+
+  // Replacing the callback waits for its in-flight invocations, so do not
+  // block the other tracks during that time.
+  if (observer) {
+    observer->SetCallback(std::move(callback));
+  }
+}
+
+Result PeerConnectionImpl::SetRemoteVideoTrackFrameDeliveryConfig(
+    std::string_view track_name,
+    const VideoFrameDeliveryConfig& config) noexcept {
+  if (config.async_ && (config.queue_capacity_ <= 0)) {
+    return Result::kInvalidParameter;
+  }
+  std::shared_ptr<VideoFrameObserver> observer;
+  {
+    auto lock = std::scoped_lock{remote_track_observers_mutex_};
+    RemoteVideoTrackObserver* entry;
+    if (config.async_) {
+      entry = &FindOrAddRemoteTrackObserver(remote_video_track_observers_,
+                                            track_name);
+      entry->name_ = std::string(track_name);
+    } else {
+      entry =
+          FindRemoteTrackObserver(remote_video_track_observers_, track_name);
+      if (!entry) {
+        return Result::kSuccess;
+      }
+    }
+    entry->config_ = config;
+    observer = entry->observer_;
+    if (!config.async_) {
+      RemoveRemoteTrackRegistration(remote_video_track_observers_, *entry);
+    }
+  }
+
+  // Stopping asynchronous delivery waits for the delivery thread, so do not
+  // block the other tracks during that time.
+  if (observer) {
+    return observer->SetDeliveryConfig(config);
+  }
+  return Result::kSuccess;
+}
+
+Result PeerConnectionImpl::GetRemoteVideoTrackFrameDeliveryStats(
+    std::string_view track_name,
+    VideoFrameDeliveryStats& stats) const noexcept {
+  auto lock = std::scoped_lock{remote_track_observers_mutex_};
+  RemoteVideoTrackObserver* entry =
+      FindRemoteTrackObserver(remote_video_track_observers_, track_name);
+  if (!entry || !entry->observer_) {
+    return Result::kInvalidParameter;
+  }
+  stats = entry->observer_->GetDeliveryStats();
+  return Result::kSuccess;
+}
+
+void PeerConnectionImpl::RegisterRemoteAudioTrackFrameCallback(
+    std::string_view track_name,
+    TrackAudioFrameReadyCallback callback) noexcept {
+  std::shared_ptr<AudioFrameObserver> observer;
+  {
+    auto lock = std::scoped_lock{remote_track_observers_mutex_};
+    RemoteAudioTrackObserver* entry;
+    if (callback) {
+      entry = &FindOrAddRemoteTrackObserver(remote_audio_track_observers_,
+                                            track_name);
+      entry->name_ = std::string(track_name);
+    } else {
+      entry =
+          FindRemoteTrackObserver(remote_audio_track_observers_, track_name);
+      if (!entry) {
+        return;
+      }
+    }
+    entry->callback_ = callback;
+    observer = entry->observer_;
+    if (!callback) {
+      RemoveRemoteTrackRegistration(remote_audio_track_observers_, *entry);
+    }
+  }
+
+  // Replacing the callback waits for its in-flight invocations, so do not
+  // block the other tracks during that time.
+  if (observer) {
+    observer->SetCallback(std::move(callback));
+  }
+}
+
+void PeerConnectionImpl::SetRemoteAudioTrackReadBuffer(
+    std::string_view track_name,
+    RefPtr<AudioReadBuffer> buffer) noexcept {
+  auto lock = std::scoped_lock{remote_track_observers_mutex_};
+  if (!buffer &&
+      !FindRemoteTrackObserver(remote_audio_track_observers_, track_name)) {
+    return;
+  }
+  RemoteAudioTrackObserver& entry =
+      FindOrAddRemoteTrackObserver(remote_audio_track_observers_, track_name);
+  entry.name_ = std::string(track_name);
+  entry.read_buffer_ = buffer;
+  if (entry.observer_) {
+    entry.observer_->SetReadBuffer(std::move(buffer));
+  }
+  if (!entry.read_buffer_) {
+    RemoveRemoteTrackRegistration(remote_audio_track_observers_, entry);
+  }
+}
+
+Result PeerConnectionImpl::SetRemoteAudioTrackOutputFormat(
+    std::string_view track_name,
+    const std::optional<AudioOutputFormat>& format) noexcept {
+  if (format) {
+    const Result result = AudioFrameConverter::ValidateFormat(*format);
+    if (result != Result::kSuccess) {
+      return result;
+    }
+  }
+  auto lock = std::scoped_lock{remote_track_observers_mutex_};
+  if (!format &&
+      !FindRemoteTrackObserver(remote_audio_track_observers_, track_name)) {
+    return Result::kSuccess;
+  }
+  RemoteAudioTrackObserver& entry =
+      FindOrAddRemoteTrackObserver(remote_audio_track_observers_, track_name);
+  entry.name_ = std::string(track_name);
+  entry.output_format_ = format;
+  if (entry.observer_) {
+    if (format) {
+      return entry.observer_->SetOutputFormat(*format);
+    }
+    entry.observer_->ClearOutputFormat();
+  }
+  if (!format) {
+    RemoveRemoteTrackRegistration(remote_audio_track_observers_, entry);
+  }
+  return Result::kSuccess;
+}
+
+std::string PeerConnectionImpl::GetReceiverMid(
+    const webrtc::RtpReceiverInterface* receiver) const noexcept {
+  // Transceivers are only available with Unified Plan
+  if (!peer_ || (peer_->GetConfiguration().sdp_semantics !=
+                 webrtc::SdpSemantics::kUnifiedPlan)) {
+    return {};
+  }
+  for (auto&& transceiver : peer_->GetTransceivers()) {
+    if (transceiver->receiver().get() == receiver) {
+      return transceiver->mid().value_or(std::string{});
+    }
+  }
+  return {};
+}
+
 void PeerConnectionImpl::OnLocalDescCreated(
     webrtc::SessionDescriptionInterface* desc) noexcept {
   if (!peer_) {
@@ -195,6 +195,61 @@ class PeerConnection : public TrackedObject {
   virtual void RegisterRemoteVideoFrameCallback(
       Argb32FrameReadyCallback callback) noexcept = 0;
 
+  /// Register a custom callback invoked when a remote video frame has been
+  /// received and decompressed, and is ready to be displayed locally.
+  virtual void RegisterRemoteVideoFrameCallback(
+      Nv12FrameReadyCallback callback) noexcept = 0;
+
+  /// Register a custom callback invoked when a remote video frame has been
+  /// received and decompressed, and is ready to be displayed locally.
+  virtual void RegisterRemoteVideoFrameCallback(
+      Rgba32FrameReadyCallback callback) noexcept = 0;
+
+  /// Register a custom callback invoked when a remote video frame has been
+  /// received and decompressed, and is ready to be displayed locally.
+  virtual void RegisterRemoteVideoFrameCallback(
+      Bgra32FrameReadyCallback callback) noexcept = 0;
+
+  /// Register a custom callback invoked when a remote video frame has been
+  /// received and decompressed, with a handle converting the frame on demand.
+  virtual void RegisterRemoteVideoFrameCallback(
+      VideoFrameHandleReadyCallback callback) noexcept = 0;
+
+  /// Configure how remote video frames are delivered to the callbacks
+  /// registered with |RegisterRemoteVideoFrameCallback()|, either synchronously
+  /// on the decoder thread (default) or asynchronously on a dedicated thread.
+  virtual Result SetRemoteVideoFrameDeliveryConfig(
+      const VideoFrameDeliveryConfig& config) noexcept = 0;
+
+  /// Get the delivery statistics of the remote video frames.
+  virtual VideoFrameDeliveryStats GetRemoteVideoFrameDeliveryStats()
+      const noexcept = 0;
+
+  /// Register a custom callback invoked when a video frame of a single remote
+  /// video track has been received and decompressed. The track is designated
+  /// by |track_name|, either its track ID or the MID of its transceiver. Each
+  /// remote video track has its own observer, so that the frames of different
+  /// tracks are delivered independently of each other, and concurrently in
+  /// asynchronous mode. The callback can be registered before the track is
+  /// added, in which case it is attached to the track once added. Registering
+  /// a null callback removes the registration.
+  virtual void RegisterRemoteVideoTrackFrameCallback(
+      std::string_view track_name,
+      TrackVideoFrameHandleReadyCallback callback) noexcept = 0;
+
+  /// Configure how the frames of a single remote video track are delivered to
+  /// the callback registered with |RegisterRemoteVideoTrackFrameCallback()|.
+  virtual Result SetRemoteVideoTrackFrameDeliveryConfig(
+      std::string_view track_name,
+      const VideoFrameDeliveryConfig& config) noexcept = 0;
+
+  /// Get the delivery statistics of the frames of a single remote video track.
+  /// Return |Result::kInvalidParameter| if no track with the given name is
+  /// currently attached.
+  virtual Result GetRemoteVideoTrackFrameDeliveryStats(
+      std::string_view track_name,
+      VideoFrameDeliveryStats& stats) const noexcept = 0;
+
   /// Add a video track to the peer connection. If no RTP sender/transceiver
   /// exist, create a new one for that track.
   virtual ErrorOr<RefPtr<LocalVideoTrack>> AddLocalVideoTrack(
@@ -243,10 +298,8 @@ class PeerConnection : public TrackedObject {
   //
 
   /// Register a custom callback invoked when a local audio frame is ready to be
-  /// output.
-  ///
-  /// FIXME - Current implementation of AddSink() for the local audio capture
-  /// device is no-op. So this callback is never fired.
+  /// output. Frames are delivered by the |LocalAudioTap| while the local audio
+  /// track is added, except on UWP where the tap is not installed.
   virtual void RegisterLocalAudioFrameCallback(
       AudioFrameReadyCallback callback) noexcept = 0;
 
@@ -255,6 +308,40 @@ class PeerConnection : public TrackedObject {
   virtual void RegisterRemoteAudioFrameCallback(
       AudioFrameReadyCallback callback) noexcept = 0;
 
+  /// Register a custom callback invoked when an audio frame of a single remote
+  /// audio track has been received. The track is designated by |track_name|,
+  /// either its track ID or the MID of its transceiver. Each remote audio track
+  /// has its own observer, and the callback is invoked without holding any
+  /// lock shared with the other tracks. The callback can be registered before
+  /// the track is added, in which case it is attached to the track once added.
+  /// Registering a null callback removes the registration.
+  virtual void RegisterRemoteAudioTrackFrameCallback(
+      std::string_view track_name,
+      TrackAudioFrameReadyCallback callback) noexcept = 0;
+
+  /// Convert the remote audio frames delivered to the callback registered with
+  /// |RegisterRemoteAudioFrameCallback()| into the given format, or deliver
+  /// them unconverted if |format| is empty.
+  virtual Result SetRemoteAudioOutputFormat(
+      const std::optional<AudioOutputFormat>& format) noexcept = 0;
+
+  /// Convert the audio frames of a single remote audio track, delivered to the
+  /// callback and read buffer of that track, into the given format, or deliver
+  /// them unconverted if |format| is empty. The track is designated like for
+  /// |RegisterRemoteAudioTrackFrameCallback()|.
+  virtual Result SetRemoteAudioTrackOutputFormat(
+      std::string_view track_name,
+      const std::optional<AudioOutputFormat>& format) noexcept = 0;
+
+  /// Write the audio frames of a single remote audio track into the given
+  /// buffer, for the user to read them at its own cadence. The track is
+  /// designated like for |RegisterRemoteAudioTrackFrameCallback()|. This
+  /// replaces the previous buffer of the track, if any; pass null to stop
+  /// writing into any buffer.
+  virtual void SetRemoteAudioTrackReadBuffer(
+      std::string_view track_name,
+      RefPtr<AudioReadBuffer> buffer) noexcept = 0;
+
   /// Add to the peer connection an audio track backed by a local audio capture
   /// device. If no RTP sender/transceiver exist, create a new one for that
   /// track.
@@ -264,6 +351,14 @@ class PeerConnection : public TrackedObject {
   virtual bool AddLocalAudioTrack(
       rtc::scoped_refptr<webrtc::AudioTrackInterface> audio_track) noexcept = 0;
 
+  /// Add to the peer connection an audio track backed by an external audio
+  /// track source. This pauses the recording from the local audio capture
+  /// device until the track is removed, since the audio device module sends the
+  /// recorded audio to all the audio streams, regardless of their track. The
+  /// local audio frame callback receives the audio of the source.
+  virtual bool AddLocalAudioTrackFromExternalSource(
+      rtc::scoped_refptr<webrtc::AudioTrackInterface> audio_track) noexcept = 0;
+
   /// Remove the existing local audio track from the peer connection.
   /// The underlying RTP sender/transceiver are kept alive but inactive.
   ///
@@ -0,0 +1,218 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "video_conversion.h"
+#include "worker_pool.h"
+
+namespace {
+
+using namespace Microsoft::MixedReality::WebRTC;
+
+/// Minimum number of rows per band. Smaller bands increase the relative cost
+/// of dispatching the work compared to the conversion itself.
+constexpr int kMinBandRowCount = 64;
+
+std::atomic_int64_t g_parallel_conversion_min_pixel_count{
+    kDefaultParallelConversionMinPixelCount};
+
+}  // namespace
+
+namespace Microsoft::MixedReality::WebRTC {
+
+void SetParallelConversionMinPixelCount(int64_t pixel_count) noexcept {
+  g_parallel_conversion_min_pixel_count.store(
+      std::max<int64_t>(pixel_count, 0), std::memory_order_relaxed);
+}
+
+int64_t GetParallelConversionMinPixelCount() noexcept {
+  return g_parallel_conversion_min_pixel_count.load(std::memory_order_relaxed);
+}
+
+void ForEachRowBand(int width,
+                    int height,
+                    const std::function<void(int, int)>& func) {
+  const int64_t pixel_count = static_cast<int64_t>(width) * height;
+  if (pixel_count < GetParallelConversionMinPixelCount()) {
+    func(0, height);
+    return;
+  }
+  WorkerPool& pool = WorkerPool::Instance();
+  const int band_count =
+      std::min(pool.GetConcurrency(), height / kMinBandRowCount);
+  if (band_count <= 1) {
+    func(0, height);
+    return;
+  }
+  // Round up to an even number of rows, and recompute the actual number of
+  // bands which may be lower due to rounding.
+  const int band_row_count =
+      (((height + band_count - 1) / band_count) + 1) & ~1;
+  const int task_count = (height + band_row_count - 1) / band_row_count;
+  pool.ParallelFor(task_count, [&](int index) {
+    const int first_row = index * band_row_count;
+    const int row_count = std::min(band_row_count, height - first_row);
+    func(first_row, row_count);
+  });
+}
+
+void ConvertI420ToArgb32(const uint8_t* ydata,
+                         int ystride,
+                         const uint8_t* udata,
+                         int ustride,
+                         const uint8_t* vdata,
+                         int vstride,
+                         uint8_t* argb_data,
+                         int argb_stride,
+                         int width,
+                         int height) noexcept {
+  ForEachRowBand(width, height, [&](int first_row, int row_count) {
+    const int first_chroma_row = first_row / 2;
+    libyuv::I420ToARGB(ydata + (ptrdiff_t)first_row * ystride, ystride,
+                       udata + (ptrdiff_t)first_chroma_row * ustride, ustride,
+                       vdata + (ptrdiff_t)first_chroma_row * vstride, vstride,
+                       argb_data + (ptrdiff_t)first_row * argb_stride,
+                       argb_stride, width, row_count);
+  });
+}
+
+void ConvertI420AlphaToArgb32(const uint8_t* ydata,
+                              int ystride,
+                              const uint8_t* udata,
+                              int ustride,
+                              const uint8_t* vdata,
+                              int vstride,
+                              const uint8_t* adata,
+                              int astride,
+                              uint8_t* argb_data,
+                              int argb_stride,
+                              int width,
+                              int height) noexcept {
+  ForEachRowBand(width, height, [&](int first_row, int row_count) {
+    const int first_chroma_row = first_row / 2;
+    libyuv::I420AlphaToARGB(
+        ydata + (ptrdiff_t)first_row * ystride, ystride,
+        udata + (ptrdiff_t)first_chroma_row * ustride, ustride,
+        vdata + (ptrdiff_t)first_chroma_row * vstride, vstride,
+        adata + (ptrdiff_t)first_row * astride, astride,
+        argb_data + (ptrdiff_t)first_row * argb_stride, argb_stride, width,
+        row_count, 0);
+  });
+}
+
+void ConvertI420ToRgba32(const uint8_t* ydata,
+                         int ystride,
+                         const uint8_t* udata,
+                         int ustride,
+                         const uint8_t* vdata,
+                         int vstride,
+                         uint8_t* rgba_data,
+                         int rgba_stride,
+                         int width,
+                         int height) noexcept {
+  // libyuv names formats after the component order in a little-endian 32-bit
+  // word, so its "ABGR" is RGBA in memory order.
+  ForEachRowBand(width, height, [&](int first_row, int row_count) {
+    const int first_chroma_row = first_row / 2;
+    libyuv::I420ToABGR(ydata + (ptrdiff_t)first_row * ystride, ystride,
+                       udata + (ptrdiff_t)first_chroma_row * ustride, ustride,
+                       vdata + (ptrdiff_t)first_chroma_row * vstride, vstride,
+                       rgba_data + (ptrdiff_t)first_row * rgba_stride,
+                       rgba_stride, width, row_count);
+  });
+}
+
+void ConvertI420AlphaToRgba32(const uint8_t* ydata,
+                              int ystride,
+                              const uint8_t* udata,
+                              int ustride,
+                              const uint8_t* vdata,
+                              int vstride,
+                              const uint8_t* adata,
+                              int astride,
+                              uint8_t* rgba_data,
+                              int rgba_stride,
+                              int width,
+                              int height) noexcept {
+  ForEachRowBand(width, height, [&](int first_row, int row_count) {
+    const int first_chroma_row = first_row / 2;
+    libyuv::I420AlphaToABGR(
+        ydata + (ptrdiff_t)first_row * ystride, ystride,
+        udata + (ptrdiff_t)first_chroma_row * ustride, ustride,
+        vdata + (ptrdiff_t)first_chroma_row * vstride, vstride,
+        adata + (ptrdiff_t)first_row * astride, astride,
+        rgba_data + (ptrdiff_t)first_row * rgba_stride, rgba_stride, width,
+        row_count, 0);
+  });
+}
+
+void PremultiplyAlpha32(const uint8_t* src_data,
+                        int src_stride,
+                        uint8_t* dst_data,
+                        int dst_stride,
+                        int width,
+                        int height) noexcept {
+  // ARGBAttenuate() scales the first 3 bytes of each pixel by the 4th one, so
+  // is agnostic to the order of the color components.
+  ForEachRowBand(width, height, [&](int first_row, int row_count) {
+    libyuv::ARGBAttenuate(src_data + (ptrdiff_t)first_row * src_stride,
+                          src_stride,
+                          dst_data + (ptrdiff_t)first_row * dst_stride,
+                          dst_stride, width, row_count);
+  });
+}
+
+void ConvertArgb32ToI420(const uint8_t* argb_data,
+                         int argb_stride,
+                         uint8_t* dst_ydata,
+                         int dst_ystride,
+                         uint8_t* dst_udata,
+                         int dst_ustride,
+                         uint8_t* dst_vdata,
+                         int dst_vstride,
+                         int width,
+                         int height) noexcept {
+  // Each band starts on an even row, so converts whole chroma rows, except for
+  // the last row of a frame with odd height which libyuv handles on its own.
+  ForEachRowBand(width, height, [&](int first_row, int row_count) {
+    const int first_chroma_row = first_row / 2;
+    libyuv::ARGBToI420(argb_data + (ptrdiff_t)first_row * argb_stride,
+                       argb_stride,
+                       dst_ydata + (ptrdiff_t)first_row * dst_ystride,
+                       dst_ystride,
+                       dst_udata + (ptrdiff_t)first_chroma_row * dst_ustride,
+                       dst_ustride,
+                       dst_vdata + (ptrdiff_t)first_chroma_row * dst_vstride,
+                       dst_vstride, width, row_count);
+  });
+}
+
+void ConvertI420ToNv12(const uint8_t* ydata,
+                       int ystride,
+                       const uint8_t* udata,
+                       int ustride,
+                       const uint8_t* vdata,
+                       int vstride,
+                       uint8_t* dst_ydata,
+                       int dst_ystride,
+                       uint8_t* dst_uvdata,
+                       int dst_uvstride,
+                       int width,
+                       int height) noexcept {
+  ForEachRowBand(width, height, [&](int first_row, int row_count) {
+    const int first_chroma_row = first_row / 2;
+    libyuv::I420ToNV12(ydata + (ptrdiff_t)first_row * ystride, ystride,
+                       udata + (ptrdiff_t)first_chroma_row * ustride, ustride,
+                       vdata + (ptrdiff_t)first_chroma_row * vstride, vstride,
+                       dst_ydata + (ptrdiff_t)first_row * dst_ystride,
+                       dst_ystride,
+                       dst_uvdata + (ptrdiff_t)first_chroma_row * dst_uvstride,
+                       dst_uvstride, width, row_count);
+  });
+}
+
+}  // namespace Microsoft::MixedReality::WebRTC
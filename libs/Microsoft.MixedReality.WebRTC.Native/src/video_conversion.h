@@ -0,0 +1,126 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace Microsoft::MixedReality::WebRTC {
+
+/// Default minimum frame size, in pixels, for converting a frame in parallel.
+/// Below this size, the overhead of dispatching the work to other threads is
+/// not worth it.
+constexpr int64_t kDefaultParallelConversionMinPixelCount = 1280 * 720;
+
+/// Set the minimum frame size, in pixels, from which color conversions are
+/// split into row bands converted in parallel by the global |WorkerPool|.
+/// Frames smaller than this are converted on the calling thread only. A value
+/// of |INT64_MAX| effectively disables parallel conversion.
+void SetParallelConversionMinPixelCount(int64_t pixel_count) noexcept;
+
+/// Get the current minimum frame size for parallel conversion, in pixels.
+int64_t GetParallelConversionMinPixelCount() noexcept;
+
+/// Split the |height| rows of a frame of size |width| x |height| into bands,
+/// and invoke |func(first_row, row_count)| for each band, in parallel if the
+/// frame is large enough. All bands except the last one have an even number of
+/// rows, so that each band starts on a chroma row of 4:2:0 frames.
+void ForEachRowBand(int width,
+                    int height,
+                    const std::function<void(int, int)>& func);
+
+/// Convert an I420 frame into an ARGB32 frame, in parallel for large frames.
+void ConvertI420ToArgb32(const uint8_t* ydata,
+                         int ystride,
+                         const uint8_t* udata,
+                         int ustride,
+                         const uint8_t* vdata,
+                         int vstride,
+                         uint8_t* argb_data,
+                         int argb_stride,
+                         int width,
+                         int height) noexcept;
+
+/// Convert an I420 frame with alpha plane into an ARGB32 frame, in parallel for
+/// large frames.
+void ConvertI420AlphaToArgb32(const uint8_t* ydata,
+                              int ystride,
+                              const uint8_t* udata,
+                              int ustride,
+                              const uint8_t* vdata,
+                              int vstride,
+                              const uint8_t* adata,
+                              int astride,
+                              uint8_t* argb_data,
+                              int argb_stride,
+                              int width,
+                              int height) noexcept;
+
+/// Convert an I420 frame into an RGBA32 frame (R first in memory), in
+/// parallel for large frames.
+void ConvertI420ToRgba32(const uint8_t* ydata,
+                         int ystride,
+                         const uint8_t* udata,
+                         int ustride,
+                         const uint8_t* vdata,
+                         int vstride,
+                         uint8_t* rgba_data,
+                         int rgba_stride,
+                         int width,
+                         int height) noexcept;
+
+/// Convert an I420 frame with alpha plane into an RGBA32 frame (R first in
+/// memory), in parallel for large frames.
+void ConvertI420AlphaToRgba32(const uint8_t* ydata,
+                              int ystride,
+                              const uint8_t* udata,
+                              int ustride,
+                              const uint8_t* vdata,
+                              int vstride,
+                              const uint8_t* adata,
+                              int astride,
+                              uint8_t* rgba_data,
+                              int rgba_stride,
+                              int width,
+                              int height) noexcept;
+
+/// Premultiply the color components of a 32-bit-per-pixel frame by its alpha
+/// component, in parallel for large frames. This works for any component
+/// order where alpha is last in memory, like ARGB32 (BGRA) and RGBA32.
+void PremultiplyAlpha32(const uint8_t* src_data,
+                        int src_stride,
+                        uint8_t* dst_data,
+                        int dst_stride,
+                        int width,
+                        int height) noexcept;
+
+/// Convert an ARGB32 frame into an I420 frame, in parallel for large frames.
+/// Frames with odd dimensions are supported; the chroma samples of the last
+/// column and row are computed from the edge pixels only.
+void ConvertArgb32ToI420(const uint8_t* argb_data,
+                         int argb_stride,
+                         uint8_t* dst_ydata,
+                         int dst_ystride,
+                         uint8_t* dst_udata,
+                         int dst_ustride,
+                         uint8_t* dst_vdata,
+                         int dst_vstride,
+                         int width,
+                         int height) noexcept;
+
+/// Convert an I420 frame into an NV12 frame, in parallel for large frames.
+void ConvertI420ToNv12(const uint8_t* ydata,
+                       int ystride,
+                       const uint8_t* udata,
+                       int ustride,
+                       const uint8_t* vdata,
+                       int vstride,
+                       uint8_t* dst_ydata,
+                       int dst_ystride,
+                       uint8_t* dst_uvdata,
+                       int dst_uvstride,
+                       int width,
+                       int height) noexcept;
+
+}  // namespace Microsoft::MixedReality::WebRTC
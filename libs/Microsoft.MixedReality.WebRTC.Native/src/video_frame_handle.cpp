@@ -0,0 +1,182 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include "video_conversion.h"
+#include "video_frame_handle.h"
+#include "video_frame_observer.h"
+
+namespace Microsoft::MixedReality::WebRTC {
+
+RefPtr<VideoFrameHandle> VideoFrameHandle::Create(
+    rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer) noexcept {
+  return new VideoFrameHandle(std::move(buffer));
+}
+
+VideoFrameHandle::VideoFrameHandle(
+    rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer) noexcept
+    : buffer_(std::move(buffer)) {
+  RTC_DCHECK(buffer_);
+}
+
+VideoFrameHandle::~VideoFrameHandle() noexcept = default;
+
+const I420AVideoFrame& VideoFrameHandle::GetI420A() noexcept {
+  std::call_once(i420a_once_, [this]() {
+    i420a_frame_.width_ = buffer_->width();
+    i420a_frame_.height_ = buffer_->height();
+    if (buffer_->type() == webrtc::VideoFrameBuffer::Type::kI420A) {
+      // The buffer is encoded in I420 with alpha channel, use it directly.
+      const webrtc::I420ABufferInterface* i420a_buffer = buffer_->GetI420A();
+      i420a_frame_.ydata_ = i420a_buffer->DataY();
+      i420a_frame_.udata_ = i420a_buffer->DataU();
+      i420a_frame_.vdata_ = i420a_buffer->DataV();
+      i420a_frame_.adata_ = i420a_buffer->DataA();
+      i420a_frame_.ystride_ = i420a_buffer->StrideY();
+      i420a_frame_.ustride_ = i420a_buffer->StrideU();
+      i420a_frame_.vstride_ = i420a_buffer->StrideV();
+      i420a_frame_.astride_ = i420a_buffer->StrideA();
+      return;
+    }
+    // The buffer is not encoded in I420 with alpha channel; use I420 without
+    // alpha channel as interchange format, and convert the buffer to that (or
+    // do nothing if already in I420).
+    i420_buffer_ = buffer_->ToI420();
+    i420a_frame_.ydata_ = i420_buffer_->DataY();
+    i420a_frame_.udata_ = i420_buffer_->DataU();
+    i420a_frame_.vdata_ = i420_buffer_->DataV();
+    i420a_frame_.adata_ = nullptr;
+    i420a_frame_.ystride_ = i420_buffer_->StrideY();
+    i420a_frame_.ustride_ = i420_buffer_->StrideU();
+    i420a_frame_.vstride_ = i420_buffer_->StrideV();
+    i420a_frame_.astride_ = 0;
+  });
+  return i420a_frame_;
+}
+
+const Argb32VideoFrame& VideoFrameHandle::GetArgb32() noexcept {
+  std::call_once(argb32_once_, [this]() {
+    const I420AVideoFrame& src = GetI420A();
+    const int width = static_cast<int>(src.width_);
+    const int height = static_cast<int>(src.height_);
+    argb_buffer_ = ArgbBuffer::Create(width, height);
+    const uint8_t* const yptr = static_cast<const uint8_t*>(src.ydata_);
+    const uint8_t* const uptr = static_cast<const uint8_t*>(src.udata_);
+    const uint8_t* const vptr = static_cast<const uint8_t*>(src.vdata_);
+    if (src.adata_) {
+      ConvertI420AlphaToArgb32(yptr, src.ystride_, uptr, src.ustride_, vptr,
+                               src.vstride_,
+                               static_cast<const uint8_t*>(src.adata_),
+                               src.astride_, argb_buffer_->Data(),
+                               argb_buffer_->Stride(), width, height);
+    } else {
+      ConvertI420ToArgb32(yptr, src.ystride_, uptr, src.ustride_, vptr,
+                          src.vstride_, argb_buffer_->Data(),
+                          argb_buffer_->Stride(), width, height);
+    }
+    argb32_frame_.width_ = src.width_;
+    argb32_frame_.height_ = src.height_;
+    argb32_frame_.argb32_data_ = argb_buffer_->Data();
+    argb32_frame_.stride_ = argb_buffer_->Stride();
+  });
+  return argb32_frame_;
+}
+
+const Rgba32VideoFrame& VideoFrameHandle::GetRgba32(
+    bool premultiplied_alpha) noexcept {
+  const int index = (premultiplied_alpha ? 1 : 0);
+  std::call_once(rgba32_once_[index], [this, premultiplied_alpha, index]() {
+    const I420AVideoFrame& src = GetI420A();
+    const int width = static_cast<int>(src.width_);
+    const int height = static_cast<int>(src.height_);
+    Rgba32VideoFrame& frame = rgba32_frames_[index];
+    if (premultiplied_alpha) {
+      const Rgba32VideoFrame& straight = GetRgba32(false);
+      if (!src.adata_) {
+        // Opaque frame; premultiplying is a no-op.
+        frame = straight;
+        return;
+      }
+      rgba32_buffers_[1] = ArgbBuffer::Create(width, height);
+      PremultiplyAlpha32(static_cast<const uint8_t*>(straight.rgba32_data_),
+                         straight.stride_, rgba32_buffers_[1]->Data(),
+                         rgba32_buffers_[1]->Stride(), width, height);
+    } else {
+      rgba32_buffers_[0] = ArgbBuffer::Create(width, height);
+      const uint8_t* const yptr = static_cast<const uint8_t*>(src.ydata_);
+      const uint8_t* const uptr = static_cast<const uint8_t*>(src.udata_);
+      const uint8_t* const vptr = static_cast<const uint8_t*>(src.vdata_);
+      if (src.adata_) {
+        ConvertI420AlphaToRgba32(yptr, src.ystride_, uptr, src.ustride_, vptr,
+                                 src.vstride_,
+                                 static_cast<const uint8_t*>(src.adata_),
+                                 src.astride_, rgba32_buffers_[0]->Data(),
+                                 rgba32_buffers_[0]->Stride(), width, height);
+      } else {
+        ConvertI420ToRgba32(yptr, src.ystride_, uptr, src.ustride_, vptr,
+                            src.vstride_, rgba32_buffers_[0]->Data(),
+                            rgba32_buffers_[0]->Stride(), width, height);
+      }
+    }
+    frame.width_ = src.width_;
+    frame.height_ = src.height_;
+    frame.rgba32_data_ = rgba32_buffers_[index]->Data();
+    frame.stride_ = rgba32_buffers_[index]->Stride();
+  });
+  return rgba32_frames_[index];
+}
+
+const Bgra32VideoFrame& VideoFrameHandle::GetBgra32(
+    bool premultiplied_alpha) noexcept {
+  const int index = (premultiplied_alpha ? 1 : 0);
+  std::call_once(bgra32_once_[index], [this, premultiplied_alpha, index]() {
+    // ARGB32 is BGRA32 in memory order, so reuse that conversion.
+    const Argb32VideoFrame& straight = GetArgb32();
+    Bgra32VideoFrame& frame = bgra32_frames_[index];
+    frame.width_ = straight.width_;
+    frame.height_ = straight.height_;
+    frame.bgra32_data_ = straight.argb32_data_;
+    frame.stride_ = straight.stride_;
+    if (!premultiplied_alpha || !GetI420A().adata_) {
+      return;
+    }
+    const int width = static_cast<int>(straight.width_);
+    const int height = static_cast<int>(straight.height_);
+    bgra32_premultiplied_buffer_ = ArgbBuffer::Create(width, height);
+    PremultiplyAlpha32(static_cast<const uint8_t*>(straight.argb32_data_),
+                       straight.stride_, bgra32_premultiplied_buffer_->Data(),
+                       bgra32_premultiplied_buffer_->Stride(), width, height);
+    frame.bgra32_data_ = bgra32_premultiplied_buffer_->Data();
+    frame.stride_ = bgra32_premultiplied_buffer_->Stride();
+  });
+  return bgra32_frames_[index];
+}
+
+const Nv12VideoFrame& VideoFrameHandle::GetNv12() noexcept {
+  std::call_once(nv12_once_, [this]() {
+    const I420AVideoFrame& src = GetI420A();
+    const int width = static_cast<int>(src.width_);
+    const int height = static_cast<int>(src.height_);
+    const int ystride = width;
+    const int uvstride = ((width + 1) / 2) * 2;
+    const size_t ysize = static_cast<size_t>(ystride) * height;
+    const size_t uvsize = static_cast<size_t>(uvstride) * ((height + 1) / 2);
+    nv12_data_ = FrameBufferPool::Instance().Acquire(ysize + uvsize);
+    uint8_t* const ydata = nv12_data_.get();
+    uint8_t* const uvdata = ydata + ysize;
+    ConvertI420ToNv12(static_cast<const uint8_t*>(src.ydata_), src.ystride_,
+                      static_cast<const uint8_t*>(src.udata_), src.ustride_,
+                      static_cast<const uint8_t*>(src.vdata_), src.vstride_,
+                      ydata, ystride, uvdata, uvstride, width, height);
+    nv12_frame_.width_ = src.width_;
+    nv12_frame_.height_ = src.height_;
+    nv12_frame_.ydata_ = ydata;
+    nv12_frame_.uvdata_ = uvdata;
+    nv12_frame_.ystride_ = ystride;
+    nv12_frame_.uvstride_ = uvstride;
+  });
+  return nv12_frame_;
+}
+
+}  // namespace Microsoft::MixedReality::WebRTC
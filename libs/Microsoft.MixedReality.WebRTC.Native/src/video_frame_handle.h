@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <mutex>
+
+#include "api/video/video_frame_buffer.h"
+
+#include "frame_buffer_pool.h"
+#include "ref_counted_base.h"
+#include "refptr.h"
+#include "video_frame.h"
+
+namespace Microsoft::MixedReality::WebRTC {
+
+class ArgbBuffer;
+
+/// Handle to a decoded video frame shared by all the consumers of that frame.
+///
+/// The frame content can be accessed in several encodings. Each accessor
+/// converts the frame on first use only, and caches the result on the handle,
+/// so that the frame is converted at most once per encoding whatever the
+/// number of consumers, and not at all for encodings no consumer accesses.
+/// All accessors are thread-safe, and the views they return remain valid for
+/// the lifetime of the handle.
+class VideoFrameHandle : public RefCountedBase {
+ public:
+  /// Create a new handle for the given frame buffer.
+  static RefPtr<VideoFrameHandle> Create(
+      rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer) noexcept;
+
+  /// Width of the frame, in pixels.
+  int width() const noexcept { return buffer_->width(); }
+
+  /// Height of the frame, in pixels.
+  int height() const noexcept { return buffer_->height(); }
+
+  /// Underlying frame buffer in its native encoding.
+  const rtc::scoped_refptr<webrtc::VideoFrameBuffer>& buffer() const noexcept {
+    return buffer_;
+  }
+
+  /// Get a view of the frame encoded in I420, with an alpha plane if the
+  /// source buffer has one.
+  const I420AVideoFrame& GetI420A() noexcept;
+
+  /// Get a view of the frame encoded in ARGB32.
+  const Argb32VideoFrame& GetArgb32() noexcept;
+
+  /// Get a view of the frame encoded in RGBA32, with the color components
+  /// optionally premultiplied by the alpha component.
+  const Rgba32VideoFrame& GetRgba32(bool premultiplied_alpha) noexcept;
+
+  /// Get a view of the frame encoded in BGRA32, with the color components
+  /// optionally premultiplied by the alpha component. With straight alpha,
+  /// this shares the buffer of |GetArgb32()| which has the same layout.
+  const Bgra32VideoFrame& GetBgra32(bool premultiplied_alpha) noexcept;
+
+  /// Get a view of the frame encoded in NV12. The alpha plane, if any, is
+  /// discarded.
+  const Nv12VideoFrame& GetNv12() noexcept;
+
+ protected:
+  explicit VideoFrameHandle(
+      rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer) noexcept;
+  ~VideoFrameHandle() noexcept override;
+
+ private:
+  /// Frame buffer in its native encoding, as produced by the source.
+  const rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer_;
+
+  /// I420 buffer, if |buffer_| is neither I420 nor I420A and needed to be
+  /// converted. Otherwise the I420A view points directly into |buffer_|.
+  rtc::scoped_refptr<webrtc::I420BufferInterface> i420_buffer_;
+  I420AVideoFrame i420a_frame_{};
+  std::once_flag i420a_once_;
+
+  /// Cached ARGB32 conversion.
+  rtc::scoped_refptr<ArgbBuffer> argb_buffer_;
+  Argb32VideoFrame argb32_frame_{};
+  std::once_flag argb32_once_;
+
+  /// Cached RGBA32 conversions, with straight (index 0) and premultiplied
+  /// (index 1) alpha. Frames without alpha plane are opaque, so both views
+  /// share the same buffer in that case.
+  rtc::scoped_refptr<ArgbBuffer> rgba32_buffers_[2];
+  Rgba32VideoFrame rgba32_frames_[2]{};
+  std::once_flag rgba32_once_[2];
+
+  /// Cached BGRA32 conversions, indexed like |rgba32_frames_|. The straight
+  /// alpha view points into |argb_buffer_|.
+  rtc::scoped_refptr<ArgbBuffer> bgra32_premultiplied_buffer_;
+  Bgra32VideoFrame bgra32_frames_[2]{};
+  std::once_flag bgra32_once_[2];
+
+  /// Cached NV12 conversion.
+  PooledMemory nv12_data_;
+  Nv12VideoFrame nv12_frame_{};
+  std::once_flag nv12_once_;
+};
+
+}  // namespace Microsoft::MixedReality::WebRTC
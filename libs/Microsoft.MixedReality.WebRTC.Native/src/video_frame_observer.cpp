@@ -4,14 +4,9 @@
 
 #include "pch.h"
 
-#include "video_frame_observer.h"
-
-namespace {
+#include <algorithm>
 
-// Aligning pointer to 64 bytes for improved performance, e.g. use SIMD.
-constexpr int kBufferAlignment = 64;
-
-}  // namespace
+#include "video_frame_observer.h"
 
 namespace Microsoft::MixedReality::WebRTC {
 
@@ -19,18 +14,16 @@ ArgbBuffer::ArgbBuffer(int width, int height, int stride) noexcept
     : width_(width),
       height_(height),
       stride_(stride),
-      data_(static_cast<uint8_t*>(
-          webrtc::AlignedMalloc(static_cast<size_t>(height) * stride,
-                                kBufferAlignment))) {
+      data_(FrameBufferPool::Instance().Acquire(static_cast<size_t>(height) *
+                                                stride)) {
   RTC_DCHECK_GT(width, 0);
   RTC_DCHECK_GT(height, 0);
   RTC_DCHECK_GE(stride, 4 * width);
 }
 
 rtc::scoped_refptr<webrtc::I420BufferInterface> ArgbBuffer::ToI420() {
-  rtc::scoped_refptr<webrtc::I420Buffer> i420_buffer =
-      webrtc::I420Buffer::Create(width_, height_, stride_, stride_ / 2,
-                                 stride_ / 2);
+  rtc::scoped_refptr<PooledI420Buffer> i420_buffer =
+      FrameBufferPool::Instance().CreateI420Buffer(width_, height_);
   libyuv::ARGBToI420(Data(), Stride(), i420_buffer->MutableDataY(),
                      i420_buffer->StrideY(), i420_buffer->MutableDataU(),
                      i420_buffer->StrideU(), i420_buffer->MutableDataV(),
@@ -38,117 +31,258 @@ rtc::scoped_refptr<webrtc::I420BufferInterface> ArgbBuffer::ToI420() {
   return i420_buffer;
 }
 
+VideoFrameObserver::~VideoFrameObserver() noexcept {
+  auto lock = std::scoped_lock{config_mutex_};
+  StopDeliveryThread();
+}
+
 void VideoFrameObserver::SetCallback(
     I420AFrameReadyCallback callback) noexcept {
-  auto lock = std::scoped_lock{mutex_};
-  i420a_callback_ = std::move(callback);
+  i420a_callback_.Set(std::move(callback));
 }
 
 void VideoFrameObserver::SetCallback(
     Argb32FrameReadyCallback callback) noexcept {
-  auto lock = std::scoped_lock{mutex_};
-  argb_callback_ = std::move(callback);
+  argb_callback_.Set(std::move(callback));
+}
+
+void VideoFrameObserver::SetCallback(
+    Nv12FrameReadyCallback callback) noexcept {
+  nv12_callback_.Set(std::move(callback));
 }
 
-ArgbBuffer* VideoFrameObserver::GetArgbScratchBuffer(int width, int height) {
-  const size_t needed_size = Argb32FrameSize(width, height);
-  if (auto* buffer = argb_scratch_buffer_.get()) {
-    if (buffer->Size() >= needed_size) {
-      return buffer;
+void VideoFrameObserver::SetCallback(
+    Rgba32FrameReadyCallback callback) noexcept {
+  rgba_callback_.Set(std::move(callback));
+}
+
+void VideoFrameObserver::SetCallback(
+    Bgra32FrameReadyCallback callback) noexcept {
+  bgra_callback_.Set(std::move(callback));
+}
+
+void VideoFrameObserver::SetCallback(
+    VideoFrameHandleReadyCallback callback) noexcept {
+  handle_callback_.Set(std::move(callback));
+}
+
+void VideoFrameObserver::SetCallback(
+    TrackVideoFrameHandleReadyCallback callback) noexcept {
+  track_handle_callback_.Set(std::move(callback));
+}
+
+Result VideoFrameObserver::SetDeliveryConfig(
+    const VideoFrameDeliveryConfig& config) noexcept {
+  if (config.async_ && (config.queue_capacity_ <= 0)) {
+    return Result::kInvalidParameter;
+  }
+  auto config_lock = std::scoped_lock{config_mutex_};
+  if (!config.async_) {
+    StopDeliveryThread();
+    return Result::kSuccess;
+  }
+  {
+    auto lock = std::scoped_lock{queue_mutex_};
+    drop_policy_ = config.drop_policy_;
+    const size_t capacity = static_cast<size_t>(config.queue_capacity_);
+    if (capacity != queue_.size()) {
+      // Rebuild the ring buffer, keeping the most recent frames.
+      std::vector<QueuedFrame> queue(capacity);
+      const size_t dropped_count =
+          (queue_size_ > capacity ? queue_size_ - capacity : 0);
+      const size_t kept_count = queue_size_ - dropped_count;
+      for (size_t i = 0; i < kept_count; ++i) {
+        const size_t index =
+            (queue_head_ + dropped_count + i) % queue_.size();
+        queue[i] = std::move(queue_[index]);
+      }
+      queue_ = std::move(queue);
+      queue_head_ = 0;
+      queue_size_ = kept_count;
+      dropped_count_.fetch_add(dropped_count, std::memory_order_relaxed);
+    }
+    if (delivery_thread_running_) {
+      return Result::kSuccess;
     }
+    delivery_thread_running_ = true;
   }
-  argb_scratch_buffer_ = ArgbBuffer::Create(width, height);
-  return argb_scratch_buffer_.get();
+  delivery_thread_ = std::thread([this]() { RunDeliveryThread(); });
+  async_enabled_.store(true, std::memory_order_release);
+  return Result::kSuccess;
 }
 
-void VideoFrameObserver::OnFrame(const webrtc::VideoFrame& frame) noexcept {
-  auto lock = std::scoped_lock{mutex_};
-  if (!i420a_callback_ && !argb_callback_) {
-    return;
+VideoFrameDeliveryStats VideoFrameObserver::GetDeliveryStats() const noexcept {
+  VideoFrameDeliveryStats stats;
+  stats.delivered_count_ = delivered_count_.load(std::memory_order_relaxed);
+  stats.dropped_count_ = dropped_count_.load(std::memory_order_relaxed);
+  std::array<int64_t, kLatencySampleCount> samples;
+  size_t sample_count;
+  {
+    auto lock = std::scoped_lock{queue_mutex_};
+    stats.queue_size_ = static_cast<int>(queue_size_);
+    sample_count = std::min(latency_sample_count_, kLatencySampleCount);
+    std::copy_n(latency_samples_.begin(), sample_count, samples.begin());
+  }
+  if (sample_count > 0) {
+    std::sort(samples.begin(), samples.begin() + sample_count);
+    auto percentile = [&](size_t p) {
+      return samples[std::min((sample_count * p) / 100, sample_count - 1)];
+    };
+    stats.latency_p50_us_ = percentile(50);
+    stats.latency_p90_us_ = percentile(90);
+    stats.latency_p99_us_ = percentile(99);
   }
+  return stats;
+}
 
+void VideoFrameObserver::OnFrame(const webrtc::VideoFrame& frame) noexcept {
   rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer(
       frame.video_frame_buffer());
-
-  const int width = frame.width();
-  const int height = frame.height();
-
-  if (buffer->type() != webrtc::VideoFrameBuffer::Type::kI420A) {
-    // The buffer is not encoded in I420 with alpha channel; use I420 without
-    // alpha channel as interchange format for the callback, and convert the
-    // buffer to that (or do nothing if already in I420).
-    rtc::scoped_refptr<webrtc::I420BufferInterface> i420_buffer =
-        buffer->ToI420();
-    const uint8_t* const yptr = i420_buffer->DataY();
-    const uint8_t* const uptr = i420_buffer->DataU();
-    const uint8_t* const vptr = i420_buffer->DataV();
-
-    if (i420a_callback_) {
-      I420AVideoFrame i420a_frame;
-      i420a_frame.ydata_ = yptr;
-      i420a_frame.udata_ = uptr;
-      i420a_frame.vdata_ = vptr;
-      i420a_frame.adata_ = nullptr;
-      i420a_frame.ystride_ = i420_buffer->StrideY();
-      i420a_frame.ustride_ = i420_buffer->StrideU();
-      i420a_frame.vstride_ = i420_buffer->StrideV();
-      i420a_frame.astride_ = 0;
-      i420a_frame.width_ = width;
-      i420a_frame.height_ = height;
-      i420a_callback_(i420a_frame);
+  if (async_enabled_.load(std::memory_order_acquire)) {
+    if (EnqueueFrame(buffer)) {
+      return;
     }
+    // Asynchronous mode was disabled concurrently; fall back to synchronous
+    // delivery.
+  }
+  DeliverFrame(buffer);
+}
 
-    if (argb_callback_) {
-      ArgbBuffer* const argb_buffer = GetArgbScratchBuffer(width, height);
-      libyuv::I420ToARGB(yptr, i420_buffer->StrideY(), uptr,
-                         i420_buffer->StrideU(), vptr, i420_buffer->StrideV(),
-                         argb_buffer->Data(), argb_buffer->Stride(), width,
-                         height);
-      Argb32VideoFrame argb32_frame;
-      argb32_frame.argb32_data_ = argb_buffer->Data();
-      argb32_frame.stride_ = argb_buffer->Stride();
-      argb32_frame.width_ = width;
-      argb32_frame.height_ = height;
-      argb_callback_(argb32_frame);
+bool VideoFrameObserver::EnqueueFrame(
+    rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer) {
+  // Dropped frames are released outside the lock, since releasing the last
+  // reference to a frame buffer can be somewhat expensive.
+  rtc::scoped_refptr<webrtc::VideoFrameBuffer> dropped_buffer;
+  {
+    auto lock = std::scoped_lock{queue_mutex_};
+    if (!delivery_thread_running_) {
+      return false;
+    }
+    const size_t capacity = queue_.size();
+    if (drop_policy_ == VideoFrameDropPolicy::kKeepLatest) {
+      // Discard all pending frames; only the last one is delivered.
+      while (queue_size_ > 0) {
+        dropped_buffer = std::move(queue_[queue_head_].buffer_);
+        queue_head_ = (queue_head_ + 1) % capacity;
+        --queue_size_;
+        dropped_count_.fetch_add(1, std::memory_order_relaxed);
+      }
+    } else if (queue_size_ == capacity) {
+      if (drop_policy_ == VideoFrameDropPolicy::kDropNewest) {
+        dropped_count_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+      }
+      // kDropOldest
+      dropped_buffer = std::move(queue_[queue_head_].buffer_);
+      queue_head_ = (queue_head_ + 1) % capacity;
+      --queue_size_;
+      dropped_count_.fetch_add(1, std::memory_order_relaxed);
     }
+    QueuedFrame& entry = queue_[(queue_head_ + queue_size_) % capacity];
+    entry.buffer_ = std::move(buffer);
+    entry.enqueue_time_us_ = rtc::TimeMicros();
+    ++queue_size_;
+  }
+  queue_cv_.notify_one();
+  return true;
+}
 
-  } else {
-    // The buffer is encoded in I420 with alpha channel, use it directly.
-    webrtc::I420ABufferInterface* i420a_buffer = buffer->GetI420A();
-    const uint8_t* const yptr = i420a_buffer->DataY();
-    const uint8_t* const uptr = i420a_buffer->DataU();
-    const uint8_t* const vptr = i420a_buffer->DataV();
-    const uint8_t* const aptr = i420a_buffer->DataA();
-
-    if (i420a_callback_) {
-      I420AVideoFrame i420a_frame;
-      i420a_frame.ydata_ = yptr;
-      i420a_frame.udata_ = uptr;
-      i420a_frame.vdata_ = vptr;
-      i420a_frame.adata_ = aptr;
-      i420a_frame.ystride_ = i420a_buffer->StrideY();
-      i420a_frame.ustride_ = i420a_buffer->StrideU();
-      i420a_frame.vstride_ = i420a_buffer->StrideV();
-      i420a_frame.astride_ = i420a_buffer->StrideA();
-      i420a_frame.width_ = width;
-      i420a_frame.height_ = height;
-      i420a_callback_(i420a_frame);
+void VideoFrameObserver::RunDeliveryThread() noexcept {
+  std::unique_lock<std::mutex> lock(queue_mutex_);
+  while (true) {
+    queue_cv_.wait(lock, [this]() {
+      return (!delivery_thread_running_ || (queue_size_ > 0));
+    });
+    if (!delivery_thread_running_) {
+      break;
     }
 
-    if (argb_callback_) {
-      ArgbBuffer* const argb_buffer = GetArgbScratchBuffer(width, height);
-      libyuv::I420AlphaToARGB(
-          yptr, i420a_buffer->StrideY(), uptr, i420a_buffer->StrideU(), vptr,
-          i420a_buffer->StrideV(), aptr, i420a_buffer->StrideA(),
-          argb_buffer->Data(), argb_buffer->Stride(), width, height, 0);
-      Argb32VideoFrame argb32_frame;
-      argb32_frame.argb32_data_ = argb_buffer->Data();
-      argb32_frame.stride_ = argb_buffer->Stride();
-      argb32_frame.width_ = width;
-      argb32_frame.height_ = height;
-      argb_callback_(argb32_frame);
+    // Dequeue the oldest frame
+    QueuedFrame& entry = queue_[queue_head_];
+    rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer =
+        std::move(entry.buffer_);
+    const int64_t latency_us = rtc::TimeMicros() - entry.enqueue_time_us_;
+    queue_head_ = (queue_head_ + 1) % queue_.size();
+    --queue_size_;
+    latency_samples_[latency_sample_count_ % kLatencySampleCount] = latency_us;
+    ++latency_sample_count_;
+
+    // Deliver the frame without holding the lock, to allow the producer to
+    // continue queuing frames while the callbacks execute.
+    lock.unlock();
+    DeliverFrame(buffer);
+    buffer = nullptr;
+    lock.lock();
+  }
+}
+
+void VideoFrameObserver::StopDeliveryThread() noexcept {
+  async_enabled_.store(false, std::memory_order_release);
+  std::vector<QueuedFrame> queue;
+  {
+    auto lock = std::scoped_lock{queue_mutex_};
+    if (!delivery_thread_running_) {
+      return;
     }
+    delivery_thread_running_ = false;
+    dropped_count_.fetch_add(queue_size_, std::memory_order_relaxed);
+    queue.swap(queue_);
+    queue_head_ = 0;
+    queue_size_ = 0;
+  }
+  queue_cv_.notify_all();
+  if (delivery_thread_.joinable()) {
+    delivery_thread_.join();
   }
 }
 
+void VideoFrameObserver::DeliverFrame(
+    const rtc::scoped_refptr<webrtc::VideoFrameBuffer>& buffer) noexcept {
+  // Check which callbacks are registered to avoid creating a frame handle if
+  // nobody consumes the frame. The callbacks can change concurrently, in which
+  // case this frame is either delivered to the new callback or skipped, but
+  // never to a callback already unregistered.
+  const bool has_i420a_callback = i420a_callback_.IsSet();
+  const bool has_argb_callback = argb_callback_.IsSet();
+  const bool has_nv12_callback = nv12_callback_.IsSet();
+  const bool has_rgba_callback = rgba_callback_.IsSet();
+  const bool has_bgra_callback = bgra_callback_.IsSet();
+  const bool has_handle_callback = handle_callback_.IsSet();
+  const bool has_track_handle_callback = track_handle_callback_.IsSet();
+  if (!has_i420a_callback && !has_argb_callback && !has_nv12_callback &&
+      !has_rgba_callback && !has_bgra_callback && !has_handle_callback &&
+      !has_track_handle_callback) {
+    return;
+  }
+
+  // All callbacks share the same handle, so that each encoding is converted at
+  // most once, and only when accessed.
+  RefPtr<VideoFrameHandle> handle = VideoFrameHandle::Create(buffer);
+  if (has_i420a_callback) {
+    i420a_callback_(handle->GetI420A());
+  }
+  if (has_argb_callback) {
+    argb_callback_(handle->GetArgb32());
+  }
+  if (has_nv12_callback) {
+    nv12_callback_(handle->GetNv12());
+  }
+  if (has_rgba_callback) {
+    // The encoding depends on the premultiplied alpha setting of the callback,
+    // so let the callback select the view to convert.
+    rgba_callback_(*handle);
+  }
+  if (has_bgra_callback) {
+    bgra_callback_(*handle);
+  }
+  if (has_handle_callback) {
+    handle_callback_(handle.get());
+  }
+  if (has_track_handle_callback) {
+    track_handle_callback_(source_id_.c_str(), handle.get());
+  }
+
+  delivered_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
 }  // namespace Microsoft::MixedReality::WebRTC
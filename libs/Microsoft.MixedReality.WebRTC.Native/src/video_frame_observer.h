@@ -3,15 +3,22 @@
 
 #pragma once
 
+#include <array>
+#include <condition_variable>
 #include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "api/video/video_frame.h"
 #include "api/video/video_sink_interface.h"
 
 #include "callback.h"
+#include "callback_slot.h"
+#include "frame_buffer_pool.h"
+#include "result.h"
 #include "video_frame.h"
-
-#include "rtc_base/memory/aligned_malloc.h"
+#include "video_frame_handle.h"
 
 namespace Microsoft::MixedReality::WebRTC {
 
@@ -21,13 +28,61 @@ using I420AFrameReadyCallback = Callback<const I420AVideoFrame&>;
 /// Callback fired on newly available video frame, encoded as ARGB.
 using Argb32FrameReadyCallback = Callback<const Argb32VideoFrame&>;
 
+/// Callback fired on newly available video frame, encoded as NV12.
+using Nv12FrameReadyCallback = Callback<const Nv12VideoFrame&>;
+
+/// Callback fired on newly available video frame, encoded as RGBA32, with the
+/// color components optionally premultiplied by alpha.
+struct Rgba32FrameReadyCallback {
+  Callback<const Rgba32VideoFrame&> callback_;
+  bool premultiplied_alpha_{false};
+
+  constexpr explicit operator bool() const noexcept {
+    return static_cast<bool>(callback_);
+  }
+
+  /// Invoke the callback with the frame converted to the requested encoding.
+  void operator()(VideoFrameHandle& frame) const noexcept {
+    callback_(frame.GetRgba32(premultiplied_alpha_));
+  }
+};
+
+/// Callback fired on newly available video frame, encoded as BGRA32, with the
+/// color components optionally premultiplied by alpha.
+struct Bgra32FrameReadyCallback {
+  Callback<const Bgra32VideoFrame&> callback_;
+  bool premultiplied_alpha_{false};
+
+  constexpr explicit operator bool() const noexcept {
+    return static_cast<bool>(callback_);
+  }
+
+  /// Invoke the callback with the frame converted to the requested encoding.
+  void operator()(VideoFrameHandle& frame) const noexcept {
+    callback_(frame.GetBgra32(premultiplied_alpha_));
+  }
+};
+
+/// Callback fired on newly available video frame, with a handle to the frame
+/// converting it on demand into the encoding(s) the consumer needs. The handle
+/// is only valid during the callback, unless the consumer adds a reference to
+/// it with |VideoFrameHandle::AddRef()|.
+using VideoFrameHandleReadyCallback = Callback<VideoFrameHandle*>;
+
+/// Callback fired on newly available video frame of a given remote video track,
+/// with the ID of that track and a handle to the frame, as for
+/// |VideoFrameHandleReadyCallback|.
+using TrackVideoFrameHandleReadyCallback =
+    Callback<const char*, VideoFrameHandle*>;
+
 /// Helper function to calculate the minimum size of an ARGB32 frame given its
 /// dimensions in pixels.
 constexpr inline size_t Argb32FrameSize(int width, int height) {
   return (static_cast<size_t>(height) * width) * 4;
 }
 
-// Plain 32-bit ARGB buffer in standard memory.
+// Plain 32-bit ARGB buffer in standard memory, acquired from the global
+// |FrameBufferPool| and returned to it when the buffer is destroyed.
 class ArgbBuffer : public webrtc::VideoFrameBuffer {
  public:
   // Create a new buffer with enough storage for a frame with the given
@@ -92,12 +147,78 @@ class ArgbBuffer : public webrtc::VideoFrameBuffer {
   const int stride_;
 
   /// Raw buffer of ARGB32 data for the frame.
-  const std::unique_ptr<uint8_t, webrtc::AlignedFreeDeleter> data_;
+  const PooledMemory data_;
+};
+
+/// Policy applied by the asynchronous delivery queue of a |VideoFrameObserver|
+/// when a new frame is received while the queue is full.
+enum class VideoFrameDropPolicy : int32_t {
+  /// Discard the oldest queued frame to make room for the new one.
+  kDropOldest = 0,
+
+  /// Discard the new frame, and keep all the frames already queued.
+  kDropNewest = 1,
+
+  /// Keep only the latest frame; any frame queued but not delivered yet is
+  /// discarded when a new frame is received, whatever the queue capacity.
+  kKeepLatest = 2,
+};
+
+/// Frame delivery configuration of a |VideoFrameObserver|.
+struct VideoFrameDeliveryConfig {
+  /// Deliver the frames asynchronously on a dedicated thread, instead of
+  /// directly on the thread producing them (generally the decoder thread).
+  bool async_{false};
+
+  /// Maximum number of frames queued for asynchronous delivery.
+  int queue_capacity_{4};
+
+  /// Policy applied when a frame is received while the queue is full.
+  VideoFrameDropPolicy drop_policy_{VideoFrameDropPolicy::kDropOldest};
+};
+
+/// Frame delivery statistics of a |VideoFrameObserver|.
+struct VideoFrameDeliveryStats {
+  /// Number of frames delivered to the registered callbacks.
+  uint64_t delivered_count_{0};
+
+  /// Number of frames discarded by the drop policy of the queue.
+  uint64_t dropped_count_{0};
+
+  /// Number of frames currently queued and waiting for delivery.
+  int queue_size_{0};
+
+  /// Percentiles of the time frames spent in the queue before being delivered,
+  /// in microseconds, over the most recent frames.
+  int64_t latency_p50_us_{0};
+  int64_t latency_p90_us_{0};
+  int64_t latency_p99_us_{0};
 };
 
 /// Video frame observer to get notified of newly available video frames.
+///
+/// Frames are delivered without holding any lock, so that a slow callback does
+/// not delay the registration of other callbacks. Changing a callback only
+/// waits for the invocations of the previous one currently in progress.
+///
+/// By default frames are delivered synchronously on the thread producing them.
+/// Optionally, |SetDeliveryConfig()| enables an asynchronous mode where the
+/// frame buffers are queued without copy into a bounded queue, and delivered
+/// on a dedicated thread, so that a slow consumer does not stall the producer.
 class VideoFrameObserver : public rtc::VideoSinkInterface<webrtc::VideoFrame> {
  public:
+  VideoFrameObserver() noexcept = default;
+
+  /// Create an observer for the frames of a single source, like a remote video
+  /// track, whose ID is passed to the |TrackVideoFrameHandleReadyCallback|.
+  explicit VideoFrameObserver(std::string source_id) noexcept
+      : source_id_(std::move(source_id)) {}
+
+  ~VideoFrameObserver() noexcept override;
+
+  /// ID of the source this observer is attached to, if any.
+  const std::string& source_id() const noexcept { return source_id_; }
+
   /// Register a callback to get notified on frame available,
   /// and received that frame as a I420-encoded buffer.
   /// This is not exclusive and can be used along another ARGB callback.
@@ -108,29 +229,133 @@ class VideoFrameObserver : public rtc::VideoSinkInterface<webrtc::VideoFrame> {
   /// This is not exclusive and can be used along another I420 callback.
   void SetCallback(Argb32FrameReadyCallback callback) noexcept;
 
- protected:
-  /// Get a temporary scratch buffer for an ARGB32 frame of the given
-  /// dimensions. The returned buffer does not need to be deallocated, but can
-  /// be reused by a later call so concurrent access is not supported.
-  /// Before calling this method the caller needs to acquire |mutex_|, and keep
-  /// it for the duration of its access.
-  ArgbBuffer* GetArgbScratchBuffer(int width, int height);
+  /// Register a callback to get notified on frame available,
+  /// and received that frame as an NV12-encoded buffer.
+  void SetCallback(Nv12FrameReadyCallback callback) noexcept;
+
+  /// Register a callback to get notified on frame available,
+  /// and received that frame as an RGBA32-encoded buffer.
+  void SetCallback(Rgba32FrameReadyCallback callback) noexcept;
+
+  /// Register a callback to get notified on frame available,
+  /// and received that frame as a BGRA32-encoded buffer.
+  void SetCallback(Bgra32FrameReadyCallback callback) noexcept;
+
+  /// Register a callback to get notified on frame available, and receive a
+  /// handle to that frame shared with the other callbacks, so that each
+  /// encoding is converted at most once per frame.
+  void SetCallback(VideoFrameHandleReadyCallback callback) noexcept;
+
+  /// Register a callback to get notified on frame available, and receive the
+  /// ID of the source of this observer along a handle to that frame.
+  void SetCallback(TrackVideoFrameHandleReadyCallback callback) noexcept;
+
+  /// Change the frame delivery mode. Disabling the asynchronous mode discards
+  /// all queued frames, and waits for the delivery thread to terminate, so
+  /// this must not be called from a frame callback.
+  Result SetDeliveryConfig(const VideoFrameDeliveryConfig& config) noexcept;
+
+  /// Get a snapshot of the frame delivery statistics.
+  VideoFrameDeliveryStats GetDeliveryStats() const noexcept;
 
+ protected:
   // VideoSinkInterface interface
   void OnFrame(const webrtc::VideoFrame& frame) noexcept override;
 
+  /// Invoke the registered callbacks, converting the frame buffer on demand
+  /// through a |VideoFrameHandle| shared by all callbacks.
+  void DeliverFrame(
+      const rtc::scoped_refptr<webrtc::VideoFrameBuffer>& buffer) noexcept;
+
+  /// Try to queue a frame for asynchronous delivery. Return |false| if the
+  /// asynchronous mode is disabled, in which case the frame is not queued.
+  bool EnqueueFrame(rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer);
+
+  /// Entry point of the asynchronous delivery thread.
+  void RunDeliveryThread() noexcept;
+
+  /// Stop the asynchronous delivery thread, if running, and discard all queued
+  /// frames. The caller must hold |config_mutex_|.
+  void StopDeliveryThread() noexcept;
+
  private:
+  /// Frame buffer queued for asynchronous delivery.
+  struct QueuedFrame {
+    rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer_;
+    int64_t enqueue_time_us_{0};
+  };
+
+  /// Number of queue latency samples used to compute percentiles.
+  static constexpr size_t kLatencySampleCount = 256;
+
   /// Registered callback for receiving I420-encoded frame.
-  I420AFrameReadyCallback i420a_callback_ RTC_GUARDED_BY(mutex_);
+  CallbackSlot<I420AFrameReadyCallback> i420a_callback_;
 
   /// Registered callback for receiving raw decoded ARGB frame.
-  Argb32FrameReadyCallback argb_callback_ RTC_GUARDED_BY(mutex_);
+  CallbackSlot<Argb32FrameReadyCallback> argb_callback_;
+
+  /// Registered callback for receiving NV12-encoded frame.
+  CallbackSlot<Nv12FrameReadyCallback> nv12_callback_;
+
+  /// Registered callback for receiving RGBA32-encoded frame.
+  CallbackSlot<Rgba32FrameReadyCallback> rgba_callback_;
+
+  /// Registered callback for receiving BGRA32-encoded frame.
+  CallbackSlot<Bgra32FrameReadyCallback> bgra_callback_;
+
+  /// Registered callback for receiving a frame handle.
+  CallbackSlot<VideoFrameHandleReadyCallback> handle_callback_;
+
+  /// Registered callback for receiving a frame handle tagged with its source.
+  CallbackSlot<TrackVideoFrameHandleReadyCallback> track_handle_callback_;
+
+  /// ID of the source of the frames, if any.
+  const std::string source_id_;
+
+  /// Fast check for the asynchronous mode, to avoid locking |queue_mutex_| in
+  /// synchronous mode. The authoritative value is |delivery_thread_running_|.
+  std::atomic_bool async_enabled_{false};
+
+  /// Ring buffer of frames queued for asynchronous delivery. The capacity of
+  /// the queue is the size of the vector.
+  std::vector<QueuedFrame> queue_ RTC_GUARDED_BY(queue_mutex_);
+
+  /// Index of the oldest frame in |queue_|.
+  size_t queue_head_ RTC_GUARDED_BY(queue_mutex_){0};
+
+  /// Number of frames in |queue_|.
+  size_t queue_size_ RTC_GUARDED_BY(queue_mutex_){0};
+
+  /// Policy applied when the queue is full.
+  VideoFrameDropPolicy drop_policy_ RTC_GUARDED_BY(queue_mutex_){
+      VideoFrameDropPolicy::kDropOldest};
+
+  /// Is the delivery thread running and consuming the queue?
+  bool delivery_thread_running_ RTC_GUARDED_BY(queue_mutex_){false};
+
+  /// Ring buffer of the most recent queue latency samples, in microseconds.
+  std::array<int64_t, kLatencySampleCount> latency_samples_
+      RTC_GUARDED_BY(queue_mutex_){};
+
+  /// Total number of latency samples recorded, used to index
+  /// |latency_samples_|.
+  size_t latency_sample_count_ RTC_GUARDED_BY(queue_mutex_){0};
+
+  /// Mutex protecting the frame queue and associated state.
+  mutable std::mutex queue_mutex_;
+
+  /// Condition variable signaled when a frame is queued, or when the delivery
+  /// thread is requested to stop.
+  std::condition_variable queue_cv_;
+
+  /// Asynchronous delivery thread.
+  std::thread delivery_thread_ RTC_GUARDED_BY(config_mutex_);
 
-  /// Mutex protecting all callbacks as well as the ARGB32 scratch buffer.
-  std::mutex mutex_;
+  /// Mutex serializing changes to the delivery configuration.
+  std::mutex config_mutex_;
 
-  /// Reusable ARGB scratch buffer to avoid per-frame allocation.
-  rtc::scoped_refptr<ArgbBuffer> argb_scratch_buffer_ RTC_GUARDED_BY(mutex_);
+  std::atomic_uint64_t delivered_count_{0};
+  std::atomic_uint64_t dropped_count_{0};
 };
 
 }  // namespace Microsoft::MixedReality::WebRTC
@@ -0,0 +1,139 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include <algorithm>
+
+#include "worker_pool.h"
+
+namespace {
+
+/// Maximum number of worker threads of the default pool. Video conversions
+/// are mostly memory-bound, so adding more threads quickly stops paying off.
+constexpr int kMaxDefaultWorkerCount = 4;
+
+}  // namespace
+
+namespace Microsoft::MixedReality::WebRTC {
+
+WorkerPool& WorkerPool::Instance() noexcept {
+  // Intentionally leaked; see declaration.
+  static WorkerPool* const instance = new WorkerPool();
+  return *instance;
+}
+
+WorkerPool::WorkerPool(int worker_count) noexcept
+    : worker_count_(worker_count > 0
+                        ? worker_count
+                        : std::clamp(
+                              (int)std::thread::hardware_concurrency() - 1, 1,
+                              kMaxDefaultWorkerCount)) {}
+
+WorkerPool::~WorkerPool() noexcept {
+  Shutdown();
+}
+
+void WorkerPool::ParallelFor(int task_count,
+                             const std::function<void(int)>& func) {
+  if (task_count <= 0) {
+    return;
+  }
+  if (task_count == 1) {
+    func(0);
+    return;
+  }
+  Job job;
+  job.func_ = &func;
+  job.task_count_ = task_count;
+  bool queued = false;
+  {
+    auto lock = std::scoped_lock{mutex_};
+    if (EnsureStarted()) {
+      jobs_.push_back(&job);
+      queued = true;
+    }
+  }
+  if (!queued) {
+    // Shutting down; execute all tasks serially without starting any thread.
+    RunTasks(job);
+    return;
+  }
+  job_cv_.notify_all();
+
+  // Help executing the tasks, which also guarantees forward progress if all
+  // workers are busy with other jobs.
+  RunTasks(job);
+
+  // All tasks are started; wait for the ones executing on worker threads.
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = std::find(jobs_.begin(), jobs_.end(), &job);
+  if (it != jobs_.end()) {
+    jobs_.erase(it);
+  }
+  done_cv_.wait(lock, [&job]() { return (job.worker_count_ == 0); });
+}
+
+void WorkerPool::Shutdown() noexcept {
+  auto shutdown_lock = std::scoped_lock{shutdown_mutex_};
+  std::vector<std::thread> threads;
+  {
+    auto lock = std::scoped_lock{mutex_};
+    stop_requested_ = true;
+    threads.swap(threads_);
+  }
+  job_cv_.notify_all();
+  for (auto&& thread : threads) {
+    thread.join();
+  }
+  auto lock = std::scoped_lock{mutex_};
+  stop_requested_ = false;
+}
+
+void WorkerPool::RunTasks(Job& job) noexcept {
+  int index;
+  while ((index = job.next_task_.fetch_add(1)) < job.task_count_) {
+    (*job.func_)(index);
+  }
+}
+
+void WorkerPool::RunWorker() noexcept {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    job_cv_.wait(lock,
+                 [this]() { return (stop_requested_ || !jobs_.empty()); });
+    if (stop_requested_) {
+      break;
+    }
+
+    // Take a reference to the oldest job, and remove it from the queue once all
+    // its tasks are started so that other workers move to the next job.
+    Job& job = *jobs_.front();
+    ++job.worker_count_;
+    lock.unlock();
+    RunTasks(job);
+    lock.lock();
+    if (!jobs_.empty() && (jobs_.front() == &job)) {
+      jobs_.pop_front();
+    }
+    if (--job.worker_count_ == 0) {
+      done_cv_.notify_all();
+    }
+  }
+}
+
+bool WorkerPool::EnsureStarted() {
+  if (stop_requested_) {
+    return false;
+  }
+  if (!threads_.empty()) {
+    return true;
+  }
+  threads_.reserve(worker_count_);
+  for (int i = 0; i < worker_count_; ++i) {
+    threads_.emplace_back([this]() { RunWorker(); });
+  }
+  return true;
+}
+
+}  // namespace Microsoft::MixedReality::WebRTC
@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "rtc_base/thread_annotations.h"
+
+namespace Microsoft::MixedReality::WebRTC {
+
+/// Small pool of worker threads used to split CPU-intensive work, like video
+/// frame conversions, into tasks executed in parallel.
+///
+/// The worker threads are started on first use, and stopped by |Shutdown()|
+/// when the library shuts down, to allow the module to be unloaded.
+class WorkerPool {
+ public:
+  /// Get the global pool instance shared by all objects.
+  /// The global pool is never destroyed; see |FrameBufferPool::Instance()|.
+  static WorkerPool& Instance() noexcept;
+
+  /// Create a pool with the given number of worker threads. A value of zero
+  /// selects a default number of workers based on the number of CPU cores.
+  explicit WorkerPool(int worker_count = 0) noexcept;
+  ~WorkerPool() noexcept;
+
+  /// Number of tasks which can execute in parallel, including the calling
+  /// thread of |ParallelFor()|.
+  int GetConcurrency() const noexcept { return worker_count_ + 1; }
+
+  /// Invoke |func(index)| for all |index| in [0, task_count), potentially in
+  /// parallel on the worker threads. The calling thread also executes tasks,
+  /// and this call returns once all tasks completed. Tasks must not throw.
+  /// While |Shutdown()| is in progress, all tasks execute serially on the
+  /// calling thread.
+  void ParallelFor(int task_count, const std::function<void(int)>& func);
+
+  /// Stop all worker threads, and wait for them to exit. Those are restarted
+  /// on the next use following this call.
+  void Shutdown() noexcept;
+
+ protected:
+  /// Group of tasks submitted by a single |ParallelFor()| call.
+  struct Job {
+    const std::function<void(int)>* func_{};
+    int task_count_{0};
+
+    /// Index of the next task to execute.
+    std::atomic_int next_task_{0};
+
+    /// Number of worker threads currently executing tasks of this job.
+    /// Protected by |WorkerPool::mutex_|.
+    int worker_count_{0};
+  };
+
+  /// Execute tasks from |job| until none is left.
+  static void RunTasks(Job& job) noexcept;
+
+  /// Entry point of the worker threads.
+  void RunWorker() noexcept;
+
+  /// Start the worker threads if not already running, and return |true| if
+  /// they are. Return |false| without starting them if |Shutdown()| is in
+  /// progress. The caller must hold |mutex_|.
+  bool EnsureStarted();
+
+ private:
+  /// Number of worker threads, not including the calling thread.
+  const int worker_count_;
+
+  /// Worker threads. Empty if not started.
+  std::vector<std::thread> threads_ RTC_GUARDED_BY(mutex_);
+
+  /// Jobs with tasks not yet all started.
+  std::deque<Job*> jobs_ RTC_GUARDED_BY(mutex_);
+
+  /// Request the worker threads to exit. Set for the entire duration of
+  /// |Shutdown()|, so that no thread is started while it joins the workers.
+  bool stop_requested_ RTC_GUARDED_BY(mutex_){false};
+
+  std::mutex mutex_;
+
+  /// Serializes |Shutdown()| calls, so that a concurrent call does not clear
+  /// |stop_requested_| before the other one joined its threads.
+  std::mutex shutdown_mutex_;
+
+  /// Signaled when a job is submitted or on shutdown.
+  std::condition_variable job_cv_;
+
+  /// Signaled when a worker thread stops executing tasks of a job.
+  std::condition_variable done_cv_;
+};
+
+}  // namespace Microsoft::MixedReality::WebRTC
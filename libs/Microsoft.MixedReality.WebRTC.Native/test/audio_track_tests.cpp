@@ -5,6 +5,7 @@
 
 #include "interop_api.h"
 #include "audio_frame.h"
+#include "audio_read_buffer_interop.h"
 
 #if !defined(MRSW_EXCLUDE_DEVICE_TESTS)
 
@@ -13,6 +14,10 @@ namespace {
 // PeerConnectionAudioFrameCallback
 using AudioFrameCallback = InteropCallback<const AudioFrame&>;
 
+// PeerConnectionRemoteAudioTrackFrameCallback
+using RemoteAudioTrackFrameCallback =
+    InteropCallback<const char*, const AudioFrame&>;
+
 bool IsSilent_uint8(const uint8_t* data,
                     uint32_t size,
                     uint8_t& min,
@@ -188,4 +193,232 @@ TEST(AudioTrack, Muted) {
                                                     nullptr);
 }
 
+TEST(AudioTrack, LocalFrameCallback) {
+  LocalPeerPairRaii pair;
+
+  std::atomic_uint32_t call_count{0};
+  std::atomic_uint32_t bad_call_count{0};
+  AudioFrameCallback audio_cb = [&](const AudioFrame& frame) {
+    if ((frame.data_ == nullptr) || (frame.bits_per_sample_ != 16) ||
+        (frame.sample_format_ != mrsAudioSampleFormat::kInt16) ||
+        (frame.channel_count_ == 0) ||
+        (frame.sample_count_ * 100 != frame.sampling_rate_hz_)) {
+      ++bad_call_count;
+      return;
+    }
+    ++call_count;
+  };
+  mrsPeerConnectionRegisterLocalAudioFrameCallback(pair.pc1(), CB(audio_cb));
+
+  // Frames are only delivered while the peer connection has a local track
+  Event ev;
+  std::this_thread::sleep_for(500ms);
+  ASSERT_EQ(0u, call_count.load());
+
+  ASSERT_EQ(Result::kSuccess,
+            mrsPeerConnectionAddLocalAudioTrack(pair.pc1()));
+  pair.ConnectAndWait();
+  ev.WaitFor(5s);
+
+  mrsPeerConnectionRemoveLocalAudioTrack(pair.pc1());
+  const uint32_t count = call_count.load();
+  ASSERT_LT(50u, count);  // at least 10 CPS
+  ASSERT_EQ(0u, bad_call_count.load());
+  std::this_thread::sleep_for(500ms);
+  ASSERT_EQ(count, call_count.load());
+
+  mrsPeerConnectionRegisterLocalAudioFrameCallback(pair.pc1(), nullptr,
+                                                   nullptr);
+}
+
+TEST(AudioTrack, PerTrackFrameCallback) {
+  LocalPeerPairRaii pair;
+
+  ASSERT_EQ(Result::kSuccess,
+            mrsPeerConnectionAddLocalAudioTrack(pair.pc1()));
+
+  // Register before the remote track is added, by track ID
+  std::atomic_uint32_t call_count{0};
+  std::atomic_uint32_t bad_call_count{0};
+  RemoteAudioTrackFrameCallback track_cb = [&](const char* track_id,
+                                               const AudioFrame& frame) {
+    if ((track_id == nullptr) || (strcmp(track_id, "local_audio") != 0) ||
+        (frame.data_ == nullptr) || (frame.sample_count_ == 0)) {
+      ++bad_call_count;
+      return;
+    }
+    ++call_count;
+  };
+  ASSERT_EQ(Result::kInvalidParameter,
+            mrsPeerConnectionRegisterRemoteAudioTrackFrameCallback(
+                pair.pc2(), nullptr, CB(track_cb)));
+  ASSERT_EQ(Result::kSuccess,
+            mrsPeerConnectionRegisterRemoteAudioTrackFrameCallback(
+                pair.pc2(), "local_audio", CB(track_cb)));
+
+  // The peer-wide callback still receives the same frames
+  std::atomic_uint32_t peer_call_count{0};
+  AudioFrameCallback audio_cb = [&](const AudioFrame&) { ++peer_call_count; };
+  mrsPeerConnectionRegisterRemoteAudioFrameCallback(pair.pc2(), CB(audio_cb));
+
+  pair.ConnectAndWait();
+
+  Event ev;
+  ev.WaitFor(5s);
+
+  // Unregister before checking, so that no callback is running anymore
+  ASSERT_EQ(Result::kSuccess,
+            mrsPeerConnectionRegisterRemoteAudioTrackFrameCallback(
+                pair.pc2(), "local_audio", nullptr, nullptr));
+  mrsPeerConnectionRegisterRemoteAudioFrameCallback(pair.pc2(), nullptr,
+                                                    nullptr);
+  ASSERT_LT(50u, call_count.load());  // at least 10 CPS
+  ASSERT_LT(50u, peer_call_count.load());
+  ASSERT_EQ(0u, bad_call_count.load());
+}
+
+TEST(AudioTrack, ReadBuffer) {
+  LocalPeerPairRaii pair;
+
+  ASSERT_EQ(Result::kSuccess,
+            mrsPeerConnectionAddLocalAudioTrack(pair.pc1()));
+
+  mrsAudioReadBufferConfig config{};
+  config.capacity_ms = 5;
+  AudioReadBufferHandle buffer = nullptr;
+  ASSERT_EQ(Result::kInvalidParameter,
+            mrsAudioReadBufferCreate(&config, &buffer));
+  ASSERT_EQ(nullptr, buffer);
+  config.capacity_ms = 100;
+  ASSERT_EQ(Result::kSuccess, mrsAudioReadBufferCreate(&config, &buffer));
+  ASSERT_NE(nullptr, buffer);
+
+  // Format is unknown until the first frame is received
+  uint32_t sampling_rate_hz = 0;
+  uint32_t channel_count = 0;
+  ASSERT_EQ(Result::kInvalidOperation,
+            mrsAudioReadBufferGetFormat(buffer, &sampling_rate_hz,
+                                        &channel_count));
+
+  ASSERT_EQ(Result::kSuccess, mrsPeerConnectionSetRemoteAudioTrackReadBuffer(
+                                  pair.pc2(), "local_audio", buffer));
+
+  pair.ConnectAndWait();
+
+  // Let the buffer overrun, since nothing reads it
+  Event ev;
+  ev.WaitFor(1s);
+  ASSERT_EQ(Result::kSuccess, mrsAudioReadBufferGetFormat(
+                                  buffer, &sampling_rate_hz, &channel_count));
+  ASSERT_LT(0u, sampling_rate_hz);
+  ASSERT_LT(0u, channel_count);
+  mrsAudioReadBufferStats stats{};
+  ASSERT_EQ(Result::kSuccess, mrsAudioReadBufferGetStats(buffer, &stats));
+  ASSERT_LT(0u, stats.overrun_count);
+  ASSERT_LT(0u, stats.dropped_sample_count);
+  ASSERT_EQ(sampling_rate_hz / 10, stats.available_sample_count);
+
+  // Drain the buffer, then read more than available; the rest is silence
+  const uint32_t sample_count = sampling_rate_hz;  // 1s
+  std::vector<int16_t> data(sample_count * channel_count, 42);
+  uint32_t read_count = 0;
+  ASSERT_EQ(Result::kSuccess, mrsAudioReadBufferRead(buffer, data.data(),
+                                                     sample_count,
+                                                     &read_count));
+  ASSERT_LE(sampling_rate_hz / 10, read_count);
+  ASSERT_GT(sample_count, read_count);
+  for (uint32_t i = read_count * channel_count; i < data.size(); ++i) {
+    ASSERT_EQ(0, data[i]);
+  }
+  ASSERT_EQ(Result::kSuccess, mrsAudioReadBufferGetStats(buffer, &stats));
+  ASSERT_EQ(1u, stats.underrun_count);
+  ASSERT_EQ(sample_count - read_count, stats.missing_sample_count);
+  ASSERT_EQ(0u, stats.format_mismatch_count);
+
+  ASSERT_EQ(Result::kSuccess, mrsPeerConnectionSetRemoteAudioTrackReadBuffer(
+                                  pair.pc2(), "local_audio", nullptr));
+  mrsAudioReadBufferRemoveRef(buffer);
+}
+
+TEST(AudioTrack, ReadBufferBeforeFormat) {
+  mrsAudioReadBufferConfig config{};
+  config.channel_count = 2;
+  AudioReadBufferHandle buffer = nullptr;
+  ASSERT_EQ(Result::kSuccess, mrsAudioReadBufferCreate(&config, &buffer));
+
+  // Nothing is read before the first frame, but with a known channel count
+  // the request is filled with silence like any other underrun.
+  constexpr uint32_t kSampleCount = 480;
+  std::vector<int16_t> data(kSampleCount * 2, 42);
+  uint32_t read_count = 42;
+  ASSERT_EQ(Result::kSuccess, mrsAudioReadBufferRead(buffer, data.data(),
+                                                     kSampleCount,
+                                                     &read_count));
+  ASSERT_EQ(0u, read_count);
+  for (int16_t value : data) {
+    ASSERT_EQ(0, value);
+  }
+  mrsAudioReadBufferStats stats{};
+  ASSERT_EQ(Result::kSuccess, mrsAudioReadBufferGetStats(buffer, &stats));
+  ASSERT_EQ(1u, stats.underrun_count);
+  ASSERT_EQ(kSampleCount, stats.missing_sample_count);
+
+  mrsAudioReadBufferRemoveRef(buffer);
+}
+
+TEST(AudioTrack, OutputFormat) {
+  LocalPeerPairRaii pair;
+
+  ASSERT_EQ(Result::kSuccess,
+            mrsPeerConnectionAddLocalAudioTrack(pair.pc1()));
+
+  mrsAudioOutputFormat format{};
+  format.sampling_rate_hz = 16050;
+  ASSERT_EQ(Result::kInvalidParameter,
+            mrsPeerConnectionSetRemoteAudioTrackOutputFormat(
+                pair.pc2(), "local_audio", &format));
+  format.sample_format = mrsAudioSampleFormat::kFloat32;
+  format.sample_layout = mrsAudioSampleLayout::kPlanar;
+  format.sampling_rate_hz = 16000;
+  format.channel_count = 2;
+  ASSERT_EQ(Result::kSuccess, mrsPeerConnectionSetRemoteAudioTrackOutputFormat(
+                                  pair.pc2(), "local_audio", &format));
+
+  std::atomic_uint32_t call_count{0};
+  std::atomic_uint32_t bad_call_count{0};
+  RemoteAudioTrackFrameCallback track_cb = [&](const char* /*track_id*/,
+                                               const AudioFrame& frame) {
+    if ((frame.data_ == nullptr) || (frame.bits_per_sample_ != 32) ||
+        (frame.sampling_rate_hz_ != 16000) || (frame.channel_count_ != 2) ||
+        (frame.sample_count_ != 160) ||
+        (frame.sample_format_ != mrsAudioSampleFormat::kFloat32) ||
+        (frame.sample_layout_ != mrsAudioSampleLayout::kPlanar)) {
+      ++bad_call_count;
+      return;
+    }
+    const float* const samples = static_cast<const float*>(frame.data_);
+    for (uint32_t i = 0; i < frame.sample_count_ * 2; ++i) {
+      if ((samples[i] < -1.0f) || (samples[i] > 1.0f)) {
+        ++bad_call_count;
+        return;
+      }
+    }
+    ++call_count;
+  };
+  ASSERT_EQ(Result::kSuccess,
+            mrsPeerConnectionRegisterRemoteAudioTrackFrameCallback(
+                pair.pc2(), "local_audio", CB(track_cb)));
+
+  pair.ConnectAndWait();
+
+  Event ev;
+  ev.WaitFor(5s);
+
+  ASSERT_EQ(Result::kSuccess,
+            mrsPeerConnectionRegisterRemoteAudioTrackFrameCallback(
+                pair.pc2(), "local_audio", nullptr, nullptr));
+  ASSERT_LT(50u, call_count.load());  // at least 10 CPS
+  ASSERT_EQ(0u, bad_call_count.load());
+}
+
 #endif  // MRSW_EXCLUDE_DEVICE_TESTS
@@ -22,6 +22,90 @@ FakeIterop_DataChannelCreate(mrsPeerConnectionInteropHandle /*parent*/,
 using DataAddedCallback =
     InteropCallback<mrsDataChannelInteropHandle, DataChannelHandle>;
 
+/// Out-of-band data channel between the two peers of a |LocalPeerPairRaii|,
+/// with the first peer sending messages carrying their index in their first
+/// byte, and the second peer checking the messages are received in order,
+/// unless a custom message handler is set.
+struct LoopbackDataChannel {
+  DataChannelHandle sender_{};
+  DataChannelHandle receiver_{};
+  Event open_ev_;
+  uint32_t expected_count_{0};
+  std::atomic_uint32_t count_{0};
+  std::atomic_uint32_t bad_count_{0};
+  Event received_ev_;
+  std::function<void(const uint8_t*, uint64_t)> message_handler_;
+
+  /// Add the channel to each peer, connect the pair, and wait for the channel
+  /// of the sender to open.
+  void Connect(LocalPeerPairRaii& pair) {
+    mrsDataChannelConfig data_config{};
+    data_config.id = 25;  // must be >= 0 for negotiated (out-of-band) channel
+    data_config.label = "loopback";
+    data_config.flags = mrsDataChannelConfigFlags::kOrdered |
+                        mrsDataChannelConfigFlags::kReliable;
+    mrsDataChannelCallbacks callbacks1{};
+    callbacks1.state_callback = &OnStateChanged;
+    callbacks1.state_user_data = this;
+    ASSERT_EQ(Result::kSuccess, mrsPeerConnectionAddDataChannel(
+                                    pair.pc1(), kFakeInteropDataChannelHandle,
+                                    data_config, callbacks1, &sender_));
+    mrsDataChannelCallbacks callbacks2{};
+    callbacks2.message_callback = &OnMessage;
+    callbacks2.message_user_data = this;
+    ASSERT_EQ(Result::kSuccess, mrsPeerConnectionAddDataChannel(
+                                    pair.pc2(), kFakeInteropDataChannelHandle,
+                                    data_config, callbacks2, &receiver_));
+    pair.ConnectAndWait();
+    ASSERT_TRUE(open_ev_.WaitFor(30s));
+  }
+
+  static void MRS_CALL OnStateChanged(void* user_data,
+                                      int32_t state,
+                                      int32_t /*id*/) {
+    if (state == 1) {  // kOpen
+      static_cast<LoopbackDataChannel*>(user_data)->open_ev_.Set();
+    }
+  }
+
+  static void MRS_CALL OnMessage(void* user_data,
+                                 const void* data,
+                                 const uint64_t size) {
+    auto channel = static_cast<LoopbackDataChannel*>(user_data);
+    if (channel->message_handler_) {
+      channel->message_handler_(static_cast<const uint8_t*>(data), size);
+      return;
+    }
+    const uint32_t index = channel->count_++;
+    if ((size == 0) ||
+        (*static_cast<const uint8_t*>(data) != (uint8_t)index)) {
+      ++channel->bad_count_;
+    }
+    if (index + 1 == channel->expected_count_) {
+      channel->received_ev_.Set();
+    }
+  }
+};
+
+/// Fill |message| with a pattern depending on its size.
+void FillPattern(std::vector<uint8_t>& message) {
+  const uint8_t seed = (uint8_t)message.size();
+  for (size_t i = 0; i < message.size(); ++i) {
+    message[i] = (uint8_t)(seed + i * 7);
+  }
+}
+
+/// Check that a message was filled with |FillPattern()|.
+bool CheckPattern(const uint8_t* data, uint64_t size) {
+  const uint8_t seed = (uint8_t)size;
+  for (uint64_t i = 0; i < size; ++i) {
+    if (data[i] != (uint8_t)(seed + i * 7)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 }  // namespace
 
 TEST(DataChannel, AddChannelBeforeInit) {
@@ -268,3 +352,526 @@ TEST(DataChannel, MultiThreadCreate) {
 //
 //  ASSERT_GT(peak, 0);
 //}
+
+TEST(DataChannel, SendBufferAcquireRelease) {
+  DataSendBufferHandle handle = nullptr;
+  void* data = nullptr;
+  ASSERT_EQ(Result::kSuccess, mrsDataSendBufferAcquire(1000, &handle, &data));
+  ASSERT_NE(nullptr, handle);
+  ASSERT_NE(nullptr, data);
+  memset(data, 0xAB, 1000);
+  mrsDataSendBufferRelease(handle);
+
+  // Buffers of small messages are recycled, whatever their size
+  DataSendBufferHandle handle2 = nullptr;
+  ASSERT_EQ(Result::kSuccess,
+            mrsDataSendBufferAcquire(16 * 1024, &handle2, &data));
+  ASSERT_EQ(handle, handle2);
+  memset(data, 0xCD, 16 * 1024);
+  mrsDataSendBufferRelease(handle2);
+
+  // Buffers of large messages are allocated on demand
+  ASSERT_EQ(Result::kSuccess,
+            mrsDataSendBufferAcquire(16 * 1024 + 1, &handle, &data));
+  ASSERT_NE(nullptr, handle);
+  memset(data, 0xEF, 16 * 1024 + 1);
+  mrsDataSendBufferRelease(handle);
+
+  // Releasing no buffer is a no-op
+  mrsDataSendBufferRelease(nullptr);
+}
+
+TEST(DataChannel, SendBufferInvalid) {
+  DataSendBufferHandle handle = nullptr;
+  void* data = nullptr;
+  ASSERT_EQ(Result::kInvalidParameter,
+            mrsDataSendBufferAcquire(16, nullptr, &data));
+  ASSERT_EQ(Result::kSuccess, mrsDataSendBufferAcquire(16, &handle, &data));
+  ASSERT_NE(nullptr, handle);
+  ASSERT_NE(nullptr, data);
+
+  // The buffer is released even if the data channel is invalid
+  ASSERT_EQ(Result::kInvalidNativeHandle,
+            mrsDataChannelSendBuffer(nullptr, handle));
+  ASSERT_EQ(Result::kInvalidNativeHandle,
+            mrsDataChannelSendBuffer(nullptr, nullptr));
+}
+
+TEST(DataChannel, SendBuffer) {
+  // Declared first, as the peer connections invoke its callbacks until closed
+  LoopbackDataChannel channel;
+  constexpr uint32_t kCount = 300;
+  auto message_size = [](uint32_t index) -> uint64_t {
+    // Mix of pooled and unpooled buffers
+    return 100 + (index % 7) * 10000;
+  };
+  std::atomic_uint32_t count{0};
+  std::atomic_uint32_t bad_count{0};
+  Event received_ev;
+  channel.message_handler_ = [&](const uint8_t* data, uint64_t size) {
+    const uint32_t index = count++;
+    if (size != message_size(index)) {
+      ++bad_count;
+    } else {
+      for (uint64_t i = 0; i < size; ++i) {
+        if (data[i] != (uint8_t)index) {
+          ++bad_count;
+          break;
+        }
+      }
+    }
+    if (index + 1 == kCount) {
+      received_ev.Set();
+    }
+  };
+  LocalPeerPairRaii pair;
+  channel.Connect(pair);
+
+  // Buffers are recycled while the messages sent from them might still be
+  // buffered by the data channel, which must not alter those messages.
+  for (uint32_t i = 0; i < kCount; ++i) {
+    const uint64_t size = message_size(i);
+    DataSendBufferHandle handle = nullptr;
+    void* data = nullptr;
+    ASSERT_EQ(Result::kSuccess, mrsDataSendBufferAcquire(size, &handle, &data));
+    memset(data, (uint8_t)i, (size_t)size);
+    ASSERT_EQ(Result::kSuccess,
+              mrsDataChannelSendBuffer(channel.sender_, handle));
+  }
+  ASSERT_TRUE(received_ev.WaitFor(30s));
+  ASSERT_EQ(kCount, count.load());
+  ASSERT_EQ(0u, bad_count.load());
+}
+
+TEST(DataChannel, SendBatch) {
+  // Declared first, as the peer connections invoke its callbacks until closed
+  LoopbackDataChannel channel;
+  LocalPeerPairRaii pair;
+  channel.Connect(pair);
+
+  constexpr uint32_t kCount = 500;
+  std::vector<std::vector<uint8_t>> storage(kCount);
+  std::vector<const void*> messages(kCount);
+  std::vector<uint64_t> sizes(kCount);
+  for (uint32_t i = 0; i < kCount; ++i) {
+    storage[i].resize(50 + (i % 150), (uint8_t)i);
+    messages[i] = storage[i].data();
+    sizes[i] = storage[i].size();
+  }
+  channel.expected_count_ = kCount;
+  uint32_t sent_count = 0;
+  ASSERT_EQ(Result::kSuccess,
+            mrsDataChannelSendMessageBatch(channel.sender_, messages.data(),
+                                           sizes.data(), kCount, &sent_count));
+  ASSERT_EQ(kCount, sent_count);
+  ASSERT_TRUE(channel.received_ev_.WaitFor(30s));
+  ASSERT_EQ(kCount, channel.count_.load());
+  ASSERT_EQ(0u, channel.bad_count_.load());
+
+  // Invalid batches are rejected as a whole
+  messages[1] = nullptr;
+  ASSERT_EQ(Result::kInvalidParameter,
+            mrsDataChannelSendMessageBatch(channel.sender_, messages.data(),
+                                           sizes.data(), kCount, &sent_count));
+  ASSERT_EQ(0u, sent_count);
+  ASSERT_EQ(Result::kInvalidNativeHandle,
+            mrsDataChannelSendMessageBatch(nullptr, messages.data(),
+                                           sizes.data(), kCount, &sent_count));
+}
+
+TEST(DataChannel, SendQueue) {
+  // Declared first, as the peer connections invoke their callbacks until closed
+  LoopbackDataChannel channel;
+  std::atomic_uint32_t backpressure_count{0};
+  Event released_ev;
+  InteropCallback<mrsBool> backpressure_cb = [&](mrsBool backpressure) {
+    if (backpressure == mrsBool::kTrue) {
+      ++backpressure_count;
+    } else {
+      released_ev.Set();
+    }
+  };
+  LocalPeerPairRaii pair;
+  channel.Connect(pair);
+
+  mrsDataChannelSendQueueConfig config{};
+  config.low_watermark_bytes = config.high_watermark_bytes;
+  ASSERT_EQ(Result::kInvalidParameter,
+            mrsDataChannelEnableSendQueue(channel.sender_, &config,
+                                          CB(backpressure_cb)));
+  config = {};
+  config.capacity_bytes = 32 * 1024 * 1024;
+  config.high_watermark_bytes = 4 * 1024 * 1024;
+  config.low_watermark_bytes = 1024 * 1024;
+  ASSERT_EQ(Result::kSuccess,
+            mrsDataChannelEnableSendQueue(channel.sender_, &config,
+                                          CB(backpressure_cb)));
+
+  // Send more than the 16 MB WebRTC buffer without waiting. The messages which
+  // do not fit are queued instead of being rejected.
+  constexpr uint32_t kCount = 1600;
+  constexpr uint32_t kSize = 16 * 1024;
+  std::vector<uint8_t> message(kSize);
+  channel.expected_count_ = kCount;
+  for (uint32_t i = 0; i < kCount; ++i) {
+    message[0] = (uint8_t)i;
+    ASSERT_EQ(Result::kSuccess, mrsDataChannelSendMessage(
+                                    channel.sender_, message.data(), kSize));
+  }
+  ASSERT_LE(1u, backpressure_count.load());
+  ASSERT_TRUE(channel.received_ev_.WaitFor(60s));
+  ASSERT_EQ(kCount, channel.count_.load());
+  ASSERT_EQ(0u, channel.bad_count_.load());
+
+  // Backpressure is released once drained
+  ASSERT_TRUE(released_ev.WaitFor(10s));
+  mrsDataChannelSendQueueStats stats{};
+  ASSERT_EQ(Result::kSuccess,
+            mrsDataChannelGetSendQueueStats(channel.sender_, &stats));
+  ASSERT_EQ(0u, stats.queued_message_count);
+  ASSERT_EQ(0u, stats.queued_bytes);
+  ASSERT_EQ(0u, stats.rejected_message_count);
+  ASSERT_EQ(mrsBool::kFalse, stats.backpressure);
+}
+
+TEST(DataChannel, Framing) {
+  // Declared first, as the peer connections invoke their callbacks until closed
+  LoopbackDataChannel channel;
+  std::mutex mutex;
+  std::vector<uint64_t> received_sizes;
+  std::atomic_uint32_t bad_count{0};
+  Event received_ev;
+  channel.message_handler_ = [&](const uint8_t* data, uint64_t size) {
+    if (!CheckPattern(data, size)) {
+      ++bad_count;
+    }
+    auto lock = std::scoped_lock{mutex};
+    received_sizes.push_back(size);
+    if (received_sizes.size() == 3) {
+      received_ev.Set();
+    }
+  };
+  LocalPeerPairRaii pair;
+  channel.Connect(pair);
+
+  mrsDataChannelFramingConfig config{};
+  config.chunk_size = 16;
+  ASSERT_EQ(Result::kInvalidParameter,
+            mrsDataChannelEnableFraming(channel.sender_, &config));
+  config = {};
+  ASSERT_EQ(Result::kSuccess,
+            mrsDataChannelEnableFraming(channel.sender_, &config));
+  ASSERT_EQ(Result::kSuccess,
+            mrsDataChannelEnableFraming(channel.receiver_, &config));
+
+  // A message larger than the 16 MB WebRTC buffer, then small messages which
+  // are interleaved with it and overtake it.
+  std::vector<uint8_t> large(20 * 1024 * 1024);
+  FillPattern(large);
+  std::vector<uint8_t> small(100);
+  FillPattern(small);
+  std::vector<uint8_t> empty;
+  ASSERT_EQ(Result::kSuccess, mrsDataChannelSendMessage(
+                                  channel.sender_, large.data(), large.size()));
+  ASSERT_EQ(Result::kSuccess, mrsDataChannelSendMessage(
+                                  channel.sender_, small.data(), small.size()));
+  ASSERT_EQ(Result::kSuccess,
+            mrsDataChannelSendMessage(channel.sender_, empty.data(), 0));
+  ASSERT_TRUE(received_ev.WaitFor(60s));
+  ASSERT_EQ(0u, bad_count.load());
+  auto lock = std::scoped_lock{mutex};
+  ASSERT_EQ(3u, received_sizes.size());
+  ASSERT_EQ(small.size(), received_sizes[0]);
+  ASSERT_EQ(0u, received_sizes[1]);
+  ASSERT_EQ(large.size(), received_sizes[2]);
+}
+
+TEST(DataChannel, FramingLimits) {
+  // Declared first, as the peer connections invoke their callbacks until closed
+  LoopbackDataChannel channel;
+  std::mutex mutex;
+  std::vector<uint64_t> received_sizes;
+  std::atomic_uint32_t bad_count{0};
+  std::atomic_uint32_t expected_count{1};
+  Event received_ev;
+  channel.message_handler_ = [&](const uint8_t* data, uint64_t size) {
+    if (!CheckPattern(data, size)) {
+      ++bad_count;
+    }
+    auto lock = std::scoped_lock{mutex};
+    received_sizes.push_back(size);
+    if (received_sizes.size() == expected_count) {
+      received_ev.Set();
+    }
+  };
+  LocalPeerPairRaii pair;
+  channel.Connect(pair);
+
+  mrsDataChannelFramingConfig config{};
+  ASSERT_EQ(Result::kSuccess,
+            mrsDataChannelEnableFraming(channel.sender_, &config));
+  config.max_message_size = 1000;
+  config.max_reassembly_size = 999;
+  ASSERT_EQ(Result::kInvalidParameter,
+            mrsDataChannelEnableFraming(channel.receiver_, &config));
+  config.max_reassembly_size = 1500;
+  ASSERT_EQ(Result::kSuccess,
+            mrsDataChannelEnableFraming(channel.receiver_, &config));
+
+  // A message sent in a single chunk but larger than the maximum message size
+  // is dropped, and the next one is delivered.
+  std::vector<uint8_t> large(2000);
+  FillPattern(large);
+  std::vector<uint8_t> small(10);
+  FillPattern(small);
+  ASSERT_EQ(Result::kSuccess, mrsDataChannelSendMessage(
+                                  channel.sender_, large.data(), large.size()));
+  ASSERT_EQ(Result::kSuccess, mrsDataChannelSendMessage(
+                                  channel.sender_, small.data(), small.size()));
+  ASSERT_TRUE(received_ev.WaitFor(10s));
+  received_ev.Reset();
+  expected_count = 3;
+  {
+    auto lock = std::scoped_lock{mutex};
+    ASSERT_EQ(1u, received_sizes.size());
+    ASSERT_EQ(small.size(), received_sizes[0]);
+  }
+
+  // Two messages larger than the WebRTC buffer are interleaved, and the second
+  // one would exceed the maximum reassembly size, so is dropped. A small
+  // message sent after them overtakes them.
+  config.max_message_size = 8 * 1024 * 1024;
+  config.max_reassembly_size = 12 * 1024 * 1024;
+  ASSERT_EQ(Result::kSuccess,
+            mrsDataChannelEnableFraming(channel.receiver_, &config));
+  std::vector<uint8_t> medium(8 * 1024 * 1024);
+  FillPattern(medium);
+  ASSERT_EQ(Result::kSuccess,
+            mrsDataChannelSendMessage(channel.sender_, medium.data(),
+                                      medium.size()));
+  ASSERT_EQ(Result::kSuccess,
+            mrsDataChannelSendMessage(channel.sender_, medium.data(),
+                                      medium.size()));
+  ASSERT_EQ(Result::kSuccess, mrsDataChannelSendMessage(
+                                  channel.sender_, small.data(), small.size()));
+  ASSERT_TRUE(received_ev.WaitFor(30s));
+  std::this_thread::sleep_for(1s);
+  ASSERT_EQ(0u, bad_count.load());
+  auto lock = std::scoped_lock{mutex};
+  ASSERT_EQ(3u, received_sizes.size());
+  ASSERT_EQ(small.size(), received_sizes[1]);
+  ASSERT_EQ(medium.size(), received_sizes[2]);
+}
+
+// Benchmark of the framing mode. Run explicitly with
+// --gtest_also_run_disabled_tests; the throughput for each message size is
+// reported as test properties, in kilobytes per second.
+TEST(DataChannel, DISABLED_FramingBenchmark) {
+  // Declared first, as the peer connections invoke their callbacks until closed
+  LoopbackDataChannel channel;
+  std::atomic_uint64_t received_bytes{0};
+  std::atomic_uint64_t expected_bytes{0};
+  Event received_ev;
+  channel.message_handler_ = [&](const uint8_t* /*data*/, uint64_t size) {
+    if ((received_bytes += size) == expected_bytes) {
+      received_ev.Set();
+    }
+  };
+  LocalPeerPairRaii pair;
+  channel.Connect(pair);
+  mrsDataChannelFramingConfig config{};
+  ASSERT_EQ(Result::kSuccess,
+            mrsDataChannelEnableFraming(channel.sender_, &config));
+  ASSERT_EQ(Result::kSuccess,
+            mrsDataChannelEnableFraming(channel.receiver_, &config));
+
+  // Send the same amount of data for each message size, and measure the time
+  // until all of it is received.
+  constexpr uint64_t kTotalBytes = 16 * 1024 * 1024;
+  for (uint64_t size : {256ull, 4096ull, 65536ull, 1048576ull, 8388608ull}) {
+    std::vector<uint8_t> message((size_t)size);
+    const uint64_t count = kTotalBytes / size;
+    received_bytes = 0;
+    expected_bytes = count * size;
+    received_ev.Reset();
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < count; ++i) {
+      ASSERT_EQ(Result::kSuccess, mrsDataChannelSendMessage(
+                                      channel.sender_, message.data(), size));
+    }
+    ASSERT_TRUE(received_ev.WaitFor(120s));
+    const auto end = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    RecordProperty("framed_" + std::to_string(size) + "_bytes_kbps",
+                   (int)(kTotalBytes / 1024.0 / seconds));
+  }
+}
+
+TEST(DataChannel, ReceiveDedicatedThread) {
+  // Declared first, as the peer connections invoke their callbacks until closed
+  LoopbackDataChannel channel;
+  constexpr uint32_t kCount = 1000;
+  constexpr uint32_t kMaxBatchSize = 16;
+  const std::thread::id test_thread_id = std::this_thread::get_id();
+  std::atomic_uint32_t count{0};
+  std::atomic_uint32_t bad_count{0};
+  Event received_ev;
+  InteropCallback<const void* const*, const uint64_t*, uint32_t> batch_cb =
+      [&](const void* const* data, const uint64_t* sizes, uint32_t batch_size) {
+        if ((batch_size == 0) || (batch_size > kMaxBatchSize) ||
+            (std::this_thread::get_id() == test_thread_id)) {
+          ++bad_count;
+        }
+        for (uint32_t i = 0; i < batch_size; ++i) {
+          const uint32_t index = count++;
+          if ((sizes[i] == 0) ||
+              (*static_cast<const uint8_t*>(data[i]) != (uint8_t)index)) {
+            ++bad_count;
+          }
+        }
+        if (count == kCount) {
+          received_ev.Set();
+        }
+      };
+  LocalPeerPairRaii pair;
+  channel.Connect(pair);
+
+  mrsDataChannelReceiveConfig config{};
+  config.mode = mrsDataChannelReceiveMode::kDirect;
+  ASSERT_EQ(Result::kInvalidParameter,
+            mrsDataChannelSetReceiveConfig(channel.receiver_, &config,
+                                           CB(batch_cb)));
+  config.mode = mrsDataChannelReceiveMode::kDedicatedThread;
+  config.max_batch_size = kMaxBatchSize;
+  ASSERT_EQ(Result::kSuccess,
+            mrsDataChannelSetReceiveConfig(channel.receiver_, &config,
+                                           CB(batch_cb)));
+  // The receive mode can only be changed once
+  ASSERT_EQ(Result::kInvalidOperation,
+            mrsDataChannelSetReceiveConfig(channel.receiver_, &config,
+                                           CB(batch_cb)));
+
+  for (uint32_t i = 0; i < kCount; ++i) {
+    std::vector<uint8_t> message(50 + (i % 150), (uint8_t)i);
+    ASSERT_EQ(Result::kSuccess,
+              mrsDataChannelSendMessage(channel.sender_, message.data(),
+                                        message.size()));
+  }
+  ASSERT_TRUE(received_ev.WaitFor(30s));
+  ASSERT_EQ(kCount, count.load());
+  ASSERT_EQ(0u, bad_count.load());
+
+  mrsDataChannelReceiveStats stats{};
+  ASSERT_EQ(Result::kSuccess,
+            mrsDataChannelGetReceiveStats(channel.receiver_, &stats));
+  ASSERT_EQ(kCount, stats.delivered_message_count);
+  ASSERT_EQ(0u, stats.dropped_message_count);
+  ASSERT_EQ(0u, stats.queue_depth);
+  ASSERT_GE(stats.max_queue_depth, 1u);
+  ASSERT_LE(stats.latency_p50_us, stats.latency_p90_us);
+  ASSERT_LE(stats.latency_p90_us, stats.latency_p99_us);
+}
+
+TEST(DataChannel, ReceiveManual) {
+  // Declared first, as the peer connections invoke their callbacks until closed
+  LoopbackDataChannel channel;
+  LocalPeerPairRaii pair;
+  channel.Connect(pair);
+
+  mrsDataChannelReceiveConfig config{};
+  config.mode = mrsDataChannelReceiveMode::kManual;
+  config.queue_capacity = 256;
+  ASSERT_EQ(Result::kSuccess,
+            mrsDataChannelSetReceiveConfig(channel.receiver_, &config,
+                                           nullptr, nullptr));
+
+  // Messages are only delivered when dispatched, through the message callback
+  constexpr uint32_t kCount = 200;
+  channel.expected_count_ = kCount;
+  for (uint32_t i = 0; i < kCount; ++i) {
+    std::vector<uint8_t> message(64, (uint8_t)i);
+    ASSERT_EQ(Result::kSuccess,
+              mrsDataChannelSendMessage(channel.sender_, message.data(),
+                                        message.size()));
+  }
+  ASSERT_FALSE(channel.received_ev_.WaitFor(1s));
+  ASSERT_EQ(0u, channel.count_.load());
+
+  uint32_t dispatched = 0;
+  const auto deadline = std::chrono::steady_clock::now() + 30s;
+  while ((dispatched < kCount) &&
+         (std::chrono::steady_clock::now() < deadline)) {
+    uint32_t dispatched_count = 0;
+    ASSERT_EQ(Result::kSuccess,
+              mrsDataChannelDispatchMessages(channel.receiver_, 50,
+                                             &dispatched_count));
+    ASSERT_LE(dispatched_count, 50u);
+    dispatched += dispatched_count;
+    if (dispatched_count == 0) {
+      std::this_thread::sleep_for(10ms);
+    }
+  }
+  ASSERT_EQ(kCount, dispatched);
+  ASSERT_TRUE(channel.received_ev_.WaitFor(0s));
+  ASSERT_EQ(kCount, channel.count_.load());
+  ASSERT_EQ(0u, channel.bad_count_.load());
+
+  mrsDataChannelReceiveStats stats{};
+  ASSERT_EQ(Result::kSuccess,
+            mrsDataChannelGetReceiveStats(channel.receiver_, &stats));
+  ASSERT_EQ(kCount, stats.delivered_message_count);
+  ASSERT_EQ(0u, stats.dropped_message_count);
+  ASSERT_LE(stats.max_queue_depth, 256u);
+}
+
+TEST(DataChannel, ReceiveQueueFull) {
+  // Declared first, as the peer connections invoke their callbacks until closed
+  LoopbackDataChannel channel;
+  LocalPeerPairRaii pair;
+  channel.Connect(pair);
+
+  // Capacity is rounded up to a power of two
+  mrsDataChannelReceiveConfig config{};
+  config.mode = mrsDataChannelReceiveMode::kManual;
+  config.queue_capacity = 3;
+  ASSERT_EQ(Result::kSuccess,
+            mrsDataChannelSetReceiveConfig(channel.receiver_, &config,
+                                           nullptr, nullptr));
+
+  // Messages received while the queue is full are dropped, without blocking
+  // the reception of the next ones.
+  constexpr uint32_t kCount = 10;
+  constexpr uint32_t kCapacity = 4;
+  for (uint32_t i = 0; i < kCount; ++i) {
+    const uint8_t message = (uint8_t)i;
+    ASSERT_EQ(Result::kSuccess,
+              mrsDataChannelSendMessage(channel.sender_, &message, 1));
+  }
+  mrsDataChannelReceiveStats stats{};
+  const auto deadline = std::chrono::steady_clock::now() + 30s;
+  do {
+    std::this_thread::sleep_for(10ms);
+    ASSERT_EQ(Result::kSuccess,
+              mrsDataChannelGetReceiveStats(channel.receiver_, &stats));
+  } while ((stats.queue_depth + stats.dropped_message_count < kCount) &&
+           (std::chrono::steady_clock::now() < deadline));
+  ASSERT_EQ(kCapacity, stats.queue_depth);
+  ASSERT_EQ(kCapacity, stats.max_queue_depth);
+  ASSERT_EQ(kCount - kCapacity, stats.dropped_message_count);
+  ASSERT_EQ(0u, stats.delivered_message_count);
+
+  // The oldest messages were kept, in order
+  channel.expected_count_ = kCapacity;
+  uint32_t dispatched_count = 0;
+  ASSERT_EQ(Result::kSuccess,
+            mrsDataChannelDispatchMessages(channel.receiver_, kCount,
+                                           &dispatched_count));
+  ASSERT_EQ(kCapacity, dispatched_count);
+  ASSERT_TRUE(channel.received_ev_.WaitFor(0s));
+  ASSERT_EQ(kCapacity, channel.count_.load());
+  ASSERT_EQ(0u, channel.bad_count_.load());
+  ASSERT_EQ(Result::kSuccess,
+            mrsDataChannelGetReceiveStats(channel.receiver_, &stats));
+  ASSERT_EQ(0u, stats.queue_depth);
+  ASSERT_EQ(kCapacity, stats.delivered_message_count);
+}
@@ -0,0 +1,232 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include "audio_frame.h"
+#include "external_audio_track_source_interop.h"
+#include "interop_api.h"
+
+// Those tests do not use any audio device, and run on machines without any
+// audio hardware.
+
+namespace {
+
+// PeerConnectionAudioFrameCallback
+using AudioFrameCallback = InteropCallback<const AudioFrame&>;
+
+constexpr int16_t kSampleValue = 1234;
+
+/// Producer of constant audio for a source created from a callback.
+struct ConstantAudioProducer {
+  std::atomic_uint32_t request_count_{0};
+  std::atomic_uint32_t bad_request_count_{0};
+  Event ev_;
+
+  static uint32_t MRS_CALL OnRequest(void* user_data,
+                                     ExternalAudioTrackSourceHandle handle,
+                                     int64_t /*timestamp_ms*/,
+                                     int16_t* data,
+                                     uint32_t sample_count) {
+    auto producer = static_cast<ConstantAudioProducer*>(user_data);
+    if (!handle || !data || (sample_count != 480)) {
+      ++producer->bad_request_count_;
+      return 0;
+    }
+    std::fill_n(data, sample_count, kSampleValue);
+    if (++producer->request_count_ == 50) {
+      producer->ev_.Set();
+    }
+    return sample_count;
+  }
+};
+
+/// Make a view over |sample_count| samples of 48 kHz mono audio.
+mrsAudioFrame MakeFrame(const int16_t* data, uint32_t sample_count) {
+  mrsAudioFrame frame{};
+  frame.data_ = data;
+  frame.bits_per_sample_ = 16;
+  frame.sampling_rate_hz_ = 48000;
+  frame.channel_count_ = 1;
+  frame.sample_count_ = sample_count;
+  return frame;
+}
+
+}  // namespace
+
+TEST(ExternalAudioTrackSource, InvalidConfig) {
+  ExternalAudioTrackSourceHandle handle = nullptr;
+  mrsExternalAudioTrackSourceConfig config{};
+  config.sampling_rate_hz = 44101;
+  ASSERT_EQ(Result::kInvalidParameter,
+            mrsExternalAudioTrackSourceCreatePushMode(&config, &handle));
+  ASSERT_EQ(nullptr, handle);
+  config = {};
+  config.channel_count = 0;
+  ASSERT_EQ(Result::kInvalidParameter,
+            mrsExternalAudioTrackSourceCreatePushMode(&config, &handle));
+  config = {};
+  config.jitter_buffer_ms = config.capacity_ms;
+  ASSERT_EQ(Result::kInvalidParameter,
+            mrsExternalAudioTrackSourceCreatePushMode(&config, &handle));
+  config = {};
+  ASSERT_EQ(Result::kInvalidParameter,
+            mrsExternalAudioTrackSourceCreateFromCallback(&config, nullptr,
+                                                          nullptr, &handle));
+  ASSERT_EQ(nullptr, handle);
+}
+
+TEST(ExternalAudioTrackSource, PullMode) {
+  ConstantAudioProducer producer;
+  mrsExternalAudioTrackSourceConfig config{};
+  ExternalAudioTrackSourceHandle handle = nullptr;
+  ASSERT_EQ(Result::kSuccess,
+            mrsExternalAudioTrackSourceCreateFromCallback(
+                &config, &ConstantAudioProducer::OnRequest, &producer,
+                &handle));
+  ASSERT_NE(nullptr, handle);
+
+  // Audio is requested every 10 ms
+  ASSERT_TRUE(producer.ev_.WaitFor(5s));
+  mrsExternalAudioTrackSourceShutdown(handle);
+  const uint32_t count = producer.request_count_.load();
+  ASSERT_LE(50u, count);
+  ASSERT_EQ(0u, producer.bad_request_count_.load());
+
+  mrsExternalAudioTrackSourceStats stats{};
+  ASSERT_EQ(Result::kSuccess,
+            mrsExternalAudioTrackSourceGetStats(handle, &stats));
+  ASSERT_EQ(count, stats.frame_count);
+  ASSERT_EQ(0u, stats.silence_frame_count);
+
+  // Push-mode calls are rejected
+  int16_t samples[480]{};
+  const mrsAudioFrame frame = MakeFrame(samples, 480);
+  ASSERT_EQ(Result::kInvalidOperation,
+            mrsExternalAudioTrackSourceSubmitFrame(handle, &frame, -1));
+
+  // No request after shutdown
+  Event ev;
+  ev.WaitFor(1s);
+  ASSERT_EQ(count, producer.request_count_.load());
+  mrsExternalAudioTrackSourceRemoveRef(handle);
+}
+
+TEST(ExternalAudioTrackSource, PushModeTimestamps) {
+  mrsExternalAudioTrackSourceConfig config{};
+  config.jitter_buffer_ms = 100;
+  config.capacity_ms = 1000;
+  ExternalAudioTrackSourceHandle handle = nullptr;
+  ASSERT_EQ(Result::kSuccess,
+            mrsExternalAudioTrackSourceCreatePushMode(&config, &handle));
+  ASSERT_NE(nullptr, handle);
+
+  // Frames in another format are rejected
+  std::vector<int16_t> samples(4800, kSampleValue);
+  mrsAudioFrame frame = MakeFrame(samples.data(), 240);
+  frame.sampling_rate_hz_ = 44100;
+  ASSERT_EQ(Result::kInvalidParameter,
+            mrsExternalAudioTrackSourceSubmitFrame(handle, &frame, 0));
+
+  // Contiguous 5 ms frames
+  frame = MakeFrame(samples.data(), 240);
+  ASSERT_EQ(Result::kSuccess,
+            mrsExternalAudioTrackSourceSubmitFrame(handle, &frame, 0));
+  ASSERT_EQ(Result::kSuccess,
+            mrsExternalAudioTrackSourceSubmitFrame(handle, &frame, 5));
+  ASSERT_EQ(Result::kSuccess,
+            mrsExternalAudioTrackSourceSubmitFrame(handle, &frame, -1));
+  mrsExternalAudioTrackSourceStats stats{};
+  ASSERT_EQ(Result::kSuccess,
+            mrsExternalAudioTrackSourceGetStats(handle, &stats));
+  ASSERT_EQ(0u, stats.gap_count);
+  ASSERT_EQ(0u, stats.overlap_count);
+
+  // 20 ms gap after the end of the last frame, at 15 ms
+  ASSERT_EQ(Result::kSuccess,
+            mrsExternalAudioTrackSourceSubmitFrame(handle, &frame, 35));
+  ASSERT_EQ(Result::kSuccess,
+            mrsExternalAudioTrackSourceGetStats(handle, &stats));
+  ASSERT_EQ(1u, stats.gap_count);
+  ASSERT_EQ(960u, stats.inserted_sample_count);
+
+  // Frame entirely covered by the last one, which ends at 40 ms
+  ASSERT_EQ(Result::kSuccess,
+            mrsExternalAudioTrackSourceSubmitFrame(handle, &frame, 30));
+  ASSERT_EQ(Result::kSuccess,
+            mrsExternalAudioTrackSourceGetStats(handle, &stats));
+  ASSERT_EQ(1u, stats.overlap_count);
+  ASSERT_EQ(240u, stats.overlap_sample_count);
+
+  // Nothing is played out before the jitter buffer is full
+  ASSERT_EQ(0u, stats.underrun_count);
+  ASSERT_EQ(240u * 4 + 960u, stats.buffered_sample_count);
+
+  // Fill the jitter buffer, which then drains
+  frame = MakeFrame(samples.data(), 4800);
+  ASSERT_EQ(Result::kSuccess,
+            mrsExternalAudioTrackSourceSubmitFrame(handle, &frame, 40));
+  Event ev;
+  ev.WaitFor(3s);
+  ASSERT_EQ(Result::kSuccess,
+            mrsExternalAudioTrackSourceGetStats(handle, &stats));
+  ASSERT_LT(stats.silence_frame_count, stats.frame_count);
+  ASSERT_EQ(1u, stats.underrun_count);
+  ASSERT_EQ(0u, stats.buffered_sample_count);
+  ASSERT_EQ(0u, stats.overrun_sample_count);
+
+  mrsExternalAudioTrackSourceShutdown(handle);
+  ASSERT_EQ(Result::kInvalidOperation,
+            mrsExternalAudioTrackSourceSubmitFrame(handle, &frame, -1));
+  mrsExternalAudioTrackSourceRemoveRef(handle);
+}
+
+TEST(ExternalAudioTrackSource, LocalTrack) {
+  PCRaii pc;
+
+  ConstantAudioProducer producer;
+  mrsExternalAudioTrackSourceConfig config{};
+  ExternalAudioTrackSourceHandle source_handle = nullptr;
+  ASSERT_EQ(Result::kSuccess,
+            mrsExternalAudioTrackSourceCreateFromCallback(
+                &config, &ConstantAudioProducer::OnRequest, &producer,
+                &source_handle));
+
+  // The local audio callback receives the audio of the source
+  std::atomic_uint32_t call_count{0};
+  std::atomic_uint32_t bad_call_count{0};
+  AudioFrameCallback audio_cb = [&](const AudioFrame& frame) {
+    const auto* data = static_cast<const int16_t*>(frame.data_);
+    if ((data == nullptr) || (frame.bits_per_sample_ != 16) ||
+        (frame.sampling_rate_hz_ != 48000) || (frame.channel_count_ != 1) ||
+        (frame.sample_count_ != 480) || (data[0] != kSampleValue) ||
+        (data[479] != kSampleValue)) {
+      ++bad_call_count;
+      return;
+    }
+    ++call_count;
+  };
+  mrsPeerConnectionRegisterLocalAudioFrameCallback(pc.handle(), CB(audio_cb));
+  ASSERT_EQ(Result::kSuccess,
+            mrsPeerConnectionAddLocalAudioTrackFromExternalSource(
+                pc.handle(), "external_audio", source_handle));
+
+  // Only a single local audio track is supported
+  ASSERT_NE(Result::kSuccess,
+            mrsPeerConnectionAddLocalAudioTrackFromExternalSource(
+                pc.handle(), "external_audio", source_handle));
+
+  Event ev;
+  ev.WaitFor(2s);
+  mrsPeerConnectionRemoveLocalAudioTrack(pc.handle());
+  const uint32_t count = call_count.load();
+  ASSERT_LT(50u, count);
+  ASSERT_EQ(0u, bad_call_count.load());
+  ev.WaitFor(1s);
+  ASSERT_EQ(count, call_count.load());
+
+  mrsPeerConnectionRegisterLocalAudioFrameCallback(pc.handle(), nullptr,
+                                                   nullptr);
+  mrsExternalAudioTrackSourceShutdown(source_handle);
+  mrsExternalAudioTrackSourceRemoveRef(source_handle);
+}
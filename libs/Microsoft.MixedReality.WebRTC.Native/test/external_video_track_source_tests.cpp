@@ -7,6 +7,7 @@
 #include "external_video_track_source_interop.h"
 #include "interop_api.h"
 #include "local_video_track_interop.h"
+#include "video_test_helpers.h"
 
 #include "libyuv.h"
 
@@ -16,96 +17,121 @@ namespace {
 
 uint32_t FrameBuffer[256];
 
-void FillSquareArgb32(uint32_t* buffer,
-                      int x,
-                      int y,
-                      int w,
-                      int h,
-                      int stride,
-                      uint32_t color) {
-  assert(stride % 4 == 0);
-  char* row = ((char*)buffer + (y * stride));
-  for (int j = 0; j < h; ++j) {
-    uint32_t* ptr = (uint32_t*)row + x;
-    for (int i = 0; i < w; ++i) {
-      *ptr++ = color;
+/// Producer of I420 test frames submitted without copy, recycling the frame
+/// memory once released by the track source.
+struct ZeroCopyQuadProducer {
+  static constexpr size_t kFrameSize = 16 * 16 + 2 * 8 * 8;
+
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<uint8_t[]>> free_buffers_;
+  std::atomic_uint32_t allocated_count_{0};
+  std::atomic_uint32_t submitted_count_{0};
+  std::atomic_uint32_t released_count_{0};
+
+  /// Context of a single submitted frame.
+  struct Frame {
+    ZeroCopyQuadProducer* producer_;
+    std::unique_ptr<uint8_t[]> buffer_;
+  };
+
+  static void MRS_CALL OnReleased(void* user_data) {
+    auto frame = static_cast<Frame*>(user_data);
+    ZeroCopyQuadProducer* const producer = frame->producer_;
+    {
+      std::scoped_lock lock(producer->mutex_);
+      producer->free_buffers_.push_back(std::move(frame->buffer_));
     }
-    row += stride;
+    ++producer->released_count_;
+    delete frame;
   }
-}
 
-constexpr uint32_t kRed = 0xFF2250F2u;
-constexpr uint32_t kGreen = 0xFF00BA7Fu;
-constexpr uint32_t kBlue = 0xFFEFA400u;
-constexpr uint32_t kYellow = 0xFF00B9FFu;
+  Frame* AcquireFrame() {
+    auto frame = new Frame{this, nullptr};
+    {
+      std::scoped_lock lock(mutex_);
+      if (!free_buffers_.empty()) {
+        frame->buffer_ = std::move(free_buffers_.back());
+        free_buffers_.pop_back();
+      }
+    }
+    if (!frame->buffer_) {
+      frame->buffer_ = std::make_unique<uint8_t[]>(kFrameSize);
+      ++allocated_count_;
+    }
+    return frame;
+  }
+};
 
-/// Generate a 16px by 16px test frame.
+/// Generate a 16px by 16px I420 test frame, submitted without copy.
 mrsResult MRS_CALL
-GenerateQuadTestFrame(void* /*user_data*/,
-                      ExternalVideoTrackSourceHandle source_handle,
-                      uint32_t request_id,
-                      int64_t timestamp_ms) {
-  memset(FrameBuffer, 0, 256 * 4);
-  FillSquareArgb32(FrameBuffer, 0, 0, 8, 8, 64, kRed);
-  FillSquareArgb32(FrameBuffer, 8, 0, 8, 8, 64, kGreen);
-  FillSquareArgb32(FrameBuffer, 0, 8, 8, 8, 64, kBlue);
-  FillSquareArgb32(FrameBuffer, 8, 8, 8, 8, 64, kYellow);
-  mrsArgb32VideoFrame frame_view{};
+GenerateQuadTestFrameZeroCopy(void* user_data,
+                              ExternalVideoTrackSourceHandle source_handle,
+                              uint32_t request_id,
+                              int64_t timestamp_ms) {
+  auto producer = static_cast<ZeroCopyQuadProducer*>(user_data);
+  FillQuadTestFrame(FrameBuffer);
+  ZeroCopyQuadProducer::Frame* const frame = producer->AcquireFrame();
+  uint8_t* const ydata = frame->buffer_.get();
+  uint8_t* const udata = ydata + 16 * 16;
+  uint8_t* const vdata = udata + 8 * 8;
+  libyuv::ARGBToI420((const uint8_t*)FrameBuffer, 16 * 4, ydata, 16, udata, 8,
+                     vdata, 8, 16, 16);
+  mrsI420AVideoFrame frame_view{};
   frame_view.width_ = 16;
   frame_view.height_ = 16;
-  frame_view.argb32_data_ = FrameBuffer;
-  frame_view.stride_ = 16 * 4;
-  return mrsExternalVideoTrackSourceCompleteArgb32FrameRequest(
-      source_handle, request_id, timestamp_ms, &frame_view);
+  frame_view.ydata_ = ydata;
+  frame_view.udata_ = udata;
+  frame_view.vdata_ = vdata;
+  frame_view.ystride_ = 16;
+  frame_view.ustride_ = 8;
+  frame_view.vstride_ = 8;
+  ++producer->submitted_count_;
+  return mrsExternalVideoTrackSourceCompleteI420AFrameRequestZeroCopy(
+      source_handle, request_id, timestamp_ms, &frame_view,
+      &ZeroCopyQuadProducer::OnReleased, frame);
 }
 
-inline double ArgbColorError(uint32_t ref, uint32_t val) {
-  return ((double)(ref & 0xFFu) - (double)(val & 0xFFu)) +
-         ((double)((ref & 0xFF00u) >> 8u) - (double)((val & 0xFF00u) >> 8u)) +
-         ((double)((ref & 0xFF0000u) >> 16u) -
-          (double)((val & 0xFF0000u) >> 16u)) +
-         ((double)((ref & 0xFF000000u) >> 24u) -
-          (double)((val & 0xFF000000u) >> 24u));
-}
-
-void ValidateQuadTestFrame(const void* data,
-                           const int stride,
-                           const int frame_width,
-                           const int frame_height) {
-  ASSERT_NE(nullptr, data);
-  ASSERT_EQ(16, frame_width);
-  ASSERT_EQ(16, frame_height);
-  double err = 0.0;
-  const uint8_t* row = (const uint8_t*)data;
-  for (int j = 0; j < 8; ++j) {
-    const uint32_t* argb = (const uint32_t*)row;
-    // Red
-    for (int i = 0; i < 8; ++i) {
-      err += ArgbColorError(kRed, *argb++);
-    }
-    // Green
-    for (int i = 0; i < 8; ++i) {
-      err += ArgbColorError(kGreen, *argb++);
-    }
-    row += stride;
-  }
-  for (int j = 0; j < 8; ++j) {
-    const uint32_t* argb = (const uint32_t*)row;
-    // Blue
-    for (int i = 0; i < 8; ++i) {
-      err += ArgbColorError(kBlue, *argb++);
-    }
-    // Yellow
-    for (int i = 0; i < 8; ++i) {
-      err += ArgbColorError(kYellow, *argb++);
-    }
-    row += stride;
+/// Generate a 64px by 64px gray I420A test frame, whose left half is opaque and
+/// right half is transparent.
+mrsResult MRS_CALL
+GenerateAlphaTestFrame(void* /*user_data*/,
+                       ExternalVideoTrackSourceHandle source_handle,
+                       uint32_t request_id,
+                       int64_t timestamp_ms) {
+  uint8_t ydata[64 * 64];
+  uint8_t udata[32 * 32];
+  uint8_t vdata[32 * 32];
+  uint8_t adata[64 * 64];
+  memset(ydata, 0x7F, sizeof(ydata));
+  memset(udata, 0x7F, sizeof(udata));
+  memset(vdata, 0x7F, sizeof(vdata));
+  for (int j = 0; j < 64; ++j) {
+    memset(adata + j * 64, 0xFF, 32);
+    memset(adata + j * 64 + 32, 0x00, 32);
   }
-  ASSERT_LE(std::fabs(err), 768.0);  // +/-1 per component over 256 pixels
+  mrsI420AVideoFrame frame_view{};
+  frame_view.width_ = 64;
+  frame_view.height_ = 64;
+  frame_view.ydata_ = ydata;
+  frame_view.udata_ = udata;
+  frame_view.vdata_ = vdata;
+  frame_view.adata_ = adata;
+  frame_view.ystride_ = 64;
+  frame_view.ustride_ = 32;
+  frame_view.vstride_ = 32;
+  frame_view.astride_ = 64;
+  return mrsExternalVideoTrackSourceCompleteI420AFrameRequest(
+      source_handle, request_id, timestamp_ms, &frame_view);
 }
 
-// PeerConnectionArgb32VideoFrameCallback
-using Argb32VideoFrameCallback = InteropCallback<const mrsArgb32VideoFrame&>;
+/// Frame request callback never completing the requests.
+mrsResult MRS_CALL
+IgnoreFrameRequest(void* /*user_data*/,
+                   ExternalVideoTrackSourceHandle /*source_handle*/,
+                   uint32_t /*request_id*/,
+                   int64_t /*timestamp_ms*/) {
+  return mrsResult::kSuccess;
+}
 
 }  // namespace
 
@@ -153,4 +179,460 @@ TEST(ExternalVideoTrackSource, Simple) {
   mrsExternalVideoTrackSourceRemoveRef(source_handle);
 }
 
+TEST(ExternalVideoTrackSource, RecycleFrameBuffers) {
+  LocalPeerPairRaii pair;
+
+  ExternalVideoTrackSourceHandle source_handle = nullptr;
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsExternalVideoTrackSourceCreateFromArgb32Callback(
+                &GenerateQuadTestFrame, nullptr, &source_handle));
+  ASSERT_NE(nullptr, source_handle);
+
+  LocalVideoTrackHandle track_handle = nullptr;
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsPeerConnectionAddLocalVideoTrackFromExternalSource(
+                pair.pc1(), "gen_track", source_handle, &track_handle));
+  ASSERT_NE(nullptr, track_handle);
+
+  uint32_t frame_count = 0;
+  Argb32VideoFrameCallback argb_cb =
+      [&frame_count](const mrsArgb32VideoFrame& frame) {
+        ValidateQuadTestFrame(frame.argb32_data_, frame.stride_, frame.width_,
+                              frame.height_);
+        ++frame_count;
+      };
+  mrsPeerConnectionRegisterArgb32RemoteVideoFrameCallback(pair.pc2(),
+                                                          CB(argb_cb));
+
+  mrsFrameBufferPoolStats stats_before{};
+  ASSERT_EQ(mrsResult::kSuccess, mrsFrameBufferPoolGetStats(&stats_before));
+
+  pair.ConnectAndWait();
+
+  // Simple timer
+  Event ev;
+  ev.WaitFor(5s);
+  ASSERT_LT(50u, frame_count);  // at least 10 FPS
+
+  // Each frame acquires at least one buffer on the sender side (I420 frame)
+  // and one on the receiver side (ARGB32 conversion). Those buffers are
+  // released once encoded and delivered, so the steady state should only
+  // reuse recycled memory, with a small number of allocations at startup.
+  mrsFrameBufferPoolStats stats_after{};
+  ASSERT_EQ(mrsResult::kSuccess, mrsFrameBufferPoolGetStats(&stats_after));
+  const uint64_t hit_count = stats_after.hit_count - stats_before.hit_count;
+  const uint64_t miss_count = stats_after.miss_count - stats_before.miss_count;
+  ASSERT_LE(2u * frame_count, hit_count + miss_count);
+  ASSERT_LT(miss_count, hit_count);
+
+  mrsPeerConnectionRegisterArgb32RemoteVideoFrameCallback(pair.pc2(), nullptr,
+                                                          nullptr);
+  mrsPeerConnectionRemoveLocalVideoTracksFromSource(pair.pc1(), source_handle);
+  mrsLocalVideoTrackRemoveRef(track_handle);
+  mrsExternalVideoTrackSourceShutdown(source_handle);
+  mrsExternalVideoTrackSourceRemoveRef(source_handle);
+
+  // Trimming deallocates all the recycled memory, without affecting the
+  // buffers still in use nor the allocation counters.
+  mrsFrameBufferPoolStats stats_before_trim{};
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsFrameBufferPoolGetStats(&stats_before_trim));
+  ASSERT_LT(0u, stats_before_trim.recycle_count);
+  mrsFrameBufferPoolTrim();
+  mrsFrameBufferPoolStats stats_after_trim{};
+  ASSERT_EQ(mrsResult::kSuccess, mrsFrameBufferPoolGetStats(&stats_after_trim));
+  ASSERT_EQ(0u, stats_after_trim.cached_bytes);
+  ASSERT_EQ(stats_before_trim.hit_count, stats_after_trim.hit_count);
+  ASSERT_EQ(stats_before_trim.miss_count, stats_after_trim.miss_count);
+  ASSERT_GE(stats_before_trim.outstanding_count,
+            stats_after_trim.outstanding_count);
+}
+
+TEST(ExternalVideoTrackSource, FrameBufferPoolStatsInvalid) {
+  ASSERT_EQ(mrsResult::kInvalidParameter, mrsFrameBufferPoolGetStats(nullptr));
+}
+
+TEST(ExternalVideoTrackSource, ZeroCopyFrames) {
+  ZeroCopyQuadProducer producer;
+  uint32_t frame_count = 0;
+  {
+    LocalPeerPairRaii pair;
+
+    ExternalVideoTrackSourceHandle source_handle = nullptr;
+    ASSERT_EQ(mrsResult::kSuccess,
+              mrsExternalVideoTrackSourceCreateFromI420ACallback(
+                  &GenerateQuadTestFrameZeroCopy, &producer, &source_handle));
+    ASSERT_NE(nullptr, source_handle);
+
+    // Completing an unknown request fails, but still releases the frame.
+    {
+      ZeroCopyQuadProducer::Frame* const frame = producer.AcquireFrame();
+      mrsI420AVideoFrame frame_view{};
+      frame_view.width_ = 16;
+      frame_view.height_ = 16;
+      frame_view.ydata_ = frame->buffer_.get();
+      frame_view.udata_ = frame->buffer_.get() + 16 * 16;
+      frame_view.vdata_ = frame->buffer_.get() + 16 * 16 + 8 * 8;
+      frame_view.ystride_ = 16;
+      frame_view.ustride_ = 8;
+      frame_view.vstride_ = 8;
+      ++producer.submitted_count_;
+      ASSERT_EQ(mrsResult::kInvalidParameter,
+                mrsExternalVideoTrackSourceCompleteI420AFrameRequestZeroCopy(
+                    source_handle, 0xFFFFFFFFu, 0, &frame_view,
+                    &ZeroCopyQuadProducer::OnReleased, frame));
+      ASSERT_EQ(1u, producer.released_count_.load());
+    }
+
+    LocalVideoTrackHandle track_handle = nullptr;
+    ASSERT_EQ(mrsResult::kSuccess,
+              mrsPeerConnectionAddLocalVideoTrackFromExternalSource(
+                  pair.pc1(), "gen_track", source_handle, &track_handle));
+    ASSERT_NE(nullptr, track_handle);
+
+    Argb32VideoFrameCallback argb_cb =
+        [&frame_count](const mrsArgb32VideoFrame& frame) {
+          ValidateQuadTestFrame(frame.argb32_data_, frame.stride_,
+                                frame.width_, frame.height_);
+          ++frame_count;
+        };
+    mrsPeerConnectionRegisterArgb32RemoteVideoFrameCallback(pair.pc2(),
+                                                            CB(argb_cb));
+
+    pair.ConnectAndWait();
+
+    // Simple timer
+    Event ev;
+    ev.WaitFor(5s);
+
+    mrsPeerConnectionRegisterArgb32RemoteVideoFrameCallback(pair.pc2(),
+                                                            nullptr, nullptr);
+    mrsPeerConnectionRemoveLocalVideoTracksFromSource(pair.pc1(),
+                                                      source_handle);
+    mrsLocalVideoTrackRemoveRef(track_handle);
+    mrsExternalVideoTrackSourceShutdown(source_handle);
+    mrsExternalVideoTrackSourceRemoveRef(source_handle);
+  }
+  ASSERT_LT(50u, frame_count);  // at least 10 FPS
+
+  // Once the peer connections are closed, all frames are released, and their
+  // memory was recycled by the producer instead of being reallocated.
+  ASSERT_EQ(producer.submitted_count_.load(), producer.released_count_.load());
+  ASSERT_GT(producer.submitted_count_.load(),
+            10 * producer.allocated_count_.load());
+}
+
+TEST(ExternalVideoTrackSource, AlphaPlane) {
+  LocalPeerPairRaii pair;
+
+  // The multiplex codec encodes the alpha plane alongside the color planes
+  pair.ForceVideoCodec("multiplex");
+
+  ExternalVideoTrackSourceHandle source_handle = nullptr;
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsExternalVideoTrackSourceCreateFromI420ACallback(
+                &GenerateAlphaTestFrame, nullptr, &source_handle));
+  ASSERT_NE(nullptr, source_handle);
+
+  LocalVideoTrackHandle track_handle = nullptr;
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsPeerConnectionAddLocalVideoTrackFromExternalSource(
+                pair.pc1(), "gen_track", source_handle, &track_handle));
+  ASSERT_NE(nullptr, track_handle);
+
+  std::atomic_uint32_t frame_count{0};
+  std::atomic_uint32_t alpha_frame_count{0};
+  I420AVideoFrameCallback i420a_cb = [&](const mrsI420AVideoFrame& frame) {
+    ++frame_count;
+    if (!frame.adata_) {
+      return;
+    }
+    ASSERT_EQ(64u, frame.width_);
+    ASSERT_EQ(64u, frame.height_);
+    // Lossy compression; only check the average of each half
+    uint64_t left_sum = 0;
+    uint64_t right_sum = 0;
+    const uint8_t* row = static_cast<const uint8_t*>(frame.adata_);
+    for (int j = 0; j < 64; ++j) {
+      for (int i = 0; i < 32; ++i) {
+        left_sum += row[i];
+        right_sum += row[i + 32];
+      }
+      row += frame.astride_;
+    }
+    ASSERT_LT(0xC0u * 32 * 64, left_sum);
+    ASSERT_GT(0x40u * 32 * 64, right_sum);
+    ++alpha_frame_count;
+  };
+  mrsPeerConnectionRegisterI420ARemoteVideoFrameCallback(pair.pc2(),
+                                                         CB(i420a_cb));
+
+  pair.ConnectAndWait();
+
+  Event ev;
+  ev.WaitFor(5s);
+  mrsPeerConnectionRegisterI420ARemoteVideoFrameCallback(pair.pc2(), nullptr,
+                                                         nullptr);
+  ASSERT_LT(50u, frame_count.load());  // at least 10 FPS
+  ASSERT_EQ(frame_count.load(), alpha_frame_count.load());
+
+  mrsPeerConnectionRemoveLocalVideoTracksFromSource(pair.pc1(), source_handle);
+  mrsLocalVideoTrackRemoveRef(track_handle);
+  mrsExternalVideoTrackSourceShutdown(source_handle);
+  mrsExternalVideoTrackSourceRemoveRef(source_handle);
+}
+
+TEST(ExternalVideoTrackSource, PushMode) {
+  LocalPeerPairRaii pair;
+
+  ExternalVideoTrackSourceHandle source_handle = nullptr;
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsExternalVideoTrackSourceCreatePushMode(&source_handle));
+  ASSERT_NE(nullptr, source_handle);
+
+  LocalVideoTrackHandle track_handle = nullptr;
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsPeerConnectionAddLocalVideoTrackFromExternalSource(
+                pair.pc1(), "gen_track", source_handle, &track_handle));
+  ASSERT_NE(nullptr, track_handle);
+
+  uint32_t frame_count = 0;
+  Argb32VideoFrameCallback argb_cb =
+      [&frame_count](const mrsArgb32VideoFrame& frame) {
+        ValidateQuadTestFrame(frame.argb32_data_, frame.stride_, frame.width_,
+                              frame.height_);
+        ++frame_count;
+      };
+  mrsPeerConnectionRegisterArgb32RemoteVideoFrameCallback(pair.pc2(),
+                                                          CB(argb_cb));
+
+  pair.ConnectAndWait();
+
+  // Push frames at 100 FPS, faster than the fixed rate of pull-mode sources
+  uint32_t quad[256];
+  FillQuadTestFrame(quad);
+  mrsArgb32VideoFrame frame_view{};
+  frame_view.width_ = 16;
+  frame_view.height_ = 16;
+  frame_view.argb32_data_ = quad;
+  frame_view.stride_ = 16 * 4;
+  const auto start = std::chrono::steady_clock::now();
+  auto next = start;
+  while (std::chrono::steady_clock::now() - start < 5s) {
+    ASSERT_EQ(mrsResult::kSuccess, mrsExternalVideoTrackSourceSubmitArgb32Frame(
+                                       source_handle, &frame_view));
+    next += 10ms;
+    std::this_thread::sleep_until(next);
+  }
+  ASSERT_LT(200u, frame_count);  // more than 40 FPS
+
+  mrsPeerConnectionRegisterArgb32RemoteVideoFrameCallback(pair.pc2(), nullptr,
+                                                          nullptr);
+  mrsPeerConnectionRemoveLocalVideoTracksFromSource(pair.pc1(), source_handle);
+  mrsLocalVideoTrackRemoveRef(track_handle);
+  mrsExternalVideoTrackSourceShutdown(source_handle);
+
+  // Submitting after shutdown fails
+  ASSERT_EQ(mrsResult::kInvalidOperation,
+            mrsExternalVideoTrackSourceSubmitArgb32Frame(source_handle,
+                                                         &frame_view));
+  mrsExternalVideoTrackSourceRemoveRef(source_handle);
+}
+
+TEST(ExternalVideoTrackSource, PushToPullModeFails) {
+  ExternalVideoTrackSourceHandle source_handle = nullptr;
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsExternalVideoTrackSourceCreateFromArgb32Callback(
+                &GenerateQuadTestFrame, nullptr, &source_handle));
+  ASSERT_NE(nullptr, source_handle);
+  mrsArgb32VideoFrame frame_view{};
+  frame_view.width_ = 16;
+  frame_view.height_ = 16;
+  frame_view.argb32_data_ = FrameBuffer;
+  frame_view.stride_ = 16 * 4;
+  ASSERT_EQ(mrsResult::kInvalidOperation,
+            mrsExternalVideoTrackSourceSubmitArgb32Frame(source_handle,
+                                                         &frame_view));
+  ASSERT_EQ(mrsResult::kInvalidParameter,
+            mrsExternalVideoTrackSourceSubmitArgb32Frame(source_handle,
+                                                         nullptr));
+  mrsExternalVideoTrackSourceShutdown(source_handle);
+  mrsExternalVideoTrackSourceRemoveRef(source_handle);
+}
+
+TEST(ExternalVideoTrackSource, ReuseFrameBuffers) {
+  ExternalVideoTrackSourceHandle source_handle = nullptr;
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsExternalVideoTrackSourceCreatePushMode(&source_handle));
+  ASSERT_NE(nullptr, source_handle);
+
+  // Without any track, each frame is released as soon as dispatched, so its
+  // buffer is reused by the next frame of the same dimensions.
+  std::vector<uint32_t> pixels(32 * 32, kRed);
+  mrsArgb32VideoFrame frame_view{};
+  frame_view.width_ = 16;
+  frame_view.height_ = 16;
+  frame_view.argb32_data_ = pixels.data();
+  frame_view.stride_ = 16 * 4;
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_EQ(mrsResult::kSuccess, mrsExternalVideoTrackSourceSubmitArgb32Frame(
+                                       source_handle, &frame_view));
+  }
+  mrsExternalVideoTrackSourceStats stats{};
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsExternalVideoTrackSourceGetStats(source_handle, &stats));
+  ASSERT_EQ(16, stats.frame_width);
+  ASSERT_EQ(16, stats.frame_height);
+  ASSERT_EQ(1u, stats.buffer_allocation_count);
+  ASSERT_EQ(9u, stats.buffer_reuse_count);
+  ASSERT_EQ(0u, stats.reconfiguration_count);
+
+  // Changing the frame dimensions discards the buffers of the previous size
+  frame_view.width_ = 32;
+  frame_view.height_ = 32;
+  frame_view.stride_ = 32 * 4;
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_EQ(mrsResult::kSuccess, mrsExternalVideoTrackSourceSubmitArgb32Frame(
+                                       source_handle, &frame_view));
+  }
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsExternalVideoTrackSourceGetStats(source_handle, &stats));
+  ASSERT_EQ(32, stats.frame_width);
+  ASSERT_EQ(32, stats.frame_height);
+  ASSERT_EQ(2u, stats.buffer_allocation_count);
+  ASSERT_EQ(18u, stats.buffer_reuse_count);
+  ASSERT_EQ(1u, stats.reconfiguration_count);
+
+  mrsExternalVideoTrackSourceShutdown(source_handle);
+  mrsExternalVideoTrackSourceRemoveRef(source_handle);
+}
+
+TEST(ExternalVideoTrackSource, FramePacing) {
+  ExternalVideoTrackSourceHandle source_handle = nullptr;
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsExternalVideoTrackSourceCreateFromArgb32Callback(
+                &GenerateQuadTestFrame, nullptr, &source_handle));
+  ASSERT_NE(nullptr, source_handle);
+
+  ASSERT_EQ(mrsResult::kInvalidParameter,
+            mrsExternalVideoTrackSourceSetFramerate(source_handle, 0.0));
+  ASSERT_EQ(mrsResult::kInvalidParameter,
+            mrsExternalVideoTrackSourceSetFramerate(source_handle, -30.0));
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsExternalVideoTrackSourceSetFramerate(source_handle, 29.97));
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsExternalVideoTrackSourceSetFramerate(source_handle, 50.0));
+
+  // Let the source request frames for a while
+  std::this_thread::sleep_for(2s);
+
+  mrsExternalVideoTrackSourceStats stats{};
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsExternalVideoTrackSourceGetStats(source_handle, &stats));
+  ASSERT_EQ(50.0, stats.framerate);
+  // Deadlines do not drift, so the number of requests only depends on the
+  // elapsed time, up to the requests skipped on a heavily loaded machine.
+  ASSERT_LE(stats.request_count, 110u);
+  ASSERT_GE(stats.request_count + stats.skipped_request_count, 90u);
+  ASSERT_GE(stats.max_jitter_us, stats.mean_jitter_us);
+  ASSERT_EQ(mrsResult::kInvalidParameter,
+            mrsExternalVideoTrackSourceGetStats(source_handle, nullptr));
+
+  mrsExternalVideoTrackSourceShutdown(source_handle);
+  mrsExternalVideoTrackSourceRemoveRef(source_handle);
+
+  // Push-mode sources produce frames at their own rate
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsExternalVideoTrackSourceCreatePushMode(&source_handle));
+  ASSERT_EQ(mrsResult::kInvalidOperation,
+            mrsExternalVideoTrackSourceSetFramerate(source_handle, 30.0));
+  mrsExternalVideoTrackSourceShutdown(source_handle);
+  mrsExternalVideoTrackSourceRemoveRef(source_handle);
+}
+
+TEST(ExternalVideoTrackSource, RequestTracking) {
+  ExternalVideoTrackSourceHandle source_handle = nullptr;
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsExternalVideoTrackSourceCreateFromArgb32Callback(
+                &GenerateQuadTestFrame, nullptr, &source_handle));
+  ASSERT_NE(nullptr, source_handle);
+  std::this_thread::sleep_for(500ms);
+
+  // All requests are completed synchronously from the callback
+  mrsExternalVideoTrackSourceStats stats{};
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsExternalVideoTrackSourceGetStats(source_handle, &stats));
+  ASSERT_LT(0u, stats.completed_request_count);
+  ASSERT_EQ(0u, stats.expired_request_count);
+  ASSERT_EQ(0u, stats.rejected_request_count);
+
+  // Completing an already completed request fails
+  mrsArgb32VideoFrame frame_view{};
+  frame_view.width_ = 16;
+  frame_view.height_ = 16;
+  frame_view.argb32_data_ = FrameBuffer;
+  frame_view.stride_ = 16 * 4;
+  ASSERT_EQ(mrsResult::kInvalidParameter,
+            mrsExternalVideoTrackSourceCompleteArgb32FrameRequest(
+                source_handle, 0, 0, &frame_view));
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsExternalVideoTrackSourceGetStats(source_handle, &stats));
+  ASSERT_EQ(1u, stats.rejected_request_count);
+
+  mrsExternalVideoTrackSourceShutdown(source_handle);
+  mrsExternalVideoTrackSourceRemoveRef(source_handle);
+
+  // Requests never completed eventually expire, keeping a bounded number of
+  // outstanding requests.
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsExternalVideoTrackSourceCreateFromArgb32Callback(
+                &IgnoreFrameRequest, nullptr, &source_handle));
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsExternalVideoTrackSourceSetFramerate(source_handle, 100.0));
+  std::this_thread::sleep_for(1s);
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsExternalVideoTrackSourceGetStats(source_handle, &stats));
+  ASSERT_EQ(64u, stats.outstanding_request_count);
+  ASSERT_EQ(0u, stats.completed_request_count);
+  ASSERT_LT(0u, stats.expired_request_count);
+
+  mrsExternalVideoTrackSourceShutdown(source_handle);
+  mrsExternalVideoTrackSourceRemoveRef(source_handle);
+}
+
+TEST(ExternalVideoTrackSource, SharedCaptureThreads) {
+  ASSERT_EQ(mrsResult::kInvalidParameter,
+            mrsSetExternalVideoTrackSourceThreadCount(0));
+  ASSERT_EQ(mrsResult::kSuccess, mrsSetExternalVideoTrackSourceThreadCount(3));
+  ASSERT_EQ(3, mrsGetExternalVideoTrackSourceThreadCount());
+
+  // Many sources, each with its own pace, share the same few threads
+  constexpr int kSourceCount = 16;
+  ExternalVideoTrackSourceHandle source_handles[kSourceCount]{};
+  for (int i = 0; i < kSourceCount; ++i) {
+    ASSERT_EQ(mrsResult::kSuccess,
+              mrsExternalVideoTrackSourceCreateFromArgb32Callback(
+                  &IgnoreFrameRequest, nullptr, &source_handles[i]));
+    ASSERT_EQ(mrsResult::kSuccess, mrsExternalVideoTrackSourceSetFramerate(
+                                       source_handles[i], 20.0 + 5.0 * i));
+  }
+
+  // Changing the number of threads does not interrupt the sources
+  std::this_thread::sleep_for(1s);
+  ASSERT_EQ(mrsResult::kSuccess, mrsSetExternalVideoTrackSourceThreadCount(2));
+  std::this_thread::sleep_for(1s);
+
+  for (int i = 0; i < kSourceCount; ++i) {
+    mrsExternalVideoTrackSourceStats stats{};
+    ASSERT_EQ(mrsResult::kSuccess,
+              mrsExternalVideoTrackSourceGetStats(source_handles[i], &stats));
+    const double expected_count = 2.0 * (20.0 + 5.0 * i);
+    ASSERT_LE(expected_count * 0.8,
+              stats.request_count + stats.skipped_request_count);
+    ASSERT_GE(expected_count * 1.1, stats.request_count);
+    mrsExternalVideoTrackSourceShutdown(source_handles[i]);
+    mrsExternalVideoTrackSourceRemoveRef(source_handles[i]);
+  }
+}
+
 #endif  // MRSW_EXCLUDE_DEVICE_TESTS
@@ -203,6 +203,12 @@ class LocalPeerPairRaii {
   PeerConnectionHandle pc1() const { return pc1_.handle(); }
   PeerConnectionHandle pc2() const { return pc2_.handle(); }
 
+  /// Force the video codec negotiated by the next offer, if supported. This
+  /// must be called before |ConnectAndWait()|.
+  void ForceVideoCodec(std::string codec_name) {
+    video_codec_name_ = std::move(codec_name);
+  }
+
   void ConnectAndWait() {
     Event ev1, ev2;
     connected1_cb_ = [&ev1]() { ev1.Set(); };
@@ -225,8 +231,25 @@ class LocalPeerPairRaii {
   IceCallback ice2_cb_;
   InteropCallback<> connected1_cb_;
   InteropCallback<> connected2_cb_;
+  std::string video_codec_name_;
+  std::string FilterOffer(const char* sdp_data) {
+    SdpFilter audio_filter{};
+    SdpFilter video_filter{video_codec_name_.c_str(), ""};
+    uint64_t len = strlen(sdp_data) + 1;
+    std::string buffer(static_cast<size_t>(len), '\0');
+    EXPECT_EQ(Result::kSuccess, mrsSdpForceCodecs(sdp_data, audio_filter,
+                                                  video_filter, &buffer[0],
+                                                  &len));
+    buffer.resize(static_cast<size_t>(len - 1));
+    return buffer;
+  }
   void setup() {
     sdp1_cb_ = [this](const char* type, const char* sdp_data) {
+      std::string filtered;
+      if (!video_codec_name_.empty() && (kOfferString == type)) {
+        filtered = FilterOffer(sdp_data);
+        sdp_data = filtered.c_str();
+      }
       ASSERT_EQ(Result::kSuccess, mrsPeerConnectionSetRemoteDescription(
                                       pc2_.handle(), type, sdp_data));
       if (kOfferString == type) {
@@ -235,6 +258,11 @@ class LocalPeerPairRaii {
       }
     };
     sdp2_cb_ = [this](const char* type, const char* sdp_data) {
+      std::string filtered;
+      if (!video_codec_name_.empty() && (kOfferString == type)) {
+        filtered = FilterOffer(sdp_data);
+        sdp_data = filtered.c_str();
+      }
       ASSERT_EQ(Result::kSuccess, mrsPeerConnectionSetRemoteDescription(
                                       pc1_.handle(), type, sdp_data));
       if (kOfferString == type) {
@@ -0,0 +1,302 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include "external_video_track_source_interop.h"
+#include "interop_api.h"
+
+namespace {
+
+/// Planes of a random I420A test frame.
+struct TestFrame {
+  TestFrame(int width, int height)
+      : width_(width),
+        height_(height),
+        chroma_width_((width + 1) / 2),
+        chroma_height_((height + 1) / 2) {
+    y_.resize((size_t)width_ * height_);
+    a_.resize((size_t)width_ * height_);
+    u_.resize((size_t)chroma_width_ * chroma_height_);
+    v_.resize((size_t)chroma_width_ * chroma_height_);
+    for (auto* plane : {&y_, &u_, &v_, &a_}) {
+      for (auto& value : *plane) {
+        value = (uint8_t)(rand() & 0xFF);
+      }
+    }
+  }
+
+  mrsI420AVideoFrame GetFrame(bool with_alpha) const {
+    mrsI420AVideoFrame frame{};
+    frame.width_ = width_;
+    frame.height_ = height_;
+    frame.ydata_ = y_.data();
+    frame.udata_ = u_.data();
+    frame.vdata_ = v_.data();
+    frame.adata_ = (with_alpha ? a_.data() : nullptr);
+    frame.ystride_ = width_;
+    frame.ustride_ = chroma_width_;
+    frame.vstride_ = chroma_width_;
+    frame.astride_ = (with_alpha ? width_ : 0);
+    return frame;
+  }
+
+  const int width_;
+  const int height_;
+  const int chroma_width_;
+  const int chroma_height_;
+  std::vector<uint8_t> y_, u_, v_, a_;
+};
+
+/// Convert |frame| |iter_count| times and return the average duration of a
+/// conversion, in milliseconds.
+double BenchmarkConversion(const mrsI420AVideoFrame& frame,
+                           std::vector<uint8_t>& argb,
+                           int iter_count) {
+  const int32_t stride = (int32_t)frame.width_ * 4;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iter_count; ++i) {
+    EXPECT_EQ(Result::kSuccess,
+              mrsConvertI420AVideoFrameToArgb32(&frame, argb.data(), stride));
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count() /
+         iter_count;
+}
+
+/// Record the duration |duration_ms|, in milliseconds, as a property of the
+/// current test in microseconds.
+void RecordDuration(const std::string& key, double duration_ms) {
+  ::testing::Test::RecordProperty(key, (int)(duration_ms * 1000.0));
+}
+
+/// Compare single-threaded and parallel conversion of a frame, for
+/// correctness, and for throughput if |iter_count| is greater than one. The
+/// average duration of a conversion is recorded as test properties.
+void RunConversionBenchmark(int width,
+                            int height,
+                            bool with_alpha,
+                            int iter_count = 1) {
+  TestFrame test_frame(width, height);
+  const mrsI420AVideoFrame frame = test_frame.GetFrame(with_alpha);
+  std::vector<uint8_t> argb_single((size_t)width * height * 4);
+  std::vector<uint8_t> argb_parallel((size_t)width * height * 4);
+
+  mrsSetParallelVideoConversionMinPixelCount(INT64_MAX);
+  const double single_ms =
+      BenchmarkConversion(frame, argb_single, iter_count);
+  mrsSetParallelVideoConversionMinPixelCount(0);
+  const double parallel_ms =
+      BenchmarkConversion(frame, argb_parallel, iter_count);
+  mrsSetParallelVideoConversionMinPixelCount(1280 * 720);
+
+  if (iter_count > 1) {
+    const std::string key = "i420_" + std::to_string(width) + "x" +
+                            std::to_string(height) +
+                            (with_alpha ? "_alpha" : "");
+    RecordDuration(key + "_single_us", single_ms);
+    RecordDuration(key + "_parallel_us", parallel_ms);
+  }
+  ASSERT_EQ(0, memcmp(argb_single.data(), argb_parallel.data(),
+                      argb_single.size()));
+}
+
+/// Random ARGB32 test frame.
+struct Argb32TestFrame {
+  Argb32TestFrame(int width, int height) : width_(width), height_(height) {
+    argb_.resize((size_t)width_ * height_);
+    for (auto& value : argb_) {
+      value = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+    }
+  }
+
+  mrsArgb32VideoFrame GetFrame() const {
+    mrsArgb32VideoFrame frame{};
+    frame.width_ = width_;
+    frame.height_ = height_;
+    frame.argb32_data_ = argb_.data();
+    frame.stride_ = width_ * 4;
+    return frame;
+  }
+
+  const int width_;
+  const int height_;
+  std::vector<uint32_t> argb_;
+};
+
+/// Planes of an I420 frame converted from an ARGB32 frame.
+struct I420Planes {
+  I420Planes(int width, int height)
+      : ystride_(width), uvstride_((width + 1) / 2) {
+    y_.resize((size_t)ystride_ * height);
+    u_.resize((size_t)uvstride_ * ((height + 1) / 2));
+    v_.resize(u_.size());
+  }
+
+  mrsResult Convert(const mrsArgb32VideoFrame& frame) {
+    return mrsConvertArgb32VideoFrameToI420(&frame, y_.data(), ystride_,
+                                            u_.data(), uvstride_, v_.data(),
+                                            uvstride_);
+  }
+
+  bool operator==(const I420Planes& other) const {
+    return (y_ == other.y_) && (u_ == other.u_) && (v_ == other.v_);
+  }
+
+  const int ystride_;
+  const int uvstride_;
+  std::vector<uint8_t> y_, u_, v_;
+};
+
+/// Submit |frame| |iter_count| times to a push-mode external video track
+/// source, and return the average duration of the ingest of a frame, in
+/// milliseconds.
+double BenchmarkIngest(ExternalVideoTrackSourceHandle source_handle,
+                       const mrsArgb32VideoFrame& frame,
+                       int iter_count) {
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iter_count; ++i) {
+    EXPECT_EQ(Result::kSuccess, mrsExternalVideoTrackSourceSubmitArgb32Frame(
+                                    source_handle, &frame));
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count() /
+         iter_count;
+}
+
+/// Compare single-threaded and parallel ingest of an ARGB32 frame by an
+/// external video track source, for correctness, and for throughput if
+/// |iter_count| is greater than one. The average duration of an ingest is
+/// recorded as test properties.
+void RunIngestBenchmark(int width, int height, int iter_count = 1) {
+  Argb32TestFrame test_frame(width, height);
+  const mrsArgb32VideoFrame frame = test_frame.GetFrame();
+
+  // Check that the parallel conversion produces the same result
+  I420Planes i420_single(width, height);
+  I420Planes i420_parallel(width, height);
+  mrsSetParallelVideoConversionMinPixelCount(INT64_MAX);
+  ASSERT_EQ(Result::kSuccess, i420_single.Convert(frame));
+  mrsSetParallelVideoConversionMinPixelCount(0);
+  ASSERT_EQ(Result::kSuccess, i420_parallel.Convert(frame));
+  ASSERT_TRUE(i420_single == i420_parallel);
+
+  // Measure the ingest time, which includes the conversion to I420
+  ExternalVideoTrackSourceHandle source_handle = nullptr;
+  ASSERT_EQ(Result::kSuccess,
+            mrsExternalVideoTrackSourceCreatePushMode(&source_handle));
+  ASSERT_EQ(Result::kSuccess, mrsExternalVideoTrackSourceSetOddSizeMode(
+                                  source_handle, mrsOddSizeMode::kPad));
+  mrsSetParallelVideoConversionMinPixelCount(INT64_MAX);
+  const double single_ms = BenchmarkIngest(source_handle, frame, iter_count);
+  mrsSetParallelVideoConversionMinPixelCount(0);
+  const double parallel_ms = BenchmarkIngest(source_handle, frame, iter_count);
+  mrsSetParallelVideoConversionMinPixelCount(1280 * 720);
+  mrsExternalVideoTrackSourceShutdown(source_handle);
+  mrsExternalVideoTrackSourceRemoveRef(source_handle);
+
+  if (iter_count > 1) {
+    const std::string key = "argb32_ingest_" + std::to_string(width) + "x" +
+                            std::to_string(height);
+    RecordDuration(key + "_single_us", single_ms);
+    RecordDuration(key + "_parallel_us", parallel_ms);
+  }
+}
+
+}  // namespace
+
+TEST(VideoConversion, InvalidParameters) {
+  TestFrame test_frame(16, 16);
+  mrsI420AVideoFrame frame = test_frame.GetFrame(false);
+  std::vector<uint8_t> argb(16 * 16 * 4);
+  ASSERT_EQ(Result::kInvalidParameter,
+            mrsConvertI420AVideoFrameToArgb32(nullptr, argb.data(), 64));
+  ASSERT_EQ(Result::kInvalidParameter,
+            mrsConvertI420AVideoFrameToArgb32(&frame, nullptr, 64));
+  ASSERT_EQ(Result::kInvalidParameter,
+            mrsConvertI420AVideoFrameToArgb32(&frame, argb.data(), 32));
+  frame.udata_ = nullptr;
+  ASSERT_EQ(Result::kInvalidParameter,
+            mrsConvertI420AVideoFrameToArgb32(&frame, argb.data(), 64));
+}
+
+TEST(VideoConversion, Parallel720p) {
+  RunConversionBenchmark(1280, 720, false);
+  RunConversionBenchmark(1280, 720, true);
+}
+
+TEST(VideoConversion, Parallel1080p) {
+  RunConversionBenchmark(1920, 1080, false);
+  RunConversionBenchmark(1920, 1080, true);
+}
+
+TEST(VideoConversion, Parallel4K) {
+  RunConversionBenchmark(3840, 2160, false);
+  RunConversionBenchmark(3840, 2160, true);
+}
+
+// Odd sizes exercise the last band with an odd number of rows.
+TEST(VideoConversion, ParallelOddSize) {
+  RunConversionBenchmark(1921, 1081, false);
+  RunConversionBenchmark(1921, 1081, true);
+}
+
+// Benchmark of the single-threaded and parallel conversions. Run explicitly
+// with --gtest_also_run_disabled_tests; the average duration of a conversion
+// of each frame size is reported as test properties.
+TEST(VideoConversion, DISABLED_ParallelBenchmark) {
+  constexpr int kIterCount = 10;
+  for (auto [width, height] : {std::pair{1280, 720}, std::pair{1920, 1080},
+                               std::pair{3840, 2160}}) {
+    RunConversionBenchmark(width, height, false, kIterCount);
+    RunConversionBenchmark(width, height, true, kIterCount);
+  }
+}
+
+TEST(VideoConversion, IngestInvalidParameters) {
+  Argb32TestFrame test_frame(16, 16);
+  mrsArgb32VideoFrame frame = test_frame.GetFrame();
+  I420Planes planes(16, 16);
+  ASSERT_EQ(Result::kInvalidParameter,
+            mrsConvertArgb32VideoFrameToI420(nullptr, planes.y_.data(), 16,
+                                             planes.u_.data(), 8,
+                                             planes.v_.data(), 8));
+  ASSERT_EQ(Result::kInvalidParameter,
+            mrsConvertArgb32VideoFrameToI420(&frame, planes.y_.data(), 8,
+                                             planes.u_.data(), 8,
+                                             planes.v_.data(), 8));
+  ASSERT_EQ(Result::kInvalidParameter,
+            mrsConvertArgb32VideoFrameToI420(&frame, planes.y_.data(), 16,
+                                             nullptr, 8, planes.v_.data(), 8));
+  frame.stride_ = 32;
+  ASSERT_EQ(Result::kInvalidParameter, planes.Convert(frame));
+}
+
+TEST(VideoConversion, Ingest720p) {
+  RunIngestBenchmark(1280, 720);
+}
+
+TEST(VideoConversion, Ingest1080p) {
+  RunIngestBenchmark(1920, 1080);
+}
+
+TEST(VideoConversion, Ingest4K) {
+  RunIngestBenchmark(3840, 2160);
+}
+
+// Odd sizes are padded instead of cropped, and exercise the last column and
+// the last band with an odd number of rows.
+TEST(VideoConversion, IngestOddSize) {
+  RunIngestBenchmark(1921, 1081);
+}
+
+// Benchmark of the single-threaded and parallel ingest. Run explicitly with
+// --gtest_also_run_disabled_tests; the average duration of the ingest of each
+// frame size is reported as test properties.
+TEST(VideoConversion, DISABLED_IngestBenchmark) {
+  constexpr int kIterCount = 10;
+  for (auto [width, height] : {std::pair{1280, 720}, std::pair{1920, 1080},
+                               std::pair{3840, 2160}}) {
+    RunIngestBenchmark(width, height, kIterCount);
+  }
+}
@@ -0,0 +1,150 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "external_video_track_source_interop.h"
+#include "interop_api.h"
+#include "local_video_track_interop.h"
+
+// PeerConnectionI420AVideoFrameCallback
+using I420AVideoFrameCallback = InteropCallback<const mrsI420AVideoFrame&>;
+
+// PeerConnectionArgb32VideoFrameCallback
+using Argb32VideoFrameCallback = InteropCallback<const mrsArgb32VideoFrame&>;
+
+inline void FillSquareArgb32(uint32_t* buffer,
+                             int x,
+                             int y,
+                             int w,
+                             int h,
+                             int stride,
+                             uint32_t color) {
+  assert(stride % 4 == 0);
+  char* row = ((char*)buffer + (y * stride));
+  for (int j = 0; j < h; ++j) {
+    uint32_t* ptr = (uint32_t*)row + x;
+    for (int i = 0; i < w; ++i) {
+      *ptr++ = color;
+    }
+    row += stride;
+  }
+}
+
+constexpr uint32_t kRed = 0xFF2250F2u;
+constexpr uint32_t kGreen = 0xFF00BA7Fu;
+constexpr uint32_t kBlue = 0xFFEFA400u;
+constexpr uint32_t kYellow = 0xFF00B9FFu;
+
+/// Fill the 16px by 16px ARGB32 |buffer| with four squares of different
+/// colors.
+inline void FillQuadTestFrame(uint32_t* buffer) {
+  memset(buffer, 0, 256 * 4);
+  FillSquareArgb32(buffer, 0, 0, 8, 8, 64, kRed);
+  FillSquareArgb32(buffer, 8, 0, 8, 8, 64, kGreen);
+  FillSquareArgb32(buffer, 0, 8, 8, 8, 64, kBlue);
+  FillSquareArgb32(buffer, 8, 8, 8, 8, 64, kYellow);
+}
+
+/// Generate a 16px by 16px test frame.
+inline mrsResult MRS_CALL
+GenerateQuadTestFrame(void* /*user_data*/,
+                      ExternalVideoTrackSourceHandle source_handle,
+                      uint32_t request_id,
+                      int64_t timestamp_ms) {
+  uint32_t buffer[256];
+  FillQuadTestFrame(buffer);
+  mrsArgb32VideoFrame frame_view{};
+  frame_view.width_ = 16;
+  frame_view.height_ = 16;
+  frame_view.argb32_data_ = buffer;
+  frame_view.stride_ = 16 * 4;
+  return mrsExternalVideoTrackSourceCompleteArgb32FrameRequest(
+      source_handle, request_id, timestamp_ms, &frame_view);
+}
+
+inline double ArgbColorError(uint32_t ref, uint32_t val) {
+  return ((double)(ref & 0xFFu) - (double)(val & 0xFFu)) +
+         ((double)((ref & 0xFF00u) >> 8u) - (double)((val & 0xFF00u) >> 8u)) +
+         ((double)((ref & 0xFF0000u) >> 16u) -
+          (double)((val & 0xFF0000u) >> 16u)) +
+         ((double)((ref & 0xFF000000u) >> 24u) -
+          (double)((val & 0xFF000000u) >> 24u));
+}
+
+/// Check that an ARGB32 frame is the test frame of |GenerateQuadTestFrame()|,
+/// within the tolerance of a round trip through video compression.
+inline void ValidateQuadTestFrame(const void* data,
+                                  const int stride,
+                                  const int frame_width,
+                                  const int frame_height) {
+  ASSERT_NE(nullptr, data);
+  ASSERT_EQ(16, frame_width);
+  ASSERT_EQ(16, frame_height);
+  double err = 0.0;
+  const uint8_t* row = (const uint8_t*)data;
+  for (int j = 0; j < 8; ++j) {
+    const uint32_t* argb = (const uint32_t*)row;
+    // Red
+    for (int i = 0; i < 8; ++i) {
+      err += ArgbColorError(kRed, *argb++);
+    }
+    // Green
+    for (int i = 0; i < 8; ++i) {
+      err += ArgbColorError(kGreen, *argb++);
+    }
+    row += stride;
+  }
+  for (int j = 0; j < 8; ++j) {
+    const uint32_t* argb = (const uint32_t*)row;
+    // Blue
+    for (int i = 0; i < 8; ++i) {
+      err += ArgbColorError(kBlue, *argb++);
+    }
+    // Yellow
+    for (int i = 0; i < 8; ++i) {
+      err += ArgbColorError(kYellow, *argb++);
+    }
+    row += stride;
+  }
+  ASSERT_LE(std::fabs(err), 768.0);  // +/-1 per component over 256 pixels
+}
+
+/// Helper to create an external video track source generating the test frame
+/// of |GenerateQuadTestFrame()|, and add a local video track using it to a
+/// peer connection, until destroyed.
+class QuadVideoTrackRaii {
+ public:
+  QuadVideoTrackRaii(PeerConnectionHandle pc,
+                     const char* track_name = "gen_track")
+      : pc_(pc) {
+    create(track_name);
+  }
+  ~QuadVideoTrackRaii() {
+    if (track_handle_) {
+      mrsPeerConnectionRemoveLocalVideoTracksFromSource(pc_, source_handle_);
+      mrsLocalVideoTrackRemoveRef(track_handle_);
+    }
+    if (source_handle_) {
+      mrsExternalVideoTrackSourceShutdown(source_handle_);
+      mrsExternalVideoTrackSourceRemoveRef(source_handle_);
+    }
+  }
+  ExternalVideoTrackSourceHandle source() const { return source_handle_; }
+  LocalVideoTrackHandle track() const { return track_handle_; }
+
+ protected:
+  PeerConnectionHandle pc_{};
+  ExternalVideoTrackSourceHandle source_handle_{};
+  LocalVideoTrackHandle track_handle_{};
+  void create(const char* track_name) {
+    ASSERT_EQ(mrsResult::kSuccess,
+              mrsExternalVideoTrackSourceCreateFromArgb32Callback(
+                  &GenerateQuadTestFrame, nullptr, &source_handle_));
+    ASSERT_NE(nullptr, source_handle_);
+    ASSERT_EQ(mrsResult::kSuccess,
+              mrsPeerConnectionAddLocalVideoTrackFromExternalSource(
+                  pc_, track_name, source_handle_, &track_handle_));
+    ASSERT_NE(nullptr, track_handle_);
+  }
+};
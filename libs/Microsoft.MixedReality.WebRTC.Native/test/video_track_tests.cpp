@@ -6,6 +6,10 @@
 #include "external_video_track_source_interop.h"
 #include "interop_api.h"
 #include "local_video_track_interop.h"
+#include "video_frame_handle_interop.h"
+#include "video_test_helpers.h"
+
+#include "libyuv.h"
 
 #if !defined(MRSW_EXCLUDE_DEVICE_TESTS)
 
@@ -14,6 +18,22 @@ namespace {
 // PeerConnectionI420VideoFrameCallback
 using I420VideoFrameCallback = InteropCallback<const I420AVideoFrame&>;
 
+// PeerConnectionRemoteVideoTrackFrameCallback
+using RemoteVideoTrackFrameCallback =
+    InteropCallback<const char*, mrsVideoFrameHandle>;
+
+// PeerConnectionNv12VideoFrameCallback
+using Nv12VideoFrameCallback = InteropCallback<const mrsNv12VideoFrame&>;
+
+// PeerConnectionRgba32VideoFrameCallback
+using Rgba32VideoFrameCallback = InteropCallback<const mrsRgba32VideoFrame&>;
+
+// PeerConnectionBgra32VideoFrameCallback
+using Bgra32VideoFrameCallback = InteropCallback<const mrsBgra32VideoFrame&>;
+
+// PeerConnectionVideoFrameHandleCallback
+using VideoFrameHandleCallback = InteropCallback<mrsVideoFrameHandle>;
+
 /// Generate a test frame to simualte an external video track source.
 mrsResult MRS_CALL MakeTestFrame(void* /*user_data*/,
                                  ExternalVideoTrackSourceHandle handle,
@@ -242,4 +262,401 @@ TEST(VideoTrack, ExternalI420) {
   mrsExternalVideoTrackSourceRemoveRef(source_handle);
 }
 
+// Benchmark of the frame rate sustained by the decoder thread with a slow
+// remote video frame consumer. Run explicitly with
+// --gtest_also_run_disabled_tests; results are reported as test properties.
+TEST(VideoTrack, DISABLED_SlowCallbackContention) {
+  LocalPeerPairRaii pair;
+  QuadVideoTrackRaii track(pair.pc1());
+
+  // Number of frames received on the decoder thread over |kMeasureDuration|,
+  // whether delivered to the callbacks, dropped, or queued for delivery.
+  constexpr auto kMeasureDuration = 2s;
+  auto measure_received_frames = [&]() -> uint64_t {
+    mrsVideoFrameDeliveryStats stats{};
+    mrsPeerConnectionGetRemoteVideoFrameDeliveryStats(pair.pc2(), &stats);
+    const uint64_t start_count =
+        stats.delivered_count + stats.dropped_count + stats.queue_size;
+    std::this_thread::sleep_for(kMeasureDuration);
+    mrsPeerConnectionGetRemoteVideoFrameDeliveryStats(pair.pc2(), &stats);
+    return stats.delivered_count + stats.dropped_count + stats.queue_size -
+           start_count;
+  };
+
+  // Baseline with a fast consumer
+  Event first_frame_ev;
+  Argb32VideoFrameCallback fast_argb_cb =
+      [&](const mrsArgb32VideoFrame& /*frame*/) { first_frame_ev.Set(); };
+  mrsPeerConnectionRegisterArgb32RemoteVideoFrameCallback(pair.pc2(),
+                                                          CB(fast_argb_cb));
+  pair.ConnectAndWait();
+  ASSERT_TRUE(first_frame_ev.WaitFor(5s));
+  const uint64_t baseline_count = measure_received_frames();
+  ASSERT_LT(0u, baseline_count);
+
+  // Deliberately slow consumer, blocking the thread invoking it for 100 ms on
+  // each frame it receives.
+  constexpr auto kSlowCallbackDuration = 100ms;
+  std::atomic_uint32_t slow_frame_count{0};
+  Argb32VideoFrameCallback slow_cb =
+      [&](const mrsArgb32VideoFrame& /*frame*/) {
+        std::this_thread::sleep_for(kSlowCallbackDuration);
+        ++slow_frame_count;
+      };
+  mrsPeerConnectionRegisterArgb32RemoteVideoFrameCallback(pair.pc2(),
+                                                          CB(slow_cb));
+
+  // Delivered synchronously, the slow consumer throttles the decoder thread to
+  // one frame per callback duration.
+  const uint64_t sync_count = measure_received_frames();
+  ASSERT_GE((uint64_t)(kMeasureDuration / kSlowCallbackDuration) + 2,
+            sync_count);
+
+  // Repeatedly register and unregister another callback while the slow one is
+  // running. Registration only waits for in-flight invocations of the callback
+  // it replaces, so its latency should not depend on the slow consumer.
+  I420AVideoFrameCallback fast_cb = [](const mrsI420AVideoFrame& /*frame*/) {};
+  std::chrono::steady_clock::duration max_latency{};
+  const auto start_time = std::chrono::steady_clock::now();
+  while (std::chrono::steady_clock::now() - start_time < 2s) {
+    auto t0 = std::chrono::steady_clock::now();
+    mrsPeerConnectionRegisterI420ARemoteVideoFrameCallback(pair.pc2(),
+                                                           CB(fast_cb));
+    auto t1 = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(10ms);
+    mrsPeerConnectionRegisterI420ARemoteVideoFrameCallback(pair.pc2(), nullptr,
+                                                           nullptr);
+    auto t2 = std::chrono::steady_clock::now();
+    max_latency = std::max(max_latency, std::max(t1 - t0, t2 - t1 - 10ms));
+  }
+  ASSERT_LT(max_latency, kSlowCallbackDuration / 2);
+
+  // Delivered asynchronously, the decoder thread keeps its pace whatever the
+  // latency of the consumer, and the frames the consumer cannot keep up with
+  // are dropped from the delivery queue.
+  mrsVideoFrameDeliveryConfig config{};
+  config.async = mrsBool::kTrue;
+  config.queue_capacity = 2;
+  config.drop_policy = mrsVideoFrameDropPolicy::kKeepLatest;
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsPeerConnectionSetRemoteVideoFrameDeliveryConfig(pair.pc2(),
+                                                               &config));
+  const uint64_t async_count = measure_received_frames();
+  RecordProperty("measure_duration_ms",
+                 (int)std::chrono::milliseconds(kMeasureDuration).count());
+  RecordProperty("fast_frame_count", (int)baseline_count);
+  RecordProperty("slow_sync_frame_count", (int)sync_count);
+  RecordProperty("slow_async_frame_count", (int)async_count);
+  ASSERT_LE(baseline_count * 8 / 10, async_count);
+
+  // Unregistering the slow callback waits for its in-flight invocation, but
+  // no more than that.
+  const auto t0 = std::chrono::steady_clock::now();
+  mrsPeerConnectionRegisterArgb32RemoteVideoFrameCallback(pair.pc2(), nullptr,
+                                                          nullptr);
+  ASSERT_LE(std::chrono::steady_clock::now() - t0,
+            kSlowCallbackDuration + 50ms);
+  const uint32_t final_slow_frame_count = slow_frame_count.load();
+  std::this_thread::sleep_for(kSlowCallbackDuration * 2);
+  ASSERT_EQ(final_slow_frame_count, slow_frame_count.load());
+
+  config.async = mrsBool::kFalse;
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsPeerConnectionSetRemoteVideoFrameDeliveryConfig(pair.pc2(),
+                                                               &config));
+}
+
+TEST(VideoTrack, AsyncFrameDelivery) {
+  LocalPeerPairRaii pair;
+  QuadVideoTrackRaii track(pair.pc1());
+
+  // Invalid configurations
+  mrsVideoFrameDeliveryConfig config{};
+  ASSERT_EQ(mrsResult::kInvalidNativeHandle,
+            mrsPeerConnectionSetRemoteVideoFrameDeliveryConfig(nullptr,
+                                                               &config));
+  ASSERT_EQ(mrsResult::kInvalidParameter,
+            mrsPeerConnectionSetRemoteVideoFrameDeliveryConfig(pair.pc2(),
+                                                               nullptr));
+  config.async = mrsBool::kTrue;
+  config.queue_capacity = 0;
+  ASSERT_EQ(mrsResult::kInvalidParameter,
+            mrsPeerConnectionSetRemoteVideoFrameDeliveryConfig(pair.pc2(),
+                                                               &config));
+
+  // Deliver asynchronously, keeping only the latest frame
+  config.queue_capacity = 2;
+  config.drop_policy = mrsVideoFrameDropPolicy::kKeepLatest;
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsPeerConnectionSetRemoteVideoFrameDeliveryConfig(pair.pc2(),
+                                                               &config));
+
+  // Slow consumer, processing less frames than produced
+  std::atomic_uint32_t frame_count{0};
+  Argb32VideoFrameCallback argb_cb = [&](const mrsArgb32VideoFrame& frame) {
+    ValidateQuadTestFrame(frame.argb32_data_, frame.stride_, frame.width_,
+                          frame.height_);
+    std::this_thread::sleep_for(100ms);
+    ++frame_count;
+  };
+  mrsPeerConnectionRegisterArgb32RemoteVideoFrameCallback(pair.pc2(),
+                                                          CB(argb_cb));
+
+  pair.ConnectAndWait();
+
+  // Simple timer
+  Event ev;
+  ev.WaitFor(5s);
+
+  // Disabling asynchronous delivery waits for the delivery thread to stop, so
+  // frame_count is final after this.
+  config.async = mrsBool::kFalse;
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsPeerConnectionSetRemoteVideoFrameDeliveryConfig(pair.pc2(),
+                                                               &config));
+  mrsPeerConnectionRegisterArgb32RemoteVideoFrameCallback(pair.pc2(), nullptr,
+                                                          nullptr);
+
+  mrsVideoFrameDeliveryStats stats{};
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsPeerConnectionGetRemoteVideoFrameDeliveryStats(pair.pc2(),
+                                                              &stats));
+  ASSERT_LT(10u, frame_count.load());
+  ASSERT_EQ(frame_count.load(), stats.delivered_count);
+  ASSERT_LT(0u, stats.dropped_count);  // producer is faster than consumer
+  ASSERT_EQ(0, stats.queue_size);
+  ASSERT_LE(stats.latency_p50_us, stats.latency_p90_us);
+  ASSERT_LE(stats.latency_p90_us, stats.latency_p99_us);
+  ASSERT_GT(200000, stats.latency_p50_us);  // about one callback duration
+}
+
+TEST(VideoTrack, SharedFrameHandle) {
+  LocalPeerPairRaii pair;
+  QuadVideoTrackRaii track(pair.pc1());
+
+  // The ARGB32 callback is invoked before the frame handle callback, on the
+  // same thread, with the same frame.
+  const void* last_argb_data = nullptr;
+  Argb32VideoFrameCallback argb_cb = [&](const mrsArgb32VideoFrame& frame) {
+    last_argb_data = frame.argb32_data_;
+  };
+  mrsPeerConnectionRegisterArgb32RemoteVideoFrameCallback(pair.pc2(),
+                                                          CB(argb_cb));
+
+  uint32_t frame_count = 0;
+  mrsVideoFrameHandle kept_handle = nullptr;
+  VideoFrameHandleCallback handle_cb = [&](mrsVideoFrameHandle handle) {
+    ASSERT_NE(nullptr, handle);
+
+    // The conversion done for the ARGB32 callback is shared.
+    mrsArgb32VideoFrame argb_frame{};
+    ASSERT_EQ(mrsResult::kSuccess,
+              mrsVideoFrameHandleGetArgb32(handle, &argb_frame));
+    ASSERT_EQ(last_argb_data, argb_frame.argb32_data_);
+    ValidateQuadTestFrame(argb_frame.argb32_data_, argb_frame.stride_,
+                          argb_frame.width_, argb_frame.height_);
+
+    // Other encodings are converted on first access only.
+    mrsNv12VideoFrame nv12_frame{};
+    ASSERT_EQ(mrsResult::kSuccess,
+              mrsVideoFrameHandleGetNv12(handle, &nv12_frame));
+    ASSERT_NE(nullptr, nv12_frame.ydata_);
+    ASSERT_NE(nullptr, nv12_frame.uvdata_);
+    ASSERT_EQ(argb_frame.width_, nv12_frame.width_);
+    ASSERT_EQ(argb_frame.height_, nv12_frame.height_);
+    ASSERT_LE((int32_t)nv12_frame.width_, nv12_frame.ystride_);
+    mrsNv12VideoFrame nv12_frame2{};
+    ASSERT_EQ(mrsResult::kSuccess,
+              mrsVideoFrameHandleGetNv12(handle, &nv12_frame2));
+    ASSERT_EQ(nv12_frame.ydata_, nv12_frame2.ydata_);
+    ASSERT_EQ(nv12_frame.uvdata_, nv12_frame2.uvdata_);
+
+    // Keep the first frame alive past the callback
+    if (!kept_handle) {
+      mrsVideoFrameHandleAddRef(handle);
+      kept_handle = handle;
+    }
+    ++frame_count;
+  };
+  mrsPeerConnectionRegisterRemoteVideoFrameHandleCallback(pair.pc2(),
+                                                          CB(handle_cb));
+
+  pair.ConnectAndWait();
+
+  // Simple timer
+  Event ev;
+  ev.WaitFor(5s);
+
+  mrsPeerConnectionRegisterRemoteVideoFrameHandleCallback(pair.pc2(), nullptr,
+                                                          nullptr);
+  mrsPeerConnectionRegisterArgb32RemoteVideoFrameCallback(pair.pc2(), nullptr,
+                                                          nullptr);
+  ASSERT_LT(50u, frame_count);  // at least 10 FPS
+
+  // The frame kept alive is still accessible after its delivery
+  ASSERT_NE(nullptr, kept_handle);
+  mrsArgb32VideoFrame argb_frame{};
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsVideoFrameHandleGetArgb32(kept_handle, &argb_frame));
+  ValidateQuadTestFrame(argb_frame.argb32_data_, argb_frame.stride_,
+                        argb_frame.width_, argb_frame.height_);
+  mrsI420AVideoFrame i420a_frame{};
+  ASSERT_EQ(mrsResult::kSuccess,
+            mrsVideoFrameHandleGetI420A(kept_handle, &i420a_frame));
+  ASSERT_EQ(argb_frame.width_, i420a_frame.width_);
+  ASSERT_EQ(nullptr, i420a_frame.adata_);
+  mrsVideoFrameHandleRemoveRef(kept_handle);
+
+  ASSERT_EQ(mrsResult::kInvalidNativeHandle,
+            mrsVideoFrameHandleGetArgb32(nullptr, &argb_frame));
+}
+
+TEST(VideoTrack, NativeLayoutCallbacks) {
+  LocalPeerPairRaii pair;
+  QuadVideoTrackRaii track(pair.pc1());
+
+  // All callbacks are invoked in turn on the same thread, for the same frame.
+  const void* last_argb_data = nullptr;
+  uint32_t argb_count = 0;
+  Argb32VideoFrameCallback argb_cb = [&](const mrsArgb32VideoFrame& frame) {
+    last_argb_data = frame.argb32_data_;
+    ++argb_count;
+  };
+  mrsPeerConnectionRegisterArgb32RemoteVideoFrameCallback(pair.pc2(),
+                                                          CB(argb_cb));
+
+  uint32_t nv12_count = 0;
+  Nv12VideoFrameCallback nv12_cb = [&](const mrsNv12VideoFrame& frame) {
+    uint32_t argb[256];
+    libyuv::NV12ToARGB((const uint8_t*)frame.ydata_, frame.ystride_,
+                       (const uint8_t*)frame.uvdata_, frame.uvstride_,
+                       (uint8_t*)argb, 16 * 4, frame.width_, frame.height_);
+    ValidateQuadTestFrame(argb, 16 * 4, frame.width_, frame.height_);
+    ++nv12_count;
+  };
+  mrsPeerConnectionRegisterNv12RemoteVideoFrameCallback(pair.pc2(),
+                                                        CB(nv12_cb));
+
+  uint32_t rgba_count = 0;
+  Rgba32VideoFrameCallback rgba_cb = [&](const mrsRgba32VideoFrame& frame) {
+    // Swap R and B to compare with the ARGB32 reference
+    uint32_t argb[256];
+    ASSERT_EQ(16u, frame.width_);
+    ASSERT_EQ(16u, frame.height_);
+    libyuv::ARGBToABGR((const uint8_t*)frame.rgba32_data_, frame.stride_,
+                       (uint8_t*)argb, 16 * 4, 16, 16);
+    ValidateQuadTestFrame(argb, 16 * 4, frame.width_, frame.height_);
+    ++rgba_count;
+  };
+  mrsPeerConnectionRegisterRgba32RemoteVideoFrameCallback(
+      pair.pc2(), mrsBool::kFalse, CB(rgba_cb));
+
+  // The test frame is opaque, so premultiplied alpha leaves it unchanged, and
+  // BGRA32 shares the ARGB32 buffer.
+  uint32_t bgra_count = 0;
+  Bgra32VideoFrameCallback bgra_cb = [&](const mrsBgra32VideoFrame& frame) {
+    ASSERT_EQ(last_argb_data, frame.bgra32_data_);
+    ValidateQuadTestFrame(frame.bgra32_data_, frame.stride_, frame.width_,
+                          frame.height_);
+    ++bgra_count;
+  };
+  mrsPeerConnectionRegisterBgra32RemoteVideoFrameCallback(
+      pair.pc2(), mrsBool::kTrue, CB(bgra_cb));
+
+  pair.ConnectAndWait();
+
+  // Simple timer
+  Event ev;
+  ev.WaitFor(5s);
+
+  mrsPeerConnectionRegisterBgra32RemoteVideoFrameCallback(
+      pair.pc2(), mrsBool::kFalse, nullptr, nullptr);
+  mrsPeerConnectionRegisterRgba32RemoteVideoFrameCallback(
+      pair.pc2(), mrsBool::kFalse, nullptr, nullptr);
+  mrsPeerConnectionRegisterNv12RemoteVideoFrameCallback(pair.pc2(), nullptr,
+                                                        nullptr);
+  mrsPeerConnectionRegisterArgb32RemoteVideoFrameCallback(pair.pc2(), nullptr,
+                                                          nullptr);
+  ASSERT_LT(50u, argb_count);  // at least 10 FPS
+  ASSERT_LT(50u, nv12_count);
+  ASSERT_LT(50u, rgba_count);
+  ASSERT_LT(50u, bgra_count);
+}
+
+TEST(VideoTrack, PerTrackFrameDelivery) {
+  LocalPeerPairRaii pair;
+
+  // Two remote video tracks, each with its own observer
+  constexpr int kTrackCount = 2;
+  const char* const kTrackNames[kTrackCount] = {"track_a", "track_b"};
+  QuadVideoTrackRaii tracks[kTrackCount]{{pair.pc1(), kTrackNames[0]},
+                                         {pair.pc1(), kTrackNames[1]}};
+
+  // Invalid registrations
+  RemoteVideoTrackFrameCallback track_cbs[kTrackCount];
+  ASSERT_EQ(mrsResult::kInvalidNativeHandle,
+            mrsPeerConnectionRegisterRemoteVideoTrackFrameCallback(
+                nullptr, kTrackNames[0], CB(track_cbs[0])));
+  ASSERT_EQ(mrsResult::kInvalidParameter,
+            mrsPeerConnectionRegisterRemoteVideoTrackFrameCallback(
+                pair.pc2(), nullptr, CB(track_cbs[0])));
+  mrsVideoFrameDeliveryStats stats{};
+  ASSERT_EQ(mrsResult::kInvalidParameter,
+            mrsPeerConnectionGetRemoteVideoTrackFrameDeliveryStats(
+                pair.pc2(), kTrackNames[0], &stats));
+
+  // Register before the tracks are added. Each track has a slow consumer
+  // processing at most 10 frames per second on its own delivery thread, so
+  // both tracks are processed concurrently.
+  mrsVideoFrameDeliveryConfig config{};
+  config.async = mrsBool::kTrue;
+  config.queue_capacity = 2;
+  config.drop_policy = mrsVideoFrameDropPolicy::kKeepLatest;
+  std::atomic_uint32_t frame_counts[kTrackCount]{};
+  std::atomic_uint32_t mismatch_count{0};
+  for (int i = 0; i < kTrackCount; ++i) {
+    track_cbs[i] = [&, i](const char* track_id, mrsVideoFrameHandle frame) {
+      if ((frame == nullptr) || (strcmp(track_id, kTrackNames[i]) != 0)) {
+        ++mismatch_count;
+      }
+      std::this_thread::sleep_for(100ms);
+      ++frame_counts[i];
+    };
+    ASSERT_EQ(mrsResult::kSuccess,
+              mrsPeerConnectionSetRemoteVideoTrackFrameDeliveryConfig(
+                  pair.pc2(), kTrackNames[i], &config));
+    ASSERT_EQ(mrsResult::kSuccess,
+              mrsPeerConnectionRegisterRemoteVideoTrackFrameCallback(
+                  pair.pc2(), kTrackNames[i], CB(track_cbs[i])));
+  }
+
+  pair.ConnectAndWait();
+
+  // Simple timer
+  Event ev;
+  ev.WaitFor(5s);
+
+  // Disabling asynchronous delivery waits for the delivery threads to stop, so
+  // the frame counts are final after this.
+  config.async = mrsBool::kFalse;
+  for (int i = 0; i < kTrackCount; ++i) {
+    ASSERT_EQ(mrsResult::kSuccess,
+              mrsPeerConnectionSetRemoteVideoTrackFrameDeliveryConfig(
+                  pair.pc2(), kTrackNames[i], &config));
+    ASSERT_EQ(mrsResult::kSuccess,
+              mrsPeerConnectionRegisterRemoteVideoTrackFrameCallback(
+                  pair.pc2(), kTrackNames[i], nullptr, nullptr));
+  }
+
+  ASSERT_EQ(0u, mismatch_count.load());
+  for (int i = 0; i < kTrackCount; ++i) {
+    // A single shared delivery thread would deliver about 25 frames per track
+    ASSERT_LT(30u, frame_counts[i].load());
+    ASSERT_EQ(mrsResult::kSuccess,
+              mrsPeerConnectionGetRemoteVideoTrackFrameDeliveryStats(
+                  pair.pc2(), kTrackNames[i], &stats));
+    ASSERT_EQ(frame_counts[i].load(), stats.delivered_count);
+  }
+}
+
 #endif  // MRSW_EXCLUDE_DEVICE_TESTS